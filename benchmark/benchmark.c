@@ -1,24 +1,36 @@
 #include "benchmark.h"
 
 #include "../configs/bech-config.h"
+#include "../configs/config.h"
+#include "../interaction-graph/arena.h"
 #include "../structures-data/types.h"
 
+#include <malloc.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+// Nanoseconds passed, unlike clock() not summed over threads
+static double getWallTime(void) {
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return Now.tv_sec * 1e9 + Now.tv_nsec;
+}
+
 void benchmarkNodeInsert(FILE *OutFile) {
     const char *CSVHeader = "Node Number, Insert time ns";
     FILE *CSVOut = OutFile;
     fprintf(CSVOut, "%s\n", CSVHeader);
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription GraphAttributes[4] = {
+    struct ExternalAttributeDescription GraphAttributes[4] = {
             {.AttributeId = 0, .Name = "Node Name", .Type = STRING, .Next = GraphAttributes + 1},
             {.AttributeId = 1, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 2},
             {.AttributeId = 2, .Name = "Bool value", .Type = BOOL, .Next = GraphAttributes + 3},
             {.AttributeId = 3, .Name = "Float value", .Type = FLOAT, .Next = NULL}};
     struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
     createGraph(Controller, &CGR);
-    struct Attribute NodeAttributes[4] = {
+    struct ExternalAttribute NodeAttributes[4] = {
             {.Id = 0, .Type = STRING, .Value.StringAddr = "Some String"},
             {
                     .Id = 1,
@@ -48,20 +60,17 @@ void benchmarkSelectByAttributes(FILE *OutFile) {
     FILE *CSVOut = OutFile;
     fprintf(CSVOut, "%s\n", CSVHeader);
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription GraphAttributes[2] = {
+    struct ExternalAttributeDescription GraphAttributes[2] = {
             {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
             {.AttributeId = 1, .Name = "Divisible by 3", .Next = NULL, .Type = BOOL}};
     struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
     createGraph(Controller, &CGR);
-    struct AttributeInterface NodeAttributes[2] = {{
-                                                           .Id = 0,
-                                                           .Type = INT,
-                                                   },
-                                                   {.Id = 1, .Type = BOOL}};
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT},
+                                                  {.Id = 1, .Type = BOOL}};
     struct CreateNodeRequest CNR = {
             .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
     struct AttributeFilter DivByThreeFilter = {
-            .AttributeId = 1, .Type = BOOL_FILTER, .Data = true, .Next = NULL};
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
     struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
             .GraphId.GraphName = "G",
             .ById = false,
@@ -76,7 +85,7 @@ void benchmarkSelectByAttributes(FILE *OutFile) {
         struct NodeResultSet *NRS = readNode(Controller, &RNR);
         size_t ResultSetSize = nodeResultSetGetSize(NRS);
         while (hasNextNode(NRS)) {
-            struct NodeInterface *Node;
+            struct ExternalNode *Node;
             readResultNode(NRS, &Node);
             moveToNextNode(NRS);
             deleteExternalNode(&Node);
@@ -96,20 +105,17 @@ void benchmarkDeleteElements(FILE *OutFile) {
     const char *CSVHeader = "Total Node Number,Deleted Node Number,Delete Time ns";
     fprintf(CSVOut, "%s\n", CSVHeader);
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription GraphAttributes[2] = {
+    struct ExternalAttributeDescription GraphAttributes[2] = {
             {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
             {.AttributeId = 1, .Name = "To be Deleted", .Next = NULL, .Type = BOOL}};
     struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
     createGraph(Controller, &CGR);
-    struct AttributeInterface NodeAttributes[2] = {{
-                                                           .Id = 0,
-                                                           .Type = INT,
-                                                   },
-                                                   {.Id = 1, .Type = BOOL}};
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT},
+                                                  {.Id = 1, .Type = BOOL}};
     struct CreateNodeRequest CNR = {
             .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
     struct AttributeFilter DivByThreeFilter = {
-            .AttributeId = 1, .Type = BOOL_FILTER, .Data = true, .Next = NULL};
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
     struct DeleteNodeRequest DNR = {.GraphIdType = GRAPH_NAME,
             .GraphId.GraphName = "G",
             .ById = false,
@@ -137,27 +143,17 @@ void benchmarkUpdateProgressingElements(FILE *OutFile) {
     const char *CSVHeader = "Total Node Number,Updated Node Number,Delete Time ns";
     fprintf(CSVOut, "%s\n", CSVHeader);
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription GraphAttributes[3] = {
+    struct ExternalAttributeDescription GraphAttributes[3] = {
             {.AttributeId = 0, .Name = "Id", .Type = INT, .Next = GraphAttributes + 1},
             {.AttributeId = 1, .Name = "Reminder of id to 7", .Next = GraphAttributes + 2, .Type = INT},
             {.AttributeId = 2, .Name = "Updated", .Next = NULL, .Type = BOOL}
     };
     struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
     createGraph(Controller, &CGR);
-    struct AttributeInterface NodeAttributes[3] = {{
-                                                           .Id = 0,
-                                                           .Type = INT,
-                                                   },
-                                                   {
-                                                           .Id = 1,
-                                                           .Type = INT
-                                                   },
-                                                   {
-                                                           .Id = 2,
-                                                           .Type = BOOL,
-                                                           .Value.BoolValue = false
-                                                   }
-    };
+    struct ExternalAttribute NodeAttributes[3] = {
+            {.Id = 0, .Type = INT},
+            {.Id = 1, .Type = INT},
+            {.Id = 2, .Type = BOOL, .Value.BoolValue = false}};
     struct CreateNodeRequest CNR = {
             .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
     struct AttributeFilter UpdFilter = {
@@ -171,7 +167,7 @@ void benchmarkUpdateProgressingElements(FILE *OutFile) {
                     .Min = 1
             }
     };
-    struct AttributeInterface UpdatedAttributes[2] = {
+    struct ExternalAttribute UpdatedAttributes[2] = {
             {
                     .Id = 1,
                     .Type = INT,
@@ -213,8 +209,11 @@ void benchmarkFileSize(FILE *OutFile) {
     FILE *CSVOut = OutFile;
     const char *CSVHeader = "Operation Number,Node Size,File Size";
     fprintf(OutFile, "%s\n", CSVHeader);
+    const int FirstInsertNumber = 10000000;
+    const int SecondInsertNumber = FirstInsertNumber / 2 * 3;
+    const int ReportStep = 100000;
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription AttrDesc = {
+    struct ExternalAttributeDescription AttrDesc = {
             .AttributeId = 0,
             .Name = "Ordinal",
             .Next = NULL,
@@ -225,7 +224,7 @@ void benchmarkFileSize(FILE *OutFile) {
             .Name = "G"
     };
     createGraph(Controller, &CGR);
-    struct AttributeInterface NodeAttribute = {
+    struct ExternalAttribute NodeAttribute = {
             .Id = 0,
             .Type = INT
     };
@@ -243,45 +242,50 @@ void benchmarkFileSize(FILE *OutFile) {
     int OpNum = 0;
     size_t NodeNum = 0;
     struct NodeResultSet *NRS;
-    for (int i = 0; i < 100000; ++i) {
+    for (int i = 0; i < FirstInsertNumber; ++i) {
         CNR.Attributes->Value.IntValue = i + 1;
         createNode(Controller, &CNR);
         NodeNum++;
         OpNum++;
-        fprintf(CSVOut, "%d,%zu,%zu\n", OpNum, NodeNum * (sizeof(struct Node) + sizeof(struct Attribute)),
-                getFileSize(Controller->Allocator));
+        if (OpNum % ReportStep == 0) {
+            fprintf(CSVOut, "%d,%zu,%zu\n", OpNum, NodeNum * (sizeof(struct Node) + sizeof(struct Attribute)),
+                    getFileSize(Controller->Allocator));
+        }
     }
-    struct AttributeFilter After10k = {
+    struct AttributeFilter AfterFifth = {
             .AttributeId = 0,
             .Type = INT_FILTER,
             .Next = NULL,
             .Data.Int = {
                     .HasMax = false,
                     .HasMin = true,
-                    .Min = 20000
+                    .Min = FirstInsertNumber / 5
             }
     };
     struct DeleteNodeRequest DNR = {
             .GraphIdType = GRAPH_NAME,
             .GraphId.GraphName = "G",
             .ById = false,
-            .AttributesFilterChain = &After10k
+            .AttributesFilterChain = &AfterFifth
     };
     NodeNum -= deleteNode(Controller, &DNR);
     fprintf(CSVOut, "%d,%zu,%zu\n", OpNum, NodeNum * (sizeof(struct Node) + sizeof(struct Attribute)),
             getFileSize(Controller->Allocator));
-    for (int i = 0; i < 150000; ++i) {
-        CNR.Attributes->Value.IntValue = 10000 + i + 1;
+    for (int i = 0; i < SecondInsertNumber; ++i) {
+        CNR.Attributes->Value.IntValue = FirstInsertNumber / 10 + i + 1;
         createNode(Controller, &CNR);
         NodeNum++;
         OpNum++;
-        fprintf(CSVOut, "%d,%zu,%zu\n", OpNum, NodeNum * (sizeof(struct Node) + sizeof(struct Attribute)),
-                getFileSize(Controller->Allocator));
+        if (OpNum % ReportStep == 0) {
+            fprintf(CSVOut, "%d,%zu,%zu\n", OpNum, NodeNum * (sizeof(struct Node) + sizeof(struct Attribute)),
+                    getFileSize(Controller->Allocator));
+        }
     }
     NRS = readNode(Controller, &ReadAll);
     if (nodeResultSetGetSize(NRS) == NodeNum) {
         fprintf(stderr, "File Size benchmark verified\n");
     }
+    deleteNodeResultSet(&NRS);
     struct DeleteGraphRequest DGR = {.Name = "G"};
     deleteGraph(Controller, &DGR);
     endWork(Controller);
@@ -293,20 +297,17 @@ void benchmarkDop(FILE *OutFile) {
     FILE *CSVOut = OutFile;
     fprintf(CSVOut, "%s\n", CSVHeader);
     struct StorageController *Controller = beginWork("bench.bin");
-    struct AttributeDescription GraphAttributes[2] = {
+    struct ExternalAttributeDescription GraphAttributes[2] = {
             {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
             {.AttributeId = 1, .Name = "To be Deleted", .Next = NULL, .Type = BOOL}};
     struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
     createGraph(Controller, &CGR);
-    struct AttributeInterface NodeAttributes[2] = {{
-                                                           .Id = 0,
-                                                           .Type = INT,
-                                                   },
-                                                   {.Id = 1, .Type = BOOL}};
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT},
+                                                  {.Id = 1, .Type = BOOL}};
     struct CreateNodeRequest CNR = {
             .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
     struct AttributeFilter DivByThreeFilter = {
-            .AttributeId = 1, .Type = BOOL_FILTER, .Data = true, .Next = NULL};
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
     struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
             .GraphId.GraphName = "G",
             .ById = false,
@@ -330,7 +331,7 @@ void benchmarkDop(FILE *OutFile) {
         struct NodeResultSet *NRS = readNode(Controller, &RNR);
         size_t ResultSetSize = nodeResultSetGetSize(NRS);
         while (hasNextNode(NRS)) {
-            struct NodeInterface *Node;
+            struct ExternalNode *Node;
             readResultNode(NRS, &Node);
             moveToNextNode(NRS);
             deleteExternalNode(&Node);
@@ -343,11 +344,1159 @@ void benchmarkDop(FILE *OutFile) {
         clock_t BeginD = clock();
         size_t DeletedNodeNumber = deleteNode(Controller, &DNR);
         clock_t EndD = clock();
-        double TimeDiffD = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        double TimeDiffD = ((double) (EndD - BeginD) * 10e9) / CLOCKS_PER_SEC;
         fprintf(CSVOut, "%d,%zu,%lf\n", (i + 1) * 100, DeletedNodeNumber, TimeDiffD);
     }
 
     struct DeleteGraphRequest DGR = {.Name = "G"};
     deleteGraph(Controller, &DGR);
     endWork(Controller);
-}
\ No newline at end of file
+}
+void benchmarkAllocator(FILE *OutFile) {
+    const char *CSVHeader = "Allocated Blocks,File Size,Allocate time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    remove("alloc-bench.bin");
+    struct FileAllocator *Allocator = initFileAllocator("alloc-bench.bin");
+    const size_t BlockSizes[4] = {40, 200, 1000, 5000};
+    const size_t BatchSize = 10000;
+    struct AddrInfo *Batch = malloc(sizeof(struct AddrInfo) * BatchSize);
+    size_t AllocatedBlocks = 0;
+    for (int i = 0; i < 30; ++i) {
+        clock_t Begin = clock();
+        for (size_t j = 0; j < BatchSize; ++j) {
+            Batch[j] = allocate(Allocator, BlockSizes[j % 4]);
+        }
+        clock_t End = clock();
+        for (size_t j = 0; j < BatchSize; j += 3) {
+            deallocate(Allocator, Batch[j]);
+        }
+        AllocatedBlocks += BatchSize - (BatchSize + 2) / 3;
+        double TimeDiff = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        fprintf(CSVOut, "%zu,%zu,%lf\n", AllocatedBlocks, getFileSize(Allocator), TimeDiff);
+    }
+    free(Batch);
+    shutdownFileAllocator(Allocator);
+}
+
+void benchmarkNodeLookupById(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Lookup Number,Lookup time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G", .ById = true};
+    const int LookupNumber = 10000;
+    size_t FirstId = 0;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 10000 + j;
+            size_t Id = createNode(Controller, &CNR);
+            if (i == 0 && j == 0) {
+                FirstId = Id;
+            }
+        }
+        const size_t NodeNumber = (size_t) (i + 1) * 10000;
+        clock_t Begin = clock();
+        for (int j = 0; j < LookupNumber; ++j) {
+            RNR.Id = FirstId + (size_t) j * 7919 % NodeNumber;
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            struct ExternalNode *Node;
+            readResultNode(NRS, &Node);
+            deleteExternalNode(&Node);
+            deleteNodeResultSet(&NRS);
+        }
+        clock_t End = clock();
+        double TimeDiff = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        fprintf(CSVOut, "%zu,%d,%lf\n", NodeNumber, LookupNumber, TimeDiff);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "G"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkLinkLookupByNode(FILE *OutFile) {
+    const char *CSVHeader = "Total Link Number,Lookup Number,Lookup time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    const int NodeNumber = 10000;
+    size_t FirstId = 0;
+    for (int i = 0; i < NodeNumber; ++i) {
+        NodeAttributes[0].Value.IntValue = i;
+        size_t Id = createNode(Controller, &CNR);
+        if (i == 0) {
+            FirstId = Id;
+        }
+    }
+    struct CreateNodeLinkRequest CLR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G", .Type = DIRECTIONAL, .Weight = 1.0f};
+    struct ReadNodeLinkRequest RLR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G", .Type = BY_LEFT_NODE_ID};
+    const int LookupNumber = 1000;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            CLR.LeftNodeId = FirstId + (size_t) j;
+            CLR.RightNodeId = FirstId + (size_t) (j + i + 1) % NodeNumber;
+            createNodeLink(Controller, &CLR);
+        }
+        const size_t LinkNumber = (size_t) (i + 1) * 10000;
+        clock_t Begin = clock();
+        for (int j = 0; j < LookupNumber; ++j) {
+            RLR.Id = FirstId + (size_t) j * 7919 % NodeNumber;
+            struct NodeLinkResultSet *NLRS = readNodeLink(Controller, &RLR);
+            deleteNodeLinkResultSet(&NLRS);
+        }
+        clock_t End = clock();
+        double TimeDiff = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        fprintf(CSVOut, "%zu,%d,%lf\n", LinkNumber, LookupNumber, TimeDiff);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "G"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkIndexedRangeSelect(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Selected Node Number,Scan time ns,Index time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    char *GraphNames[2] = {"Scanned", "Indexed"};
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = NULL}};
+    for (int g = 0; g < 2; ++g) {
+        struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes,
+                                         .Name = GraphNames[g]};
+        createGraph(Controller, &CGR);
+    }
+    struct CreateIndexRequest CIR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Indexed", .AttributeId = 0};
+    createIndex(Controller, &CIR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct AttributeFilter RangeFilter = {
+            .AttributeId = 0, .Type = INT_FILTER, .Data.Int = {.HasMin = true, .HasMax = true}};
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            NodeAttributes[0].Value.IntValue = (i * 10000 + j) * 7919 % 100000;
+            for (int g = 0; g < 2; ++g) {
+                struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                                .GraphIdType = GRAPH_NAME,
+                                                .GraphId.GraphName = GraphNames[g]};
+                createNode(Controller, &CNR);
+            }
+        }
+        RangeFilter.Data.Int.Min = i * 5000;
+        RangeFilter.Data.Int.Max = i * 5000 + 999;
+        double TimeDiff[2];
+        size_t ResultSetSize = 0;
+        for (int g = 0; g < 2; ++g) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = GraphNames[g],
+                                          .AttributesFilterChain = &RangeFilter};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            ResultSetSize = nodeResultSetGetSize(NRS);
+            clock_t End = clock();
+            deleteNodeResultSet(&NRS);
+            TimeDiff[g] = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        }
+        fprintf(CSVOut, "%d,%zu,%lf,%lf\n", (i + 1) * 10000, ResultSetSize, TimeDiff[0],
+                TimeDiff[1]);
+    }
+    for (int g = 0; g < 2; ++g) {
+        struct DeleteGraphRequest DGR = {.Name = GraphNames[g]};
+        deleteGraph(Controller, &DGR);
+    }
+    endWork(Controller);
+}
+
+void benchmarkStringEqualSelect(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Selected Node Number,Scan time ns,Index time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    char *GraphNames[2] = {"Scanned", "Indexed"};
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Name", .Type = STRING, .Next = NULL}};
+    for (int g = 0; g < 2; ++g) {
+        struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes,
+                                         .Name = GraphNames[g]};
+        createGraph(Controller, &CGR);
+    }
+    struct CreateIndexRequest CIR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Indexed", .AttributeId = 0};
+    createIndex(Controller, &CIR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = STRING}};
+    char Name[64];
+    struct AttributeFilter NameFilter = {
+            .AttributeId = 0, .Type = STRING_FILTER, .Data.String.Type = STRING_EQUAL};
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            snprintf(Name, sizeof(Name), "Name number %d", (i * 10000 + j) % 1000);
+            NodeAttributes[0].Value.StringAddr = Name;
+            for (int g = 0; g < 2; ++g) {
+                struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                                .GraphIdType = GRAPH_NAME,
+                                                .GraphId.GraphName = GraphNames[g]};
+                createNode(Controller, &CNR);
+            }
+        }
+        snprintf(Name, sizeof(Name), "Name number %d", i * 100);
+        NameFilter.Data.String.Data.StringEqual = Name;
+        double TimeDiff[2];
+        size_t ResultSetSize = 0;
+        for (int g = 0; g < 2; ++g) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = GraphNames[g],
+                                          .AttributesFilterChain = &NameFilter};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            ResultSetSize = nodeResultSetGetSize(NRS);
+            clock_t End = clock();
+            deleteNodeResultSet(&NRS);
+            TimeDiff[g] = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        }
+        fprintf(CSVOut, "%d,%zu,%lf,%lf\n", (i + 1) * 10000, ResultSetSize, TimeDiff[0],
+                TimeDiff[1]);
+    }
+    for (int g = 0; g < 2; ++g) {
+        struct DeleteGraphRequest DGR = {.Name = GraphNames[g]};
+        deleteGraph(Controller, &DGR);
+    }
+    endWork(Controller);
+}
+
+void benchmarkBoolBitmapSelect(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Selected Node Number,Scan time ns,Index time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    char *GraphNames[2] = {"Scanned", "Indexed"};
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Divisible by 3", .Type = BOOL, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Divisible by 5", .Type = BOOL, .Next = NULL}};
+    for (int g = 0; g < 2; ++g) {
+        struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes,
+                                         .Name = GraphNames[g]};
+        createGraph(Controller, &CGR);
+    }
+    for (size_t a = 0; a < 2; ++a) {
+        struct CreateIndexRequest CIR = {
+                .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Indexed", .AttributeId = a};
+        createIndex(Controller, &CIR);
+    }
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = BOOL}, {.Id = 1, .Type = BOOL}};
+    struct AttributeFilter DivByFiveFilter = {
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
+    struct AttributeFilter DivByThreeFilter = {.AttributeId = 0,
+                                               .Type = BOOL_FILTER,
+                                               .Data.Bool.Value = true,
+                                               .Next = &DivByFiveFilter};
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            NodeAttributes[0].Value.BoolValue = ((j % 3) == 0);
+            NodeAttributes[1].Value.BoolValue = ((j % 5) == 0);
+            for (int g = 0; g < 2; ++g) {
+                struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                                .GraphIdType = GRAPH_NAME,
+                                                .GraphId.GraphName = GraphNames[g]};
+                createNode(Controller, &CNR);
+            }
+        }
+        double TimeDiff[2];
+        size_t ResultSetSize = 0;
+        for (int g = 0; g < 2; ++g) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = GraphNames[g],
+                                          .AttributesFilterChain = &DivByThreeFilter};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            ResultSetSize = nodeResultSetGetSize(NRS);
+            clock_t End = clock();
+            deleteNodeResultSet(&NRS);
+            TimeDiff[g] = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        }
+        fprintf(CSVOut, "%d,%zu,%lf,%lf\n", (i + 1) * 10000, ResultSetSize, TimeDiff[0],
+                TimeDiff[1]);
+    }
+    for (int g = 0; g < 2; ++g) {
+        struct DeleteGraphRequest DGR = {.Name = GraphNames[g]};
+        deleteGraph(Controller, &DGR);
+    }
+    endWork(Controller);
+}
+
+void benchmarkZoneMapSkip(FILE *OutFile) {
+    const char *CSVHeader =
+            "Total Node Number,Selected Node Number,Shuffled scan time ns,Ordered scan time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Shuffled", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Ordered", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Zoned"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT}, {.Id = 1, .Type = INT}};
+    struct AttributeFilter RangeFilters[2] = {
+            {.AttributeId = 0, .Type = INT_FILTER, .Data.Int = {.HasMin = true, .HasMax = true}},
+            {.AttributeId = 1, .Type = INT_FILTER, .Data.Int = {.HasMin = true, .HasMax = true}}};
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            NodeAttributes[0].Value.IntValue = (i * 10000 + j) * 7919 % 100000;
+            NodeAttributes[1].Value.IntValue = i * 10000 + j;
+            struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                            .GraphIdType = GRAPH_NAME,
+                                            .GraphId.GraphName = "Zoned"};
+            createNode(Controller, &CNR);
+        }
+        double TimeDiff[2];
+        size_t ResultSetSize = 0;
+        for (int f = 0; f < 2; ++f) {
+            RangeFilters[f].Data.Int.Min = i * 5000;
+            RangeFilters[f].Data.Int.Max = i * 5000 + 999;
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Zoned",
+                                          .AttributesFilterChain = &RangeFilters[f]};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            ResultSetSize = nodeResultSetGetSize(NRS);
+            clock_t End = clock();
+            deleteNodeResultSet(&NRS);
+            TimeDiff[f] = ((double) (End - Begin) * 1e9) / CLOCKS_PER_SEC;
+        }
+        fprintf(CSVOut, "%d,%zu,%lf,%lf\n", (i + 1) * 10000, ResultSetSize, TimeDiff[0],
+                TimeDiff[1]);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Zoned"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkNodeBulkInsert(FILE *OutFile) {
+    const char *CSVHeader = "Batch size,Single insert time ns,Bulk insert time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[3] = {
+            {.AttributeId = 0, .Name = "Node Name", .Type = STRING, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Float value", .Type = FLOAT, .Next = NULL}};
+    struct CreateGraphRequest SingleCGR = {.AttributesDescription = GraphAttributes,
+                                           .Name = "Single"};
+    struct CreateGraphRequest BulkCGR = {.AttributesDescription = GraphAttributes, .Name = "Bulk"};
+    const size_t NodesNumber = 100000;
+    struct ExternalAttribute *NodeAttributes =
+            malloc(sizeof(struct ExternalAttribute) * 3 * NodesNumber);
+    for (size_t i = 0; i < NodesNumber; ++i) {
+        struct ExternalAttribute *Node = NodeAttributes + 3 * i;
+        Node[0] = (struct ExternalAttribute){
+                .Id = 0, .Type = STRING, .Value.StringAddr = "Some String"};
+        Node[1] = (struct ExternalAttribute){.Id = 1, .Type = INT, .Value.IntValue = (int32_t) i};
+        Node[2] = (struct ExternalAttribute){.Id = 2, .Type = FLOAT, .Value.FloatValue = 0.5f * i};
+    }
+    const size_t BatchSizes[] = {1, 10, 100, 1000, 10000};
+    for (size_t k = 0; k < sizeof(BatchSizes) / sizeof(BatchSizes[0]); ++k) {
+        createGraph(Controller, &SingleCGR);
+        createGraph(Controller, &BulkCGR);
+        struct CreateNodeRequest CNR = {.GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Single"};
+        clock_t Begin = clock();
+        for (size_t i = 0; i < NodesNumber; ++i) {
+            CNR.Attributes = NodeAttributes + 3 * i;
+            createNode(Controller, &CNR);
+        }
+        clock_t End = clock();
+        double SingleTimeDiff = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        struct CreateNodesBulkRequest CNBR = {.GraphIdType = GRAPH_NAME,
+                                              .GraphId.GraphName = "Bulk"};
+        Begin = clock();
+        for (size_t i = 0; i < NodesNumber; i += BatchSizes[k]) {
+            CNBR.Attributes = NodeAttributes + 3 * i;
+            CNBR.NodesNumber = BatchSizes[k];
+            createNodesBulk(Controller, &CNBR);
+        }
+        End = clock();
+        double BulkTimeDiff = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        fprintf(CSVOut, "%zu, %lf, %lf\n", BatchSizes[k], SingleTimeDiff, BulkTimeDiff);
+        struct DeleteGraphRequest DGR = {.Name = "Single"};
+        deleteGraph(Controller, &DGR);
+        DGR.Name = "Bulk";
+        deleteGraph(Controller, &DGR);
+    }
+    free(NodeAttributes);
+    endWork(Controller);
+}
+
+void benchmarkNodeLinkBulkInsert(FILE *OutFile) {
+    const char *CSVHeader = "Batch size,Single insert time ns,Bulk insert time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest SingleCGR = {.AttributesDescription = GraphAttributes,
+                                           .Name = "Single"};
+    struct CreateGraphRequest BulkCGR = {.AttributesDescription = GraphAttributes, .Name = "Bulk"};
+    const size_t NodesNumber = 1000;
+    const size_t LinksNumber = 100000;
+    struct ExternalAttribute NodeAttribute = {.Id = 0, .Type = INT};
+    struct ExternalNodeLink *Links = malloc(sizeof(struct ExternalNodeLink) * LinksNumber);
+    const size_t BatchSizes[] = {1, 10, 100, 1000, 10000};
+    for (size_t k = 0; k < sizeof(BatchSizes) / sizeof(BatchSizes[0]); ++k) {
+        createGraph(Controller, &SingleCGR);
+        createGraph(Controller, &BulkCGR);
+        struct CreateNodeRequest CNR = {.Attributes = &NodeAttribute, .GraphIdType = GRAPH_NAME};
+        size_t FirstSingleId = 0;
+        size_t FirstBulkId = 0;
+        for (size_t i = 0; i < NodesNumber; ++i) {
+            NodeAttribute.Value.IntValue = (int32_t) i;
+            CNR.GraphId.GraphName = "Single";
+            const size_t SingleId = createNode(Controller, &CNR);
+            CNR.GraphId.GraphName = "Bulk";
+            const size_t BulkId = createNode(Controller, &CNR);
+            if (i == 0) {
+                FirstSingleId = SingleId;
+                FirstBulkId = BulkId;
+            }
+        }
+        srand(42);
+        struct CreateNodeLinkRequest CNLR = {
+                .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Single", .Type = DIRECTIONAL};
+        for (size_t i = 0; i < LinksNumber; ++i) {
+            const size_t Left = rand() % NodesNumber;
+            const size_t Right = rand() % NodesNumber;
+            // Node ids of the two graphs interleave
+            Links[i] = (struct ExternalNodeLink){.LeftNodeId = FirstBulkId + 2 * Left,
+                                                 .RightNodeId = FirstBulkId + 2 * Right,
+                                                 .Type = DIRECTIONAL,
+                                                 .Weight = 1.0f};
+        }
+        clock_t Begin = clock();
+        for (size_t i = 0; i < LinksNumber; ++i) {
+            CNLR.LeftNodeId = Links[i].LeftNodeId - FirstBulkId + FirstSingleId;
+            CNLR.RightNodeId = Links[i].RightNodeId - FirstBulkId + FirstSingleId;
+            CNLR.Weight = Links[i].Weight;
+            createNodeLink(Controller, &CNLR);
+        }
+        clock_t End = clock();
+        double SingleTimeDiff = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        struct CreateNodeLinksBulkRequest CNLBR = {.GraphIdType = GRAPH_NAME,
+                                                   .GraphId.GraphName = "Bulk"};
+        Begin = clock();
+        for (size_t i = 0; i < LinksNumber; i += BatchSizes[k]) {
+            CNLBR.Links = Links + i;
+            CNLBR.LinksNumber = BatchSizes[k];
+            createNodeLinksBulk(Controller, &CNLBR);
+        }
+        End = clock();
+        double BulkTimeDiff = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        fprintf(CSVOut, "%zu, %lf, %lf\n", BatchSizes[k], SingleTimeDiff, BulkTimeDiff);
+        struct DeleteGraphRequest DGR = {.Name = "Single"};
+        deleteGraph(Controller, &DGR);
+        DGR.Name = "Bulk";
+        deleteGraph(Controller, &DGR);
+    }
+    free(Links);
+    endWork(Controller);
+}
+
+void benchmarkStreamingSelect(FILE *OutFile) {
+    const char *CSVHeader =
+            "Total Node Number,Streaming,Selected Node Number,First row time ns,Select time ns,"
+            "Buffered addresses";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Even", .Type = BOOL, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Stream"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT}, {.Id = 1, .Type = BOOL}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Stream"};
+    struct AttributeFilter EvenFilter = {
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            NodeAttributes[1].Value.BoolValue = j % 2 == 0;
+            createNode(Controller, &CNR);
+        }
+        for (int Streaming = 0; Streaming < 2; ++Streaming) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Stream",
+                                          .AttributesFilterChain = &EvenFilter,
+                                          .Streaming = Streaming};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            struct ExternalNode *Node;
+            readResultNode(NRS, &Node);
+            free(Node);
+            clock_t FirstRow = clock();
+            const size_t Buffered = nodeResultSetGetSize(NRS);
+            while (moveToNextNode(NRS)) {
+                readResultNode(NRS, &Node);
+                free(Node);
+            }
+            clock_t End = clock();
+            fprintf(CSVOut, "%d, %d, %zu, %lf, %lf, %zu\n", (i + 1) * 100000, Streaming,
+                    nodeResultSetGetSize(NRS),
+                    ((double) (FirstRow - Begin) * 10e9) / CLOCKS_PER_SEC,
+                    ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC, Buffered);
+            deleteNodeResultSet(&NRS);
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Stream"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkPaginatedSelect(FILE *OutFile) {
+    const char *CSVHeader =
+            "Total Node Number,Page start,Page size,Offset page time ns,Resumed page time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Even", .Type = BOOL, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Pages"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT}, {.Id = 1, .Type = BOOL}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Pages"};
+    struct AttributeFilter EvenFilter = {
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = NULL};
+    const size_t PageSize = 100;
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            NodeAttributes[1].Value.BoolValue = j % 2 == 0;
+            createNode(Controller, &CNR);
+        }
+        // The page right before the end of the matches, the one before it
+        // gives the token
+        const size_t PageStart = (i + 1) * 50000 - PageSize;
+        struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                      .GraphId.GraphName = "Pages",
+                                      .AttributesFilterChain = &EvenFilter,
+                                      .Limit = PageSize,
+                                      .Offset = PageStart - PageSize};
+        struct NodeResultSet *NRS = readNode(Controller, &RNR);
+        const struct ResumeToken Token = nodeResultSetGetResumeToken(NRS);
+        deleteNodeResultSet(&NRS);
+
+        RNR.Offset = PageStart;
+        clock_t Begin = clock();
+        NRS = readNode(Controller, &RNR);
+        clock_t End = clock();
+        deleteNodeResultSet(&NRS);
+        const double OffsetTime = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+
+        RNR.Offset = 0;
+        RNR.After = Token;
+        Begin = clock();
+        NRS = readNode(Controller, &RNR);
+        End = clock();
+        deleteNodeResultSet(&NRS);
+        fprintf(CSVOut, "%d, %zu, %zu, %lf, %lf\n", (i + 1) * 100000, PageStart, PageSize,
+                OffsetTime, ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Pages"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkCountNodes(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Query,Node Number,Read time ns,Count time ns,"
+                            "Exists time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[3] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Even", .Type = BOOL, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Scanned", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Count"};
+    createGraph(Controller, &CGR);
+    struct CreateIndexRequest CIR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Count", .AttributeId = 0};
+    createIndex(Controller, &CIR);
+    CIR.AttributeId = 1;
+    createIndex(Controller, &CIR);
+    struct ExternalAttribute NodeAttributes[3] = {
+            {.Id = 0, .Type = INT}, {.Id = 1, .Type = BOOL}, {.Id = 2, .Type = INT}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Count"};
+    struct AttributeFilter RangeFilter = {
+            .AttributeId = 0, .Type = INT_FILTER, .Data.Int = {.HasMin = true, .Min = 1000}};
+    struct AttributeFilter EvenFilter = {
+            .AttributeId = 1, .Type = BOOL_FILTER, .Data.Bool.Value = true};
+    struct AttributeFilter ScanFilter = {
+            .AttributeId = 2, .Type = INT_FILTER, .Data.Int = {.HasMax = true, .Max = 10}};
+    const char *Queries[4] = {"All", "Indexed range", "Bitmap", "Scan"};
+    const struct AttributeFilter *Filters[4] = {NULL, &RangeFilter, &EvenFilter, &ScanFilter};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            NodeAttributes[1].Value.BoolValue = j % 2 == 0;
+            NodeAttributes[2].Value.IntValue = j % 100;
+            createNode(Controller, &CNR);
+        }
+        for (int q = 0; q < 4; ++q) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Count",
+                                          .AttributesFilterChain = Filters[q]};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            const size_t Read = nodeResultSetGetSize(NRS);
+            deleteNodeResultSet(&NRS);
+            clock_t ReadEnd = clock();
+            const size_t Count = countNodes(Controller, &RNR);
+            clock_t CountEnd = clock();
+            existsNode(Controller, &RNR);
+            clock_t End = clock();
+            if (Read != Count) {
+                fprintf(stderr, "Count mismatch: %zu != %zu\n", Count, Read);
+            }
+            fprintf(CSVOut, "%d, %s, %zu, %lf, %lf, %lf\n", (i + 1) * 100000, Queries[q], Count,
+                    ((double) (ReadEnd - Begin) * 10e9) / CLOCKS_PER_SEC,
+                    ((double) (CountEnd - ReadEnd) * 10e9) / CLOCKS_PER_SEC,
+                    ((double) (End - CountEnd) * 10e9) / CLOCKS_PER_SEC);
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Count"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkProjectedSelect(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Attributes Number,Returned Attributes Number,"
+                            "Read time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    // Every other attribute is a long string kept out of the node record
+    const size_t AttributesNumber = 16;
+    struct ExternalAttributeDescription GraphAttributes[16];
+    struct ExternalAttribute NodeAttributes[16];
+    char Names[16][16];
+    char LongString[1024];
+    memset(LongString, 'x', sizeof(LongString) - 1);
+    LongString[sizeof(LongString) - 1] = 0;
+    for (size_t i = 0; i < AttributesNumber; ++i) {
+        snprintf(Names[i], sizeof(Names[i]), "Attribute %zu", i);
+        GraphAttributes[i] = (struct ExternalAttributeDescription){
+                .AttributeId = i,
+                .Name = Names[i],
+                .Type = i % 2 == 0 ? INT : STRING,
+                .Next = i + 1 < AttributesNumber ? GraphAttributes + i + 1 : NULL};
+        NodeAttributes[i] = (struct ExternalAttribute){.Id = i, .Type = GraphAttributes[i].Type};
+        if (NodeAttributes[i].Type == STRING) {
+            NodeAttributes[i].Value.StringAddr = LongString;
+        }
+    }
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Wide"};
+    createGraph(Controller, &CGR);
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Wide"};
+    const size_t Projection[1] = {0};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 10000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 10000 + j;
+            createNode(Controller, &CNR);
+        }
+        for (int Projected = 0; Projected < 2; ++Projected) {
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Wide",
+                                          .Projection = Projected ? Projection : NULL,
+                                          .ProjectionLength = 1};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            size_t Returned = 0;
+            do {
+                struct ExternalNode *Node;
+                readResultNode(NRS, &Node);
+                Returned = Node->AttributesNumber;
+                free(Node);
+            } while (moveToNextNode(NRS));
+            deleteNodeResultSet(&NRS);
+            clock_t End = clock();
+            fprintf(CSVOut, "%d, %zu, %zu, %lf\n", (i + 1) * 10000, AttributesNumber, Returned,
+                    ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Wide"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkNodeViews(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Views,Read time ns,Checksum";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[3] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Name", .Type = STRING, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Text", .Type = STRING, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Views"};
+    createGraph(Controller, &CGR);
+    char Text[256];
+    memset(Text, 't', sizeof(Text) - 1);
+    Text[sizeof(Text) - 1] = 0;
+    struct ExternalAttribute NodeAttributes[3] = {
+            {.Id = 0, .Type = INT},
+            {.Id = 1, .Type = STRING, .Value.StringAddr = "name"},
+            {.Id = 2, .Type = STRING, .Value.StringAddr = Text}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Views"};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            createNode(Controller, &CNR);
+        }
+        for (int Views = 0; Views < 2; ++Views) {
+            struct ReadNodeRequest RNR = {
+                    .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "Views", .Streaming = true};
+            size_t Checksum = 0;
+            clock_t Begin = clock();
+            pinReadEpoch(Controller);
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            do {
+                if (Views) {
+                    struct NodeView View;
+                    readResultNodeView(NRS, &View);
+                    Checksum += View.Attributes[0].Value.IntValue +
+                                nodeViewGetString(&View, &View.Attributes[2])[0];
+                } else {
+                    struct ExternalNode *Node;
+                    readResultNode(NRS, &Node);
+                    Checksum += Node->Attributes[0].Value.IntValue +
+                                Node->Attributes[2].Value.StringAddr[0];
+                    free(Node);
+                }
+            } while (moveToNextNode(NRS));
+            deleteNodeResultSet(&NRS);
+            unpinReadEpoch(Controller);
+            clock_t End = clock();
+            fprintf(CSVOut, "%d, %d, %lf, %zu\n", (i + 1) * 100000, Views,
+                    ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC, Checksum);
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Views"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkScratchAllocations(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Operation,Scratch chunks allocated,Heap bytes held per node,Time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[3] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Name", .Type = STRING, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Float value", .Type = FLOAT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Scratch"};
+    createGraph(Controller, &CGR);
+    // Long enough not to be inlined, so that the string filter reads it from the file
+    char Name[64];
+    memset(Name, 'n', sizeof(Name) - 1);
+    Name[sizeof(Name) - 1] = 0;
+    struct ExternalAttribute NodeAttributes[3] = {
+            {.Id = 0, .Type = INT},
+            {.Id = 1, .Type = STRING, .Value.StringAddr = Name},
+            {.Id = 2, .Type = FLOAT, .Value.FloatValue = 2.5f}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Scratch"};
+    struct AttributeFilter NameFilter = {.AttributeId = 1,
+                                         .Type = STRING_FILTER,
+                                         .Data.String = {.Type = STRING_EQUAL,
+                                                         .Data.StringEqual = Name}};
+    struct AttributeFilter IntFilter = {.AttributeId = 0,
+                                        .Type = INT_FILTER,
+                                        .Data.Int = {.HasMin = true, .Min = 0},
+                                        .Next = &NameFilter};
+    struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                  .GraphId.GraphName = "Scratch",
+                                  .AttributesFilterChain = &IntFilter};
+    for (int i = 0; i < 5; ++i) {
+        // Scratch growth is counted by the arena, the heap memory the
+        // operation keeps afterwards by glibc
+        size_t ChunksBefore = Controller->Scratch->ChunkAllocations;
+        size_t HeapBefore = mallinfo2().uordblks;
+        clock_t Begin = clock();
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            createNode(Controller, &CNR);
+        }
+        clock_t End = clock();
+        fprintf(CSVOut, "%d, Insert, %zu, %lf, %lf\n", (i + 1) * 100000,
+                Controller->Scratch->ChunkAllocations - ChunksBefore,
+                ((double) mallinfo2().uordblks - (double) HeapBefore) / 100000,
+                ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+        ChunksBefore = Controller->Scratch->ChunkAllocations;
+        HeapBefore = mallinfo2().uordblks;
+        Begin = clock();
+        const size_t Count = countNodes(Controller, &RNR);
+        End = clock();
+        fprintf(CSVOut, "%d, Filtered scan, %zu, %lf, %lf\n", (i + 1) * 100000,
+                Controller->Scratch->ChunkAllocations - ChunksBefore,
+                ((double) mallinfo2().uordblks - (double) HeapBefore) / (double) Count,
+                ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Scratch"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkCompiledFilters(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Filters Number,Matched Node Number,Scan time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[6] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Float value", .Type = FLOAT, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Bool value", .Type = BOOL, .Next = GraphAttributes + 3},
+            {.AttributeId = 3, .Name = "Name", .Type = STRING, .Next = GraphAttributes + 4},
+            {.AttributeId = 4, .Name = "Second int", .Type = INT, .Next = GraphAttributes + 5},
+            {.AttributeId = 5, .Name = "Third int", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Program"};
+    createGraph(Controller, &CGR);
+    const char *Names[4] = {"alpha", "beta", "gamma", "delta"};
+    struct ExternalAttribute NodeAttributes[6] = {
+            {.Id = 0, .Type = INT}, {.Id = 1, .Type = FLOAT}, {.Id = 2, .Type = BOOL},
+            {.Id = 3, .Type = STRING}, {.Id = 4, .Type = INT}, {.Id = 5, .Type = INT}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Program"};
+    // Written in the worst order, the selective string filter goes last
+    struct AttributeFilter Filters[4] = {
+            {.AttributeId = 5, .Type = INT_FILTER, .Data.Int = {.HasMin = true, .Min = 0},
+             .Next = Filters + 1},
+            {.AttributeId = 1, .Type = FLOAT_FILTER,
+             .Data.Float = {.HasMin = true, .Min = 0, .HasMax = true, .Max = 1000},
+             .Next = Filters + 2},
+            {.AttributeId = 2, .Type = BOOL_FILTER, .Data.Bool.Value = true, .Next = Filters + 3},
+            {.AttributeId = 3, .Type = STRING_FILTER,
+             .Data.String = {.Type = STRING_EQUAL, .Data.StringEqual = "gamma"}}};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = j;
+            NodeAttributes[1].Value.FloatValue = (float) (j % 1000);
+            NodeAttributes[2].Value.BoolValue = j % 10 != 0;
+            NodeAttributes[3].Value.StringAddr = (char *) Names[j % 4];
+            NodeAttributes[4].Value.IntValue = j % 7;
+            NodeAttributes[5].Value.IntValue = j % 100;
+            createNode(Controller, &CNR);
+        }
+        for (int FiltersNumber = 1; FiltersNumber <= 4; ++FiltersNumber) {
+            Filters[FiltersNumber - 1].Next = NULL;
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Program",
+                                          .AttributesFilterChain = Filters};
+            clock_t Begin = clock();
+            const size_t Count = countNodes(Controller, &RNR);
+            clock_t End = clock();
+            fprintf(CSVOut, "%d, %d, %zu, %lf\n", (i + 1) * 100000, FiltersNumber, Count,
+                    ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+            if (FiltersNumber < 4) {
+                Filters[FiltersNumber - 1].Next = Filters + FiltersNumber;
+            }
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Program"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkVectorFilters(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Filters Number,Matched Node Number,Read time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[4] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Float value", .Type = FLOAT, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Bool value", .Type = BOOL, .Next = GraphAttributes + 3},
+            {.AttributeId = 3, .Name = "Name", .Type = STRING, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Vector"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[4] = {{.Id = 0, .Type = INT},
+                                                  {.Id = 1, .Type = FLOAT},
+                                                  {.Id = 2, .Type = BOOL},
+                                                  {.Id = 3, .Type = STRING, .Value.StringAddr = "n"}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Vector"};
+    struct AttributeFilter Filters[3] = {
+            {.AttributeId = 0, .Type = INT_FILTER,
+             .Data.Int = {.HasMin = true, .Min = 100, .HasMax = true, .Max = 199},
+             .Next = Filters + 1},
+            {.AttributeId = 1, .Type = FLOAT_FILTER, .Data.Float = {.HasMax = true, .Max = 50},
+             .Next = Filters + 2},
+            {.AttributeId = 2, .Type = BOOL_FILTER, .Data.Bool.Value = true}};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = j % 1000;
+            NodeAttributes[1].Value.FloatValue = (float) (j % 100);
+            NodeAttributes[2].Value.BoolValue = j % 3 == 0;
+            createNode(Controller, &CNR);
+        }
+        for (int FiltersNumber = 1; FiltersNumber <= 3; ++FiltersNumber) {
+            Filters[FiltersNumber - 1].Next = NULL;
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Vector",
+                                          .AttributesFilterChain = Filters};
+            clock_t Begin = clock();
+            struct NodeResultSet *NRS = readNode(Controller, &RNR);
+            const size_t Count = nodeResultSetGetSize(NRS);
+            deleteNodeResultSet(&NRS);
+            clock_t End = clock();
+            fprintf(CSVOut, "%d, %d, %zu, %lf\n", (i + 1) * 100000, FiltersNumber, Count,
+                    ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+            if (FiltersNumber < 3) {
+                Filters[FiltersNumber - 1].Next = Filters + FiltersNumber;
+            }
+        }
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Vector"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkParallelScan(FILE *OutFile) {
+    const char *CSVHeader = "Threads Number,Matched Node Number,Read time ns,Update time ns,"
+                            "Read speed-up,Update speed-up";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Name", .Type = STRING, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Parallel"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[2] = {{.Id = 0, .Type = INT},
+                                                  {.Id = 1, .Type = STRING}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Parallel"};
+    char *Names[4] = {"alpha", "beta", "gamma", "delta"};
+    for (int j = 0; j < 500000; ++j) {
+        NodeAttributes[0].Value.IntValue = j % 1000;
+        NodeAttributes[1].Value.StringAddr = Names[j % 4];
+        createNode(Controller, &CNR);
+    }
+    // The string filter is not vectorized, so every node takes a scalar check
+    struct AttributeFilter Filters[2] = {
+            {.AttributeId = 1, .Type = STRING_FILTER,
+             .Data.String = {.Type = STRING_EQUAL, .Data.StringEqual = "gamma"},
+             .Next = Filters + 1},
+            {.AttributeId = 0, .Type = INT_FILTER,
+             .Data.Int = {.HasMin = true, .Min = 0, .HasMax = true, .Max = 9}}};
+    struct ExternalAttribute NewAttributes[1] = {{.Id = 0, .Type = INT, .Value.IntValue = 5}};
+    struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                  .GraphId.GraphName = "Parallel",
+                                  .AttributesFilterChain = Filters};
+    struct UpdateNodeRequest UNR = {.GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Parallel",
+                                    .AttributesFilterChain = Filters,
+                                    .Attributes = NewAttributes,
+                                    .UpdatedAttributesNumber = 1};
+    double SerialRead = 0;
+    double SerialUpdate = 0;
+    for (size_t Threads = 1; Threads <= SCAN_THREADS_MAX; Threads *= 2) {
+        setScanThreads(Controller, Threads);
+        // Wall time, the clock of the process would add up the time of every thread
+        double Begin = getWallTime();
+        struct NodeResultSet *NRS = readNode(Controller, &RNR);
+        const size_t Count = nodeResultSetGetSize(NRS);
+        deleteNodeResultSet(&NRS);
+        const double Read = getWallTime() - Begin;
+        Begin = getWallTime();
+        updateNode(Controller, &UNR);
+        const double Update = getWallTime() - Begin;
+        if (Threads == 1) {
+            SerialRead = Read;
+            SerialUpdate = Update;
+        }
+        fprintf(CSVOut, "%zu, %zu, %lf, %lf, %lf, %lf\n", Threads, Count, Read, Update,
+                SerialRead / Read, SerialUpdate / Update);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Parallel"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkBlockDirectory(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Page start,Page size,Resumed page time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Directory"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Directory"};
+    const size_t PageSize = 100;
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            createNode(Controller, &CNR);
+        }
+        const size_t PageStart = (i + 1) * 100000 - PageSize;
+        struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                      .GraphId.GraphName = "Directory",
+                                      .Limit = PageSize,
+                                      .Offset = PageStart - PageSize};
+        struct NodeResultSet *NRS = readNode(Controller, &RNR);
+        struct ResumeToken Token = nodeResultSetGetResumeToken(NRS);
+        deleteNodeResultSet(&NRS);
+        // As if the node of the token had been moved, only its slot is left to
+        // find the place
+        Token.Addr.HasValue = false;
+        RNR.Offset = 0;
+        RNR.After = Token;
+        clock_t Begin = clock();
+        NRS = readNode(Controller, &RNR);
+        clock_t End = clock();
+        deleteNodeResultSet(&NRS);
+        fprintf(CSVOut, "%d, %zu, %zu, %lf\n", (i + 1) * 100000, PageStart, PageSize,
+                ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Directory"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkCompactRecords(FILE *OutFile) {
+    const char *CSVHeader =
+            "Total Node Number,Node record bytes,Link record bytes,Scanned bytes,Scan time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[4] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Float value", .Type = FLOAT, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Bool value", .Type = BOOL, .Next = GraphAttributes + 3},
+            {.AttributeId = 3, .Name = "Name", .Type = STRING, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "Compact"};
+    createGraph(Controller, &CGR);
+    const char *Names[4] = {"alpha", "beta", "gamma", "delta"};
+    struct ExternalAttribute NodeAttributes[4] = {
+            {.Id = 0, .Type = INT}, {.Id = 1, .Type = FLOAT}, {.Id = 2, .Type = BOOL},
+            {.Id = 3, .Type = STRING}};
+    struct CreateNodeRequest CNR = {.Attributes = NodeAttributes,
+                                    .GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "Compact"};
+    const size_t NodeBytes = sizeof(struct Node) + 4 * sizeof(struct Attribute);
+    struct AttributeFilter IntFilter = {.AttributeId = 0,
+                                        .Type = INT_FILTER,
+                                        .Data.Int = {.HasMin = true, .Min = 0},
+                                        .Next = NULL};
+    struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                  .GraphId.GraphName = "Compact",
+                                  .AttributesFilterChain = &IntFilter};
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 100000; ++j) {
+            NodeAttributes[0].Value.IntValue = i * 100000 + j;
+            NodeAttributes[1].Value.FloatValue = (float) j / 7;
+            NodeAttributes[2].Value.BoolValue = j % 2 == 0;
+            NodeAttributes[3].Value.StringAddr = (char *) Names[j % 4];
+            createNode(Controller, &CNR);
+        }
+        clock_t Begin = clock();
+        countNodes(Controller, &RNR);
+        clock_t End = clock();
+        fprintf(CSVOut, "%d, %zu, %zu, %zu, %lf\n", (i + 1) * 100000, NodeBytes,
+                sizeof(struct NodeLink), NodeBytes * (i + 1) * 100000,
+                ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC);
+    }
+    struct DeleteGraphRequest DGR = {.Name = "Compact"};
+    deleteGraph(Controller, &DGR);
+    endWork(Controller);
+}
+
+void benchmarkColumnarScan(FILE *OutFile) {
+    const char *CSVHeader = "Total Node Number,Row scan time ns,Columnar scan time ns";
+    FILE *CSVOut = OutFile;
+    fprintf(CSVOut, "%s\n", CSVHeader);
+    struct StorageController *Controller = beginWork("bench.bin");
+    struct ExternalAttributeDescription GraphAttributes[4] = {
+            {.AttributeId = 0, .Name = "Int value", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Float value", .Type = FLOAT, .Next = GraphAttributes + 2},
+            {.AttributeId = 2, .Name = "Bool value", .Type = BOOL, .Next = GraphAttributes + 3},
+            {.AttributeId = 3, .Name = "Name", .Type = STRING, .Next = NULL}};
+    char *GraphNames[2] = {"Rows", "Columns"};
+    struct CreateGraphRequest RowRequest = {.AttributesDescription = GraphAttributes,
+                                            .Name = GraphNames[0]};
+    createGraph(Controller, &RowRequest);
+    struct CreateGraphRequest ColumnRequest = {.AttributesDescription = GraphAttributes,
+                                               .Name = GraphNames[1],
+                                               .Columnar = true};
+    createGraph(Controller, &ColumnRequest);
+    const char *Names[4] = {"alpha", "beta", "gamma", "delta"};
+    const size_t BatchSize = 100000;
+    struct ExternalAttribute *NodeAttributes =
+            malloc(sizeof(struct ExternalAttribute) * 4 * BatchSize);
+    struct AttributeFilter IntFilter = {
+            .AttributeId = 0,
+            .Type = INT_FILTER,
+            .Data.Int = {.HasMin = true, .Min = 1000, .HasMax = true, .Max = 2000},
+            .Next = NULL};
+    for (int i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < BatchSize; ++j) {
+            struct ExternalAttribute *Attributes = NodeAttributes + 4 * j;
+            Attributes[0] = (struct ExternalAttribute){.Id = 0, .Type = INT};
+            Attributes[0].Value.IntValue = rand() % 100000;
+            Attributes[1] = (struct ExternalAttribute){.Id = 1, .Type = FLOAT};
+            Attributes[1].Value.FloatValue = (float) j / 7;
+            Attributes[2] = (struct ExternalAttribute){.Id = 2, .Type = BOOL};
+            Attributes[2].Value.BoolValue = j % 2 == 0;
+            Attributes[3] = (struct ExternalAttribute){.Id = 3, .Type = STRING};
+            Attributes[3].Value.StringAddr = (char *) Names[j % 4];
+        }
+        double Times[2];
+        for (int g = 0; g < 2; ++g) {
+            struct CreateNodesBulkRequest CNBR = {.GraphIdType = GRAPH_NAME,
+                                                  .GraphId.GraphName = GraphNames[g],
+                                                  .Attributes = NodeAttributes,
+                                                  .NodesNumber = BatchSize};
+            createNodesBulk(Controller, &CNBR);
+            struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = GraphNames[g],
+                                          .AttributesFilterChain = &IntFilter};
+            clock_t Begin = clock();
+            countNodes(Controller, &RNR);
+            clock_t End = clock();
+            Times[g] = ((double) (End - Begin) * 10e9) / CLOCKS_PER_SEC;
+        }
+        fprintf(CSVOut, "%zu, %lf, %lf\n", (i + 1) * BatchSize, Times[0], Times[1]);
+    }
+    free(NodeAttributes);
+    for (int g = 0; g < 2; ++g) {
+        struct DeleteGraphRequest DGR = {.Name = GraphNames[g]};
+        deleteGraph(Controller, &DGR);
+    }
+    endWork(Controller);
+}
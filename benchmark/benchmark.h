@@ -4,10 +4,31 @@
 #include <stdio.h>
 
 void benchmarkNodeInsert(FILE *OutFile);
+void benchmarkNodeBulkInsert(FILE *OutFile);
+void benchmarkNodeLinkBulkInsert(FILE *OutFile);
 void benchmarkSelectByAttributes(FILE *OutFile);
 void benchmarkDeleteElements(FILE *OutFile);
 void benchmarkUpdateProgressingElements(FILE *OutFile);
 void benchmarkFileSize(FILE *OutFile);
 void benchmarkDop(FILE *OutFile);
+void benchmarkAllocator(FILE *OutFile);
+void benchmarkNodeLookupById(FILE *OutFile);
+void benchmarkLinkLookupByNode(FILE *OutFile);
+void benchmarkIndexedRangeSelect(FILE *OutFile);
+void benchmarkStringEqualSelect(FILE *OutFile);
+void benchmarkBoolBitmapSelect(FILE *OutFile);
+void benchmarkZoneMapSkip(FILE *OutFile);
+void benchmarkStreamingSelect(FILE *OutFile);
+void benchmarkPaginatedSelect(FILE *OutFile);
+void benchmarkCountNodes(FILE *OutFile);
+void benchmarkProjectedSelect(FILE *OutFile);
+void benchmarkNodeViews(FILE *OutFile);
+void benchmarkScratchAllocations(FILE *OutFile);
+void benchmarkCompiledFilters(FILE *OutFile);
+void benchmarkVectorFilters(FILE *OutFile);
+void benchmarkParallelScan(FILE *OutFile);
+void benchmarkBlockDirectory(FILE *OutFile);
+void benchmarkCompactRecords(FILE *OutFile);
+void benchmarkColumnarScan(FILE *OutFile);
 
 #endif //LLP_LAB1_BENCHMARK_H
@@ -5,7 +5,13 @@
 
 #define INITIAL_FILE_SIZE 16384
 #define BLOCK_MIN_CAPACITY 64
+#define FREE_LIST_CLASSES 32
 #define GRAPH_NODES_PER_BLOCK 1000
 #define GRAPH_LINKS_PER_BLOCK 1000
+#define BTREE_PAGE_KEYS 64
+#define NODE_RESULT_SET_BATCH 64
+#define FILE_MAPPING_RESERVE ((size_t) 64 << 30)
+#define ARENA_CHUNK_SIZE 65536
+#define SCAN_THREADS_MAX 64
 
 #endif //LLP_LAB1_CONFIG_H
@@ -1,3 +1,5 @@
+#define _GNU_SOURCE
+
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -11,13 +13,42 @@
 
 #include "file-io.h"
 
+// The file is mapped at the start of ReservedSize bytes of address space, so
+// growing it inside of the reservation never moves the mapping. A read-only
+// allocator maps the file privately, nothing it changes reaches the disk.
 struct FileAllocator {
     int FileDescriptor;
     size_t FileSize;
     void *MappedFile;
+    size_t ReservedSize;
+    bool ReadOnly;
+};
+
+#define SUPERBLOCK_MAGIC 0x3150504cu
+#define FILE_FORMAT_VERSION 1
+
+// Lives at offset 0 of the file. FreeLists[i] heads the list of free blocks
+// whose data size is in [BLOCK_MIN_CAPACITY * 2^i, BLOCK_MIN_CAPACITY * 2^(i+1)),
+// the last class also takes everything bigger. CleanShutdown is cleared while
+// the file is open, so the allocator state is only trusted if it was written
+// out by shutdownFileAllocator().
+struct Superblock {
+    uint32_t Magic;
+    uint32_t FormatVersion;
+    bool CleanShutdown;
+    size_t FileSize;
+    size_t LastBlockOffset;
+    struct OptionalOffset FreeLists[FREE_LIST_CLASSES];
+};
+
+// Stored in the data area of every free block, so it costs no space in
+// occupied ones.
+struct FreeBlockLinks {
+    struct OptionalOffset NextFree;
+    struct OptionalOffset PrevFree;
 };
 
-#define FIRST_BLOCK_OFFSET sizeof(uint64_t)
+#define FIRST_BLOCK_OFFSET sizeof(struct Superblock)
 
 static void blockInit(const struct FileAllocator *const Allocator, size_t Offset,
                       size_t FullSize, struct OptionalOffset NextBlockOffset,
@@ -31,53 +62,315 @@ static void blockInit(const struct FileAllocator *const Allocator, size_t Offset
     memset((char *) Allocator->MappedFile + Offset + FullSize - 1, 0, 1);
 }
 
-static void initEmptyFile(const struct FileAllocator *const Allocator) {
-    blockInit(Allocator, 0, INITIAL_FILE_SIZE, NULL_OFFSET,
-              NULL_OFFSET); // Initialize first block
-    size_t *ZeroData = memset(malloc(INITIAL_FILE_SIZE), 0, INITIAL_FILE_SIZE);
-    size_t zeroes_written = fwrite(
-            ZeroData, sizeof(size_t),
-            (INITIAL_FILE_SIZE - sizeof(struct BlockHeader)) / sizeof(size_t),
-            Allocator->MappedFile);
-    free(ZeroData);
-}
-
-static void extendFile(struct FileAllocator *const Allocator,
-                       struct OptionalOffset LastBlockOffset) {
-    struct BlockHeader OldLastBlock;
-    memcpy(&OldLastBlock, (char *) Allocator->MappedFile + LastBlockOffset.Offset, sizeof(OldLastBlock));
-    const size_t EndOfLastBlock = LastBlockOffset.Offset + OldLastBlock.FullSize;
-    blockInit(Allocator, EndOfLastBlock, Allocator->FileSize, NULL_OFFSET, LastBlockOffset);
-    OldLastBlock.NextBlockOffset = getOptionalOffset(EndOfLastBlock);
-    memcpy((char *) Allocator->MappedFile + LastBlockOffset.Offset, &OldLastBlock, sizeof(OldLastBlock));
-    Allocator->FileSize *= 2;
+static void setPrevBlockOffset(const struct FileAllocator *const Allocator, const size_t Offset,
+                               const struct OptionalOffset PrevBlockOffset) {
+    struct BlockHeader Header;
+    memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
+    Header.PrevBlockOffset = PrevBlockOffset;
+    memcpy((char *) Allocator->MappedFile + Offset, &Header, sizeof(Header));
+}
+
+static size_t getSizeClass(const size_t DataSize) {
+    size_t Class = 0;
+    size_t Capacity = DataSize / BLOCK_MIN_CAPACITY;
+    while (Capacity > 1 && Class < FREE_LIST_CLASSES - 1) {
+        Capacity >>= 1;
+        Class++;
+    }
+    return Class;
+}
+
+static struct OptionalOffset getFreeListHead(const struct FileAllocator *const Allocator,
+                                             const size_t Class) {
+    struct OptionalOffset Head;
+    memcpy(&Head,
+           (char *) Allocator->MappedFile + offsetof(struct Superblock, FreeLists) +
+           Class * sizeof(struct OptionalOffset),
+           sizeof(Head));
+    return Head;
+}
+
+static void setFreeListHead(const struct FileAllocator *const Allocator, const size_t Class,
+                            const struct OptionalOffset Head) {
+    memcpy((char *) Allocator->MappedFile + offsetof(struct Superblock, FreeLists) +
+           Class * sizeof(struct OptionalOffset),
+           &Head, sizeof(Head));
+}
+
+static size_t getLastBlockOffset(const struct FileAllocator *const Allocator) {
+    size_t LastBlockOffset;
+    memcpy(&LastBlockOffset,
+           (char *) Allocator->MappedFile + offsetof(struct Superblock, LastBlockOffset),
+           sizeof(LastBlockOffset));
+    return LastBlockOffset;
+}
+
+static void setLastBlockOffset(const struct FileAllocator *const Allocator,
+                               const size_t LastBlockOffset) {
+    memcpy((char *) Allocator->MappedFile + offsetof(struct Superblock, LastBlockOffset),
+           &LastBlockOffset, sizeof(LastBlockOffset));
+}
+
+static void fetchFreeLinks(const struct FileAllocator *const Allocator, const size_t Offset,
+                           struct FreeBlockLinks *const Links) {
+    memcpy(Links, (char *) Allocator->MappedFile + Offset + sizeof(struct BlockHeader),
+           sizeof(*Links));
+}
+
+static void storeFreeLinks(const struct FileAllocator *const Allocator, const size_t Offset,
+                           const struct FreeBlockLinks *const Links) {
+    memcpy((char *) Allocator->MappedFile + Offset + sizeof(struct BlockHeader), Links,
+           sizeof(*Links));
+}
+
+static void pushFreeBlock(const struct FileAllocator *const Allocator, const size_t Offset) {
+    struct BlockHeader Header;
+    memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
+    const size_t Class = getSizeClass(Header.DataSize);
+    struct FreeBlockLinks Links = {.NextFree = getFreeListHead(Allocator, Class),
+            .PrevFree = NULL_OFFSET};
+    if (Links.NextFree.HasValue) {
+        struct FreeBlockLinks NextLinks;
+        fetchFreeLinks(Allocator, Links.NextFree.Offset, &NextLinks);
+        NextLinks.PrevFree = getOptionalOffset(Offset);
+        storeFreeLinks(Allocator, Links.NextFree.Offset, &NextLinks);
+    }
+    storeFreeLinks(Allocator, Offset, &Links);
+    setFreeListHead(Allocator, Class, getOptionalOffset(Offset));
 }
 
+static void unlinkFreeBlock(const struct FileAllocator *const Allocator, const size_t Offset) {
+    struct BlockHeader Header;
+    memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
+    struct FreeBlockLinks Links;
+    fetchFreeLinks(Allocator, Offset, &Links);
+    if (Links.PrevFree.HasValue) {
+        struct FreeBlockLinks PrevLinks;
+        fetchFreeLinks(Allocator, Links.PrevFree.Offset, &PrevLinks);
+        PrevLinks.NextFree = Links.NextFree;
+        storeFreeLinks(Allocator, Links.PrevFree.Offset, &PrevLinks);
+    } else {
+        setFreeListHead(Allocator, getSizeClass(Header.DataSize), Links.NextFree);
+    }
+    if (Links.NextFree.HasValue) {
+        struct FreeBlockLinks NextLinks;
+        fetchFreeLinks(Allocator, Links.NextFree.Offset, &NextLinks);
+        NextLinks.PrevFree = Links.PrevFree;
+        storeFreeLinks(Allocator, Links.NextFree.Offset, &NextLinks);
+    }
+}
+
+// Glues the block following Offset to it. Free lists are not touched.
+static void absorbNextBlock(const struct FileAllocator *const Allocator, const size_t Offset,
+                            const struct BlockHeader *const Header,
+                            const struct BlockHeader *const NextHeader) {
+    blockInit(Allocator, Offset, Header->FullSize + NextHeader->FullSize,
+              NextHeader->NextBlockOffset, Header->PrevBlockOffset);
+    if (NextHeader->NextBlockOffset.HasValue) {
+        setPrevBlockOffset(Allocator, NextHeader->NextBlockOffset.Offset, getOptionalOffset(Offset));
+    } else {
+        setLastBlockOffset(Allocator, Offset);
+    }
+}
+
+// The block at Offset must not be in a free list, the absorbed ones are
+// unlinked from theirs.
 static void mergeWhilePossible(const struct FileAllocator *const Allocator, const size_t Offset) {
     struct BlockHeader Header;
     memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
-    if (!Header.IsOccupied) {
-        if (Header.NextBlockOffset.HasValue) {
-            struct BlockHeader NextHeader;
-            memcpy(&NextHeader, (char *) Allocator->MappedFile + Header.NextBlockOffset.Offset, sizeof(NextHeader));
-            if (!NextHeader.IsOccupied) {
-                blockInit(Allocator, Offset, Header.FullSize + NextHeader.FullSize,
-                          NextHeader.NextBlockOffset, Header.PrevBlockOffset);
-                mergeWhilePossible(Allocator, Offset);
-            }
+    while (!Header.IsOccupied && Header.NextBlockOffset.HasValue) {
+        struct BlockHeader NextHeader;
+        memcpy(&NextHeader, (char *) Allocator->MappedFile + Header.NextBlockOffset.Offset, sizeof(NextHeader));
+        if (NextHeader.IsOccupied) {
+            break;
+        }
+        unlinkFreeBlock(Allocator, Header.NextBlockOffset.Offset);
+        absorbNextBlock(Allocator, Offset, &Header, &NextHeader);
+        memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
+    }
+}
+
+// Puts a free block (not yet listed) into its free list, merging it with its
+// free neighbours first.
+static void releaseBlock(const struct FileAllocator *const Allocator, size_t Offset) {
+    struct BlockHeader Header;
+    memcpy(&Header, (char *) Allocator->MappedFile + Offset, sizeof(Header));
+    if (Header.PrevBlockOffset.HasValue) {
+        struct BlockHeader PrevHeader;
+        memcpy(&PrevHeader, (char *) Allocator->MappedFile + Header.PrevBlockOffset.Offset, sizeof(PrevHeader));
+        if (!PrevHeader.IsOccupied) {
+            unlinkFreeBlock(Allocator, Header.PrevBlockOffset.Offset);
+            absorbNextBlock(Allocator, Header.PrevBlockOffset.Offset, &PrevHeader, &Header);
+            Offset = Header.PrevBlockOffset.Offset;
         }
-        memcpy((char *) Allocator->MappedFile + Offset, &Header, sizeof(Header));
     }
+    mergeWhilePossible(Allocator, Offset);
+    pushFreeBlock(Allocator, Offset);
 }
 
+// Rebuilds every free list from the block chain, merging adjacent free blocks
+// on the way.
 static void mergeAllPossible(const struct FileAllocator *const Allocator) {
+    for (size_t Class = 0; Class < FREE_LIST_CLASSES; ++Class) {
+        setFreeListHead(Allocator, Class, NULL_OFFSET);
+    }
+    struct OptionalOffset CurrentOffset = getOptionalOffset(FIRST_BLOCK_OFFSET);
+    while (CurrentOffset.HasValue) {
+        setLastBlockOffset(Allocator, CurrentOffset.Offset);
+        struct BlockHeader Header;
+        memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset.Offset, sizeof(Header));
+        if (!Header.IsOccupied) {
+            while (Header.NextBlockOffset.HasValue) {
+                struct BlockHeader NextHeader;
+                memcpy(&NextHeader, (char *) Allocator->MappedFile + Header.NextBlockOffset.Offset,
+                       sizeof(NextHeader));
+                if (NextHeader.IsOccupied) {
+                    break;
+                }
+                absorbNextBlock(Allocator, CurrentOffset.Offset, &Header, &NextHeader);
+                memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset.Offset, sizeof(Header));
+            }
+            pushFreeBlock(Allocator, CurrentOffset.Offset);
+        }
+        CurrentOffset = Header.NextBlockOffset;
+    }
+}
+
+static void fetchSuperblock(const struct FileAllocator *const Allocator,
+                            struct Superblock *const Superblock) {
+    memcpy(Superblock, Allocator->MappedFile, sizeof(*Superblock));
+}
+
+static void storeSuperblock(const struct FileAllocator *const Allocator,
+                            const struct Superblock *const Superblock) {
+    memcpy(Allocator->MappedFile, Superblock, sizeof(*Superblock));
+}
+
+// Writes CleanShutdown straight to disk, after everything else when it is set.
+static void markCleanShutdown(const struct FileAllocator *const Allocator, const bool Clean) {
+    struct Superblock Superblock;
+    if (Clean) {
+        msync(Allocator->MappedFile, Allocator->FileSize, MS_SYNC);
+    }
+    fetchSuperblock(Allocator, &Superblock);
+    Superblock.CleanShutdown = Clean;
+    storeSuperblock(Allocator, &Superblock);
+    msync(Allocator->MappedFile, sizeof(Superblock), MS_SYNC);
+}
+
+// Recovery after a crash: the block chain is the source of truth, space past
+// its end (left by an interrupted growth) becomes one more free block.
+static void recoverAllocatorState(const struct FileAllocator *const Allocator) {
+    struct Superblock Superblock;
+    fetchSuperblock(Allocator, &Superblock);
+    Superblock.FileSize = Allocator->FileSize;
+    storeSuperblock(Allocator, &Superblock);
+    size_t LastBlockOffset = FIRST_BLOCK_OFFSET;
     struct BlockHeader Header;
-    mergeWhilePossible(Allocator, FIRST_BLOCK_OFFSET);
-    memcpy(&Header, (char *) Allocator->MappedFile + FIRST_BLOCK_OFFSET, sizeof(struct BlockHeader));
+    memcpy(&Header, (char *) Allocator->MappedFile + LastBlockOffset, sizeof(Header));
     while (Header.NextBlockOffset.HasValue) {
-        mergeWhilePossible(Allocator, Header.NextBlockOffset.Offset);
-        memcpy(&Header, (char *) Allocator->MappedFile + Header.NextBlockOffset.Offset, sizeof(struct BlockHeader));
+        LastBlockOffset = Header.NextBlockOffset.Offset;
+        memcpy(&Header, (char *) Allocator->MappedFile + LastBlockOffset, sizeof(Header));
     }
+    const size_t EndOfLastBlock = LastBlockOffset + Header.FullSize;
+    if (EndOfLastBlock + sizeof(struct BlockHeader) + BLOCK_MIN_CAPACITY <= Allocator->FileSize) {
+        blockInit(Allocator, EndOfLastBlock, Allocator->FileSize - EndOfLastBlock, NULL_OFFSET,
+                  getOptionalOffset(LastBlockOffset));
+        Header.NextBlockOffset = getOptionalOffset(EndOfLastBlock);
+        memcpy((char *) Allocator->MappedFile + LastBlockOffset, &Header, sizeof(Header));
+    }
+    mergeAllPossible(Allocator);
+}
+
+static void initEmptyFile(const struct FileAllocator *const Allocator) {
+    memset(Allocator->MappedFile, 0, Allocator->FileSize);
+    const struct Superblock Superblock = {.Magic = SUPERBLOCK_MAGIC,
+            .FormatVersion = FILE_FORMAT_VERSION,
+            .CleanShutdown = false,
+            .FileSize = Allocator->FileSize};
+    storeSuperblock(Allocator, &Superblock);
+    blockInit(Allocator, FIRST_BLOCK_OFFSET, Allocator->FileSize - FIRST_BLOCK_OFFSET,
+              NULL_OFFSET, NULL_OFFSET);
+    setLastBlockOffset(Allocator, FIRST_BLOCK_OFFSET);
+    pushFreeBlock(Allocator, FIRST_BLOCK_OFFSET);
+}
+
+// Reserves disk space for the file up to NewSize. Falls back to a sparse
+// ftruncate where the file system cannot preallocate.
+static bool resizeFile(const struct FileAllocator *const Allocator, const size_t NewSize) {
+    if (fallocate(Allocator->FileDescriptor, 0, Allocator->FileSize,
+                  NewSize - Allocator->FileSize) == 0) {
+        return true;
+    }
+    return ftruncate(Allocator->FileDescriptor, NewSize) == 0;
+}
+
+// Grows the file at least twice, and always enough for DataSize bytes to fit
+// in one block, so a single step covers any allocation. The new space becomes
+// a free block glued to the old last one if that was free too.
+static bool extendFile(struct FileAllocator *const Allocator, const size_t DataSize) {
+    const size_t OldFileSize = Allocator->FileSize;
+    size_t NewFileSize = OldFileSize * 2;
+    if (NewFileSize < OldFileSize + DataSize + sizeof(struct BlockHeader)) {
+        NewFileSize = OldFileSize + DataSize + sizeof(struct BlockHeader);
+    }
+    // Records keep packed addresses, so no block may start past their range
+    if (NewFileSize > PACKED_BLOCK_OFFSET_LIMIT) {
+        if (OldFileSize + DataSize + sizeof(struct BlockHeader) > PACKED_BLOCK_OFFSET_LIMIT) {
+            return false;
+        }
+        NewFileSize = PACKED_BLOCK_OFFSET_LIMIT;
+    }
+    if (!resizeFile(Allocator, NewFileSize)) {
+        return false;
+    }
+    const size_t PageSize = sysconf(_SC_PAGESIZE);
+    if (NewFileSize <= Allocator->ReservedSize) {
+        // Pages of the old end are mapped again together with the new ones,
+        // mmap needs a page aligned offset
+        const size_t MapFrom = OldFileSize / PageSize * PageSize;
+        void *const Extension =
+                mmap((char *) Allocator->MappedFile + MapFrom, NewFileSize - MapFrom,
+                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, Allocator->FileDescriptor,
+                     MapFrom);
+        if (Extension == MAP_FAILED) {
+            return false;
+        }
+    } else {
+        // The reservation is dropped from the first page past the mapped file,
+        // munmap needs a page aligned address
+        const size_t MappedEnd = (OldFileSize + PageSize - 1) / PageSize * PageSize;
+        if (Allocator->ReservedSize > MappedEnd) {
+            if (munmap((char *) Allocator->MappedFile + MappedEnd,
+                       Allocator->ReservedSize - MappedEnd) != 0) {
+                return false;
+            }
+            Allocator->ReservedSize = MappedEnd;
+        }
+        void *const NewMapping =
+                mremap(Allocator->MappedFile, OldFileSize, NewFileSize, MREMAP_MAYMOVE);
+        if (NewMapping == MAP_FAILED) {
+            Allocator->ReservedSize = OldFileSize;
+            return false;
+        }
+        Allocator->MappedFile = NewMapping;
+        Allocator->ReservedSize = NewFileSize;
+    }
+    Allocator->FileSize = NewFileSize;
+    struct Superblock Superblock;
+    fetchSuperblock(Allocator, &Superblock);
+    Superblock.FileSize = NewFileSize;
+    storeSuperblock(Allocator, &Superblock);
+    const size_t LastBlockOffset = getLastBlockOffset(Allocator);
+    struct BlockHeader OldLastBlock;
+    memcpy(&OldLastBlock, (char *) Allocator->MappedFile + LastBlockOffset, sizeof(OldLastBlock));
+    blockInit(Allocator, OldFileSize, NewFileSize - OldFileSize, NULL_OFFSET,
+              getOptionalOffset(LastBlockOffset));
+    OldLastBlock.NextBlockOffset = getOptionalOffset(OldFileSize);
+    memcpy((char *) Allocator->MappedFile + LastBlockOffset, &OldLastBlock, sizeof(OldLastBlock));
+    setLastBlockOffset(Allocator, OldFileSize);
+    releaseBlock(Allocator, OldFileSize);
+    return true;
 }
 
 static size_t getHeadersNumber(const struct FileAllocator *const Allocator) {
@@ -102,31 +395,113 @@ static void readAllHeaders(const struct FileAllocator *const Allocator,
     }
 }
 
+// Reserves FILE_MAPPING_RESERVE bytes of address space and maps the file at
+// its start. Without the reservation the file is mapped as is.
+static bool mapAllocatorFile(struct FileAllocator *const Allocator) {
+    Allocator->ReservedSize = Allocator->FileSize;
+    void *Base = NULL;
+    if (FILE_MAPPING_RESERVE > Allocator->FileSize) {
+        Base = mmap(NULL, FILE_MAPPING_RESERVE, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (Base == MAP_FAILED) {
+            Base = NULL;
+        } else {
+            Allocator->ReservedSize = FILE_MAPPING_RESERVE;
+        }
+    }
+    Allocator->MappedFile = mmap(Base, Allocator->FileSize, PROT_READ | PROT_WRITE,
+                                 (Allocator->ReadOnly ? MAP_PRIVATE : MAP_SHARED) |
+                                         (Base != NULL ? MAP_FIXED : 0),
+                                 Allocator->FileDescriptor, 0);
+    if (Allocator->MappedFile == MAP_FAILED) {
+        if (Base != NULL) {
+            munmap(Base, FILE_MAPPING_RESERVE);
+        }
+        return false;
+    }
+    return true;
+}
+
 struct FileAllocator *initFileAllocator(char *fileName) {
     struct FileAllocator *const Allocator = malloc(sizeof(struct FileAllocator));
     Allocator->FileDescriptor = open(fileName, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    Allocator->ReadOnly = false;
     if (Allocator->FileDescriptor == -1) {
+        free(Allocator);
         return NULL;
     }
     Allocator->FileSize = lseek(Allocator->FileDescriptor, 0, SEEK_END);
-    Allocator->MappedFile = mmap(NULL, Allocator->FileSize, PROT_READ | PROT_WRITE, MAP_SHARED, Allocator->FileDescriptor, 0);
-    if (Allocator->MappedFile == MAP_FAILED) {
+    const bool IsNewFile = Allocator->FileSize == 0;
+    if (IsNewFile) {
+        if (ftruncate(Allocator->FileDescriptor, INITIAL_FILE_SIZE) == -1) {
+            close(Allocator->FileDescriptor);
+            free(Allocator);
+            return NULL;
+        }
+        Allocator->FileSize = INITIAL_FILE_SIZE;
+    }
+    if (!mapAllocatorFile(Allocator)) {
         close(Allocator->FileDescriptor);
         free(Allocator);
         return NULL;
     }
-    uint64_t check_ptr;
-    int ReadResult = fread(&check_ptr, 1, 1, Allocator->MappedFile);
-    if (ReadResult != 1) {
-        Allocator->FileSize = lseek(Allocator->FileDescriptor, 0, SEEK_END);
+    struct Superblock Superblock = {0};
+    if (!IsNewFile && Allocator->FileSize >= sizeof(Superblock)) {
+        fetchSuperblock(Allocator, &Superblock);
+    }
+    // A zeroed superblock is left by a crash between ftruncate and the first initialisation
+    if (IsNewFile || (Allocator->FileSize >= INITIAL_FILE_SIZE && Superblock.Magic == 0)) {
         initEmptyFile(Allocator);
+    } else {
+        if (Superblock.Magic != SUPERBLOCK_MAGIC || Superblock.FormatVersion != FILE_FORMAT_VERSION) {
+            munmap(Allocator->MappedFile, Allocator->ReservedSize);
+            close(Allocator->FileDescriptor);
+            free(Allocator);
+            return NULL;
+        }
+        if (!Superblock.CleanShutdown || Superblock.FileSize != Allocator->FileSize) {
+            recoverAllocatorState(Allocator);
+        }
+    }
+    markCleanShutdown(Allocator, false);
+    return Allocator;
+}
+
+// The allocator state of a file that was not shut down cleanly is recovered in
+// the private mapping only. Allocations must not grow a read-only file.
+struct FileAllocator *openFileAllocatorReadOnly(char *FileName) {
+    struct FileAllocator *const Allocator = malloc(sizeof(struct FileAllocator));
+    Allocator->FileDescriptor = open(FileName, O_RDONLY);
+    Allocator->ReadOnly = true;
+    if (Allocator->FileDescriptor == -1) {
+        free(Allocator);
+        return NULL;
+    }
+    Allocator->FileSize = lseek(Allocator->FileDescriptor, 0, SEEK_END);
+    struct Superblock Superblock = {0};
+    if (Allocator->FileSize < sizeof(Superblock) || !mapAllocatorFile(Allocator)) {
+        close(Allocator->FileDescriptor);
+        free(Allocator);
+        return NULL;
+    }
+    fetchSuperblock(Allocator, &Superblock);
+    if (Superblock.Magic != SUPERBLOCK_MAGIC || Superblock.FormatVersion != FILE_FORMAT_VERSION) {
+        munmap(Allocator->MappedFile, Allocator->ReservedSize);
+        close(Allocator->FileDescriptor);
+        free(Allocator);
+        return NULL;
+    }
+    if (!Superblock.CleanShutdown || Superblock.FileSize != Allocator->FileSize) {
+        recoverAllocatorState(Allocator);
     }
-    mergeAllPossible(Allocator);
     return Allocator;
 }
 
 void shutdownFileAllocator(struct FileAllocator *Allocator) {
-    munmap(Allocator->MappedFile, Allocator->FileSize);
+    if (!Allocator->ReadOnly) {
+        markCleanShutdown(Allocator, true);
+    }
+    munmap(Allocator->MappedFile, Allocator->ReservedSize);
     close(Allocator->FileDescriptor);
     free(Allocator);
 }
@@ -136,17 +511,26 @@ static bool blockSplittable(struct BlockHeader *Header, const size_t DataSize) {
            Header->FullSize >= DataSize + 2 * sizeof(struct BlockHeader) + BLOCK_MIN_CAPACITY;
 }
 
+// The block at BlockOffset must already be unlinked from its free list, the
+// cut-off tail goes back to the free lists.
 static void splitIfTooBig(const struct FileAllocator *const Allocator, const size_t BlockOffset,
                           const size_t DataSize) {
     struct BlockHeader OldHeader;
     memcpy(&OldHeader, (char *) Allocator->MappedFile + BlockOffset, sizeof(OldHeader));
     if (blockSplittable(&OldHeader, DataSize)) {
+        const size_t TailOffset = BlockOffset + DataSize + sizeof(struct BlockHeader);
         blockInit(Allocator, BlockOffset, DataSize + sizeof(struct BlockHeader),
-                  getOptionalOffset(BlockOffset + DataSize + sizeof(struct BlockHeader)),
-                  OldHeader.PrevBlockOffset);
-        blockInit(Allocator, BlockOffset + DataSize + sizeof(struct BlockHeader),
+                  getOptionalOffset(TailOffset), OldHeader.PrevBlockOffset);
+        blockInit(Allocator, TailOffset,
                   OldHeader.FullSize - DataSize - sizeof(struct BlockHeader),
                   OldHeader.NextBlockOffset, getOptionalOffset(BlockOffset));
+        if (OldHeader.NextBlockOffset.HasValue) {
+            setPrevBlockOffset(Allocator, OldHeader.NextBlockOffset.Offset,
+                               getOptionalOffset(TailOffset));
+        } else {
+            setLastBlockOffset(Allocator, TailOffset);
+        }
+        pushFreeBlock(Allocator, TailOffset);
     }
 }
 
@@ -155,32 +539,33 @@ struct SearchResult {
     bool Found;
 };
 
-// Returns the offset of the first block that is not occupied and has enough
-// space for the data If no such block is found, returns the offset of the last
-// block
+// Looks for a free block with enough space for the data. The size class of
+// the request is searched first-fit, any block from a bigger class fits, so
+// only the heads of those lists are checked.
 static struct SearchResult findBlock(const struct FileAllocator *const Allocator,
                                      const size_t DataSize) {
     struct SearchResult Result = {0, false};
-    struct BlockHeader Header;
-    size_t CurrentOffset = FIRST_BLOCK_OFFSET;
-    memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset, sizeof(Header));
-    do {
-        if (!Header.IsOccupied) {
-            mergeWhilePossible(Allocator, CurrentOffset);
-            memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset, sizeof(Header));
-        }
-        if (!Header.IsOccupied && Header.DataSize >= DataSize) {
-            Result.Offset = CurrentOffset;
+    const size_t RequestClass = getSizeClass(DataSize);
+    struct OptionalOffset CurrentOffset = getFreeListHead(Allocator, RequestClass);
+    while (CurrentOffset.HasValue) {
+        struct BlockHeader Header;
+        memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset.Offset, sizeof(Header));
+        if (Header.DataSize >= DataSize) {
+            Result.Offset = CurrentOffset.Offset;
             Result.Found = true;
-            break;
+            return Result;
         }
-        if (Header.NextBlockOffset.HasValue) {
-            CurrentOffset = Header.NextBlockOffset.Offset;
+        struct FreeBlockLinks Links;
+        fetchFreeLinks(Allocator, CurrentOffset.Offset, &Links);
+        CurrentOffset = Links.NextFree;
+    }
+    for (size_t Class = RequestClass + 1; Class < FREE_LIST_CLASSES; ++Class) {
+        CurrentOffset = getFreeListHead(Allocator, Class);
+        if (CurrentOffset.HasValue) {
+            Result.Offset = CurrentOffset.Offset;
+            Result.Found = true;
+            return Result;
         }
-        memcpy(&Header, (char *) Allocator->MappedFile + CurrentOffset, sizeof(Header));
-    } while (Header.NextBlockOffset.HasValue);
-    if (!Result.Found) {
-        Result.Offset = CurrentOffset;
     }
     return Result;
 }
@@ -197,10 +582,13 @@ struct AddrInfo allocate(struct FileAllocator *const Allocator, const size_t Dat
     }
     const size_t RealDataSize = getRealDataSize(DataSize);
     struct SearchResult SearchResult = findBlock(Allocator, RealDataSize);
-    while (!SearchResult.Found) {
-        extendFile(Allocator, getOptionalOffset(SearchResult.Offset));
+    if (!SearchResult.Found) {
+        if (!extendFile(Allocator, RealDataSize)) {
+            return NULL_FULL_ADDR;
+        }
         SearchResult = findBlock(Allocator, RealDataSize);
     }
+    unlinkFreeBlock(Allocator, SearchResult.Offset);
     splitIfTooBig(Allocator, SearchResult.Offset, RealDataSize);
     struct BlockHeader Header;
     memcpy(&Header, (char *) Allocator->MappedFile + SearchResult.Offset, sizeof(Header));
@@ -219,7 +607,7 @@ void deallocate(const struct FileAllocator *const Allocator,
     memcpy(&Header, (char *) Allocator->MappedFile + BlockOffset, sizeof(Header));
     Header.IsOccupied = false;
     memcpy((char *) Allocator->MappedFile + BlockOffset, &Header, sizeof(Header));
-    mergeWhilePossible(Allocator, BlockOffset);
+    releaseBlock(Allocator, BlockOffset);
 }
 
 static void printHeaderInfo(const struct FileAllocator *const Allocator,
@@ -275,6 +663,11 @@ int storeData(const struct FileAllocator *const Allocator, const struct AddrInfo
     return Size;
 }
 
+const void *getDataPointer(const struct FileAllocator *const Allocator,
+                           const struct AddrInfo Addr) {
+    return (const char *) Allocator->MappedFile + Addr.BlockOffset + Addr.DataOffset;
+}
+
 size_t getFileSize(const struct FileAllocator *const Allocator) {
     return Allocator->FileSize;
 }
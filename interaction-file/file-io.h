@@ -36,6 +36,7 @@ struct Block {
 
 
 struct FileAllocator *initFileAllocator(char *FileName);
+struct FileAllocator *openFileAllocatorReadOnly(char *FileName);
 void shutdownFileAllocator(struct FileAllocator *allocator);
 void dropFileAllocator(struct FileAllocator *allocator);
 struct AddrInfo allocate(struct FileAllocator *const allocator, size_t Size);
@@ -45,6 +46,10 @@ int fetchData(const struct FileAllocator *const allocator, const struct AddrInfo
               const size_t Size, void *const Buffer);
 int storeData(const struct FileAllocator *const allocator, const struct AddrInfo Addr,
               const size_t Size, const void *const Buffer);
+// Address of the data in the mapped file. It stays valid while the file grows
+// unless it outgrows FILE_MAPPING_RESERVE.
+const void *getDataPointer(const struct FileAllocator *const allocator, const struct AddrInfo Addr);
+size_t getFileSize(const struct FileAllocator *const allocator);
 
 
 #endif //LLP_LAB1_FILE_IO_H
@@ -0,0 +1,78 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <stdalign.h>
+
+#include "../configs/config.h"
+
+struct ArenaChunk {
+    struct ArenaChunk *Next;
+    size_t Capacity;
+    max_align_t Data[];
+};
+
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+struct Arena *arenaCreate(void) {
+    struct Arena *Arena = malloc(sizeof(struct Arena));
+    Arena->First = NULL;
+    Arena->Current = NULL;
+    Arena->Used = 0;
+    Arena->ChunkAllocations = 0;
+    return Arena;
+}
+
+void arenaDestroy(struct Arena *Arena) {
+    struct ArenaChunk *Chunk = Arena->First;
+    while (Chunk != NULL) {
+        struct ArenaChunk *Next = Chunk->Next;
+        free(Chunk);
+        Chunk = Next;
+    }
+    free(Arena);
+}
+
+// Puts a new chunk right after the current one, chunks following it are kept
+// for later use.
+static struct ArenaChunk *insertChunk(struct Arena *Arena, const size_t Size) {
+    size_t Capacity = Arena->Current == NULL ? ARENA_CHUNK_SIZE : Arena->Current->Capacity * 2;
+    while (Capacity < Size) {
+        Capacity *= 2;
+    }
+    struct ArenaChunk *Chunk = malloc(sizeof(struct ArenaChunk) + Capacity);
+    Chunk->Capacity = Capacity;
+    Arena->ChunkAllocations++;
+    if (Arena->Current == NULL) {
+        Chunk->Next = Arena->First;
+        Arena->First = Chunk;
+    } else {
+        Chunk->Next = Arena->Current->Next;
+        Arena->Current->Next = Chunk;
+    }
+    return Chunk;
+}
+
+void *arenaAlloc(struct Arena *Arena, size_t Size) {
+    Size = (Size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    if (Arena->Current == NULL || Arena->Current->Capacity - Arena->Used < Size) {
+        struct ArenaChunk *Next = Arena->Current == NULL ? Arena->First : Arena->Current->Next;
+        if (Next == NULL || Next->Capacity < Size) {
+            Next = insertChunk(Arena, Size);
+        }
+        Arena->Current = Next;
+        Arena->Used = 0;
+    }
+    void *Result = (char *) Arena->Current->Data + Arena->Used;
+    Arena->Used += Size;
+    return Result;
+}
+
+struct ArenaMark arenaMark(const struct Arena *Arena) {
+    struct ArenaMark Mark = {Arena->Current, Arena->Used};
+    return Mark;
+}
+
+void arenaRelease(struct Arena *Arena, const struct ArenaMark Mark) {
+    Arena->Current = Mark.Chunk;
+    Arena->Used = Mark.Used;
+}
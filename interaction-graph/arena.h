@@ -0,0 +1,34 @@
+#ifndef LLP_LAB1_ARENA_H
+#define LLP_LAB1_ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator for temporary buffers of a single request. Memory is taken in
+// chunks that are kept after release, so once the arena has grown to the size
+// a request needs, serving it does not call malloc. Buffers are released in
+// stack order by going back to a mark taken before allocating them.
+
+struct ArenaChunk;
+
+struct Arena {
+    struct ArenaChunk *First;
+    struct ArenaChunk *Current;
+    size_t Used;
+    // Chunks taken with malloc over the life of the arena
+    size_t ChunkAllocations;
+};
+
+struct ArenaMark {
+    struct ArenaChunk *Chunk;
+    size_t Used;
+};
+
+struct Arena *arenaCreate(void);
+void arenaDestroy(struct Arena *Arena);
+// The result is aligned for any type and lives until the arena goes back to a
+// mark taken before the call.
+void *arenaAlloc(struct Arena *Arena, size_t Size);
+struct ArenaMark arenaMark(const struct Arena *Arena);
+void arenaRelease(struct Arena *Arena, struct ArenaMark Mark);
+
+#endif //LLP_LAB1_ARENA_H
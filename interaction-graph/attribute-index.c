@@ -0,0 +1,624 @@
+#include "attribute-index.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "arena.h"
+#include "bitmap.h"
+
+enum AttributeIndexType { BTREE_INDEX, HASH_INDEX, BITMAP_INDEX };
+
+// Root of a B+tree or hash index is its root page, root of a bitmap index is a
+// pair of bitmaps holding ids of the nodes with false and true values.
+struct AttributeIndex {
+    size_t AttributeId;
+    enum DATA_TYPE AttributeType;
+    enum AttributeIndexType Type;
+    struct AddrInfo Root;
+    struct AddrInfo Next;
+};
+
+// INT and FLOAT values are mapped to unsigned keys ordered the same way as the
+// values, STRING values are replaced by their hash, so every index type shares
+// the tree code. Equal values are ordered by node id, which makes every key
+// unique.
+struct BTreeKey {
+    uint64_t Value;
+    size_t NodeId;
+};
+
+// A page has room for one key more than BTREE_PAGE_KEYS, it is used between an
+// insertion and the split it causes. Keys of the subtree Children[i] are not
+// less than Keys[i - 1] and less than Keys[i]. Pages are not merged when keys
+// are removed, an empty leaf stays in the tree.
+struct BTreePage {
+    bool IsLeaf;
+    size_t KeyCounter;
+    struct AddrInfo NextLeaf;
+    struct BTreeKey Keys[BTREE_PAGE_KEYS + 1];
+    struct AddrInfo Children[BTREE_PAGE_KEYS + 2];
+};
+
+// Range filters never reject NaN, so every NaN gets the greatest key and is
+// added to the result of any FLOAT range lookup.
+#define NAN_KEY UINT32_MAX
+
+static uint32_t getIntKey(int32_t Value) { return (uint32_t) Value ^ 0x80000000u; }
+
+static uint32_t getFloatKey(float Value) {
+    if (isnan(Value)) {
+        return NAN_KEY;
+    }
+    if (Value == 0.0f) {
+        Value = 0.0f;
+    }
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    return (Bits & 0x80000000u) ? ~Bits : Bits | 0x80000000u;
+}
+
+static uint64_t hashBytes(const char *const Bytes, const size_t Length) {
+    uint64_t Hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < Length; ++i) {
+        Hash = (Hash ^ (unsigned char) Bytes[i]) * 0x100000001b3ull;
+    }
+    return Hash;
+}
+
+static uint64_t getStringKey(const struct StorageController *const Controller,
+                             const struct MyString String) {
+    if (String.Length <= SMALL_STRING_LIMIT) {
+        return hashBytes(String.Data.InlinedData, String.Length);
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    char *Bytes = arenaAlloc(Controller->Scratch, String.Length);
+    fetchData(Controller->Allocator, unpackAddr(String.Data.DataPtr), String.Length,
+              Bytes);
+    const uint64_t Hash = hashBytes(Bytes, String.Length);
+    arenaRelease(Controller->Scratch, Mark);
+    return Hash;
+}
+
+static int compareKeys(const struct BTreeKey *const Key1, const struct BTreeKey *const Key2) {
+    if (Key1->Value != Key2->Value) {
+        return Key1->Value < Key2->Value ? -1 : 1;
+    }
+    if (Key1->NodeId != Key2->NodeId) {
+        return Key1->NodeId < Key2->NodeId ? -1 : 1;
+    }
+    return 0;
+}
+
+// Number of keys in the page less than Key, or not greater than Key if
+// CountEqual is set.
+static size_t countKeysBefore(const struct BTreePage *const Page,
+                              const struct BTreeKey *const Key, const bool CountEqual) {
+    size_t Left = 0;
+    size_t Right = Page->KeyCounter;
+    while (Left < Right) {
+        const size_t Middle = (Left + Right) / 2;
+        const int Cmp = compareKeys(&(Page->Keys[Middle]), Key);
+        if (Cmp < 0 || (CountEqual && Cmp == 0)) {
+            Left = Middle + 1;
+        } else {
+            Right = Middle;
+        }
+    }
+    return Left;
+}
+
+static struct AddrInfo allocatePage(const struct StorageController *const Controller,
+                                    const struct BTreePage *const Page) {
+    const struct AddrInfo PageAddr = allocate(Controller->Allocator, sizeof(*Page));
+    storeData(Controller->Allocator, PageAddr, sizeof(*Page), Page);
+    return PageAddr;
+}
+
+// Inserts Key into the subtree under PageAddr. Returns true if the page had to
+// be split, the new right page and the key separating it are returned then.
+static bool btreeInsert(const struct StorageController *const Controller,
+                        const struct AddrInfo PageAddr, const struct BTreeKey *const Key,
+                        struct BTreeKey *const Separator, struct AddrInfo *const RightAddr) {
+    struct BTreePage Page;
+    fetchData(Controller->Allocator, PageAddr, sizeof(Page), &Page);
+    const size_t Pos = countKeysBefore(&Page, Key, true);
+    if (Page.IsLeaf) {
+        memmove(Page.Keys + Pos + 1, Page.Keys + Pos,
+                (Page.KeyCounter - Pos) * sizeof(struct BTreeKey));
+        Page.Keys[Pos] = *Key;
+    } else {
+        struct BTreeKey ChildSeparator;
+        struct AddrInfo ChildRightAddr;
+        if (!btreeInsert(Controller, Page.Children[Pos], Key, &ChildSeparator,
+                         &ChildRightAddr)) {
+            return false;
+        }
+        memmove(Page.Keys + Pos + 1, Page.Keys + Pos,
+                (Page.KeyCounter - Pos) * sizeof(struct BTreeKey));
+        memmove(Page.Children + Pos + 2, Page.Children + Pos + 1,
+                (Page.KeyCounter - Pos) * sizeof(struct AddrInfo));
+        Page.Keys[Pos] = ChildSeparator;
+        Page.Children[Pos + 1] = ChildRightAddr;
+    }
+    Page.KeyCounter++;
+    if (Page.KeyCounter <= BTREE_PAGE_KEYS) {
+        storeData(Controller->Allocator, PageAddr, sizeof(Page), &Page);
+        return false;
+    }
+    struct BTreePage Right = {.IsLeaf = Page.IsLeaf, .NextLeaf = NULL_FULL_ADDR};
+    const size_t Middle = Page.KeyCounter / 2;
+    if (Page.IsLeaf) {
+        Right.KeyCounter = Page.KeyCounter - Middle;
+        memcpy(Right.Keys, Page.Keys + Middle, Right.KeyCounter * sizeof(struct BTreeKey));
+        Right.NextLeaf = Page.NextLeaf;
+        *Separator = Right.Keys[0];
+    } else {
+        Right.KeyCounter = Page.KeyCounter - Middle - 1;
+        memcpy(Right.Keys, Page.Keys + Middle + 1, Right.KeyCounter * sizeof(struct BTreeKey));
+        memcpy(Right.Children, Page.Children + Middle + 1,
+               (Right.KeyCounter + 1) * sizeof(struct AddrInfo));
+        *Separator = Page.Keys[Middle];
+    }
+    Page.KeyCounter = Middle;
+    *RightAddr = allocatePage(Controller, &Right);
+    if (Page.IsLeaf) {
+        Page.NextLeaf = *RightAddr;
+    }
+    storeData(Controller->Allocator, PageAddr, sizeof(Page), &Page);
+    return true;
+}
+
+static struct AddrInfo findLeaf(const struct StorageController *const Controller,
+                                struct AddrInfo PageAddr, const struct BTreeKey *const Key,
+                                struct BTreePage *const Page) {
+    fetchData(Controller->Allocator, PageAddr, sizeof(*Page), Page);
+    while (!Page->IsLeaf) {
+        PageAddr = Page->Children[countKeysBefore(Page, Key, true)];
+        fetchData(Controller->Allocator, PageAddr, sizeof(*Page), Page);
+    }
+    return PageAddr;
+}
+
+static void btreeRemove(const struct StorageController *const Controller,
+                        const struct AddrInfo RootAddr, const struct BTreeKey *const Key) {
+    struct BTreePage Page;
+    const struct AddrInfo LeafAddr = findLeaf(Controller, RootAddr, Key, &Page);
+    const size_t Pos = countKeysBefore(&Page, Key, false);
+    if (Pos == Page.KeyCounter || compareKeys(&(Page.Keys[Pos]), Key) != 0) {
+        return;
+    }
+    memmove(Page.Keys + Pos, Page.Keys + Pos + 1,
+            (Page.KeyCounter - Pos - 1) * sizeof(struct BTreeKey));
+    Page.KeyCounter--;
+    storeData(Controller->Allocator, LeafAddr, sizeof(Page), &Page);
+}
+
+struct NodeIdList {
+    size_t *NodeIds;
+    size_t Cnt;
+    size_t Capacity;
+};
+
+static void appendNodeId(struct NodeIdList *const List, const size_t NodeId) {
+    if (List->Cnt == List->Capacity) {
+        List->Capacity = List->Capacity == 0 ? 64 : List->Capacity * 2;
+        List->NodeIds = realloc(List->NodeIds, List->Capacity * sizeof(size_t));
+    }
+    List->NodeIds[List->Cnt++] = NodeId;
+}
+
+// Returns the number of keys in the range but not more than Limit, their node
+// ids are appended to Result if it is not NULL.
+static size_t btreeCollectRange(const struct StorageController *const Controller,
+                                const struct AddrInfo RootAddr, const uint64_t Min,
+                                const uint64_t Max, const size_t Limit,
+                                struct NodeIdList *const Result) {
+    const struct BTreeKey Lower = {.Value = Min, .NodeId = 0};
+    struct BTreePage Page;
+    findLeaf(Controller, RootAddr, &Lower, &Page);
+    size_t Pos = countKeysBefore(&Page, &Lower, false);
+    size_t Cnt = 0;
+    while (true) {
+        for (; Pos < Page.KeyCounter; ++Pos) {
+            if (Page.Keys[Pos].Value > Max || Cnt == Limit) {
+                return Cnt;
+            }
+            if (Result != NULL) {
+                appendNodeId(Result, Page.Keys[Pos].NodeId);
+            }
+            Cnt++;
+        }
+        if (!Page.NextLeaf.HasValue) {
+            return Cnt;
+        }
+        fetchData(Controller->Allocator, Page.NextLeaf, sizeof(Page), &Page);
+        Pos = 0;
+    }
+}
+
+static void btreeDrop(const struct StorageController *const Controller,
+                      const struct AddrInfo PageAddr) {
+    struct BTreePage Page;
+    fetchData(Controller->Allocator, PageAddr, sizeof(Page), &Page);
+    if (!Page.IsLeaf) {
+        for (size_t i = 0; i <= Page.KeyCounter; ++i) {
+            btreeDrop(Controller, Page.Children[i]);
+        }
+    }
+    deallocate(Controller->Allocator, PageAddr);
+}
+
+static const struct Attribute *findAttribute(const struct Attribute *const Attributes,
+                                             const size_t AttributesNumber,
+                                             const size_t AttributeId) {
+    for (size_t i = 0; i < AttributesNumber; ++i) {
+        if (Attributes[i].Id == AttributeId) {
+            return &(Attributes[i]);
+        }
+    }
+    return NULL;
+}
+
+static bool getAttributeKey(const struct StorageController *const Controller,
+                            const struct AttributeIndex *const Index,
+                            const struct Attribute *const Attributes,
+                            const size_t AttributesNumber, struct BTreeKey *const Key) {
+    const struct Attribute *const Attribute =
+            findAttribute(Attributes, AttributesNumber, Index->AttributeId);
+    if (Attribute == NULL || Attribute->Type != Index->AttributeType) {
+        return false;
+    }
+    if (Attribute->Type == INT) {
+        Key->Value = getIntKey(Attribute->Value.IntValue);
+    } else if (Attribute->Type == FLOAT) {
+        Key->Value = getFloatKey(Attribute->Value.FloatValue);
+    } else if (Attribute->Type == BOOL) {
+        Key->Value = Attribute->Value.BoolValue ? 1 : 0;
+    } else {
+        Key->Value = getStringKey(Controller, Attribute->Value.StringValue);
+    }
+    return true;
+}
+
+static struct AddrInfo getValueBitmapAddr(const struct AddrInfo RootAddr, const uint64_t Value) {
+    return getOptionalFullAddr(RootAddr.BlockOffset,
+                               RootAddr.DataOffset + Value * sizeof(struct Bitmap));
+}
+
+static void addKey(const struct StorageController *const Controller,
+                   const struct AddrInfo IndexAddr, struct AttributeIndex *const Index,
+                   const struct BTreeKey *const Key) {
+    if (Index->Type == BITMAP_INDEX) {
+        bitmapAdd(Controller, getValueBitmapAddr(Index->Root, Key->Value), Key->NodeId);
+        return;
+    }
+    struct BTreeKey Separator;
+    struct AddrInfo RightAddr;
+    if (!btreeInsert(Controller, Index->Root, Key, &Separator, &RightAddr)) {
+        return;
+    }
+    struct BTreePage NewRoot = {.IsLeaf = false, .KeyCounter = 1, .NextLeaf = NULL_FULL_ADDR};
+    NewRoot.Keys[0] = Separator;
+    NewRoot.Children[0] = Index->Root;
+    NewRoot.Children[1] = RightAddr;
+    Index->Root = allocatePage(Controller, &NewRoot);
+    storeData(Controller->Allocator, IndexAddr, sizeof(*Index), Index);
+}
+
+static void removeKey(const struct StorageController *const Controller,
+                      const struct AttributeIndex *const Index, const struct BTreeKey *const Key) {
+    if (Index->Type == BITMAP_INDEX) {
+        bitmapRemove(Controller, getValueBitmapAddr(Index->Root, Key->Value), Key->NodeId);
+        return;
+    }
+    btreeRemove(Controller, Index->Root, Key);
+}
+
+static struct AddrInfo findIndex(const struct StorageController *const Controller,
+                                 const struct Graph *const Graph, const size_t AttributeId,
+                                 struct AttributeIndex *const Index) {
+    struct AddrInfo IndexAddr = Graph->AttributeIndexes;
+    while (IndexAddr.HasValue) {
+        fetchData(Controller->Allocator, IndexAddr, sizeof(*Index), Index);
+        if (Index->AttributeId == AttributeId) {
+            return IndexAddr;
+        }
+        IndexAddr = Index->Next;
+    }
+    return NULL_FULL_ADDR;
+}
+
+struct AddrInfo attributeIndexCreate(const struct StorageController *const Controller,
+                                     struct Graph *const Graph, const size_t AttributeId,
+                                     const enum DATA_TYPE AttributeType) {
+    struct AttributeIndex Index;
+    if (findIndex(Controller, Graph, AttributeId, &Index).HasValue) {
+        return NULL_FULL_ADDR;
+    }
+    Index.AttributeId = AttributeId;
+    Index.AttributeType = AttributeType;
+    if (AttributeType == BOOL) {
+        Index.Type = BITMAP_INDEX;
+        Index.Root = allocate(Controller->Allocator, 2 * sizeof(struct Bitmap));
+        bitmapInit(Controller, getValueBitmapAddr(Index.Root, 0));
+        bitmapInit(Controller, getValueBitmapAddr(Index.Root, 1));
+    } else {
+        const struct BTreePage Root = {
+                .IsLeaf = true, .KeyCounter = 0, .NextLeaf = NULL_FULL_ADDR};
+        Index.Type = AttributeType == STRING ? HASH_INDEX : BTREE_INDEX;
+        Index.Root = allocatePage(Controller, &Root);
+    }
+    Index.Next = Graph->AttributeIndexes;
+    const struct AddrInfo IndexAddr = allocate(Controller->Allocator, sizeof(Index));
+    storeData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+    Graph->AttributeIndexes = IndexAddr;
+    return IndexAddr;
+}
+
+void attributeIndexAddNode(const struct StorageController *const Controller,
+                           const struct AddrInfo IndexAddr, const size_t NodeId,
+                           const struct Attribute *const Attributes,
+                           const size_t AttributesNumber) {
+    struct AttributeIndex Index;
+    fetchData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+    struct BTreeKey Key = {.NodeId = NodeId};
+    if (getAttributeKey(Controller, &Index, Attributes, AttributesNumber, &Key)) {
+        addKey(Controller, IndexAddr, &Index, &Key);
+    }
+}
+
+void attributeIndexesAddNode(const struct StorageController *const Controller,
+                             const struct Graph *const Graph, const size_t NodeId,
+                             const struct Attribute *const Attributes) {
+    struct AddrInfo IndexAddr = Graph->AttributeIndexes;
+    while (IndexAddr.HasValue) {
+        struct AttributeIndex Index;
+        fetchData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+        struct BTreeKey Key = {.NodeId = NodeId};
+        if (getAttributeKey(Controller, &Index, Attributes, Graph->AttributeCounter, &Key)) {
+            addKey(Controller, IndexAddr, &Index, &Key);
+        }
+        IndexAddr = Index.Next;
+    }
+}
+
+void attributeIndexesRemoveNode(const struct StorageController *const Controller,
+                                const struct Graph *const Graph, const size_t NodeId,
+                                const struct Attribute *const Attributes) {
+    struct AddrInfo IndexAddr = Graph->AttributeIndexes;
+    while (IndexAddr.HasValue) {
+        struct AttributeIndex Index;
+        fetchData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+        struct BTreeKey Key = {.NodeId = NodeId};
+        if (getAttributeKey(Controller, &Index, Attributes, Graph->AttributeCounter, &Key)) {
+            removeKey(Controller, &Index, &Key);
+        }
+        IndexAddr = Index.Next;
+    }
+}
+
+void attributeIndexesUpdateNode(const struct StorageController *const Controller,
+                                const struct Graph *const Graph, const size_t NodeId,
+                                const struct Attribute *const OldAttributes,
+                                const struct Attribute *const NewAttributes) {
+    struct AddrInfo IndexAddr = Graph->AttributeIndexes;
+    while (IndexAddr.HasValue) {
+        struct AttributeIndex Index;
+        fetchData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+        struct BTreeKey OldKey = {.NodeId = NodeId};
+        struct BTreeKey NewKey = {.NodeId = NodeId};
+        const bool HasOldKey =
+                getAttributeKey(Controller, &Index, OldAttributes, Graph->AttributeCounter,
+                                &OldKey);
+        const bool HasNewKey =
+                getAttributeKey(Controller, &Index, NewAttributes, Graph->AttributeCounter,
+                                &NewKey);
+        if (HasOldKey != HasNewKey || compareKeys(&OldKey, &NewKey) != 0) {
+            if (HasOldKey) {
+                removeKey(Controller, &Index, &OldKey);
+            }
+            if (HasNewKey) {
+                addKey(Controller, IndexAddr, &Index, &NewKey);
+            }
+        }
+        IndexAddr = Index.Next;
+    }
+}
+
+static enum DATA_TYPE getFilterDataType(const struct AttributeFilter *const Filter) {
+    if (Filter->Type == INT_FILTER) {
+        return INT;
+    }
+    if (Filter->Type == FLOAT_FILTER) {
+        return FLOAT;
+    }
+    if (Filter->Type == BOOL_FILTER) {
+        return BOOL;
+    }
+    return STRING;
+}
+
+// How well an index lookup narrows the filter down: 0 if the filter can not
+// use an index at all, 1 for a range, 2 for an equality.
+static int getFilterSelectivity(const struct AttributeFilter *const Filter) {
+    if (Filter->Type == INT_FILTER) {
+        return Filter->Data.Int.HasMin || Filter->Data.Int.HasMax;
+    }
+    if (Filter->Type == FLOAT_FILTER) {
+        return (Filter->Data.Float.HasMin && !isnan(Filter->Data.Float.Min)) ||
+               (Filter->Data.Float.HasMax && !isnan(Filter->Data.Float.Max));
+    }
+    if (Filter->Type == STRING_FILTER && Filter->Data.String.Type == STRING_EQUAL) {
+        return 2;
+    }
+    return 0;
+}
+
+static void getFilterKeyRange(const struct AttributeFilter *const Filter, uint64_t *const Min,
+                              uint64_t *const Max) {
+    *Min = 0;
+    *Max = UINT64_MAX;
+    if (Filter->Type == INT_FILTER) {
+        if (Filter->Data.Int.HasMin) {
+            *Min = getIntKey(Filter->Data.Int.Min);
+        }
+        if (Filter->Data.Int.HasMax) {
+            *Max = getIntKey(Filter->Data.Int.Max);
+        }
+        return;
+    }
+    if (Filter->Type == FLOAT_FILTER) {
+        if (Filter->Data.Float.HasMin && !isnan(Filter->Data.Float.Min)) {
+            *Min = getFloatKey(Filter->Data.Float.Min);
+        }
+        if (Filter->Data.Float.HasMax && !isnan(Filter->Data.Float.Max)) {
+            *Max = getFloatKey(Filter->Data.Float.Max);
+        }
+        return;
+    }
+    const char *const Expected = Filter->Data.String.Data.StringEqual;
+    *Min = *Max = hashBytes(Expected, strlen(Expected) + 1);
+}
+
+// Indexes picked for a filter chain: the one serving the most selective non
+// BOOL filter and the bitmaps of every indexed BOOL filter.
+struct IndexChoice {
+    const struct AttributeFilter *Chosen;
+    struct AttributeIndex ChosenIndex;
+    // Scratch taken for Bitmaps
+    struct ArenaMark Mark;
+    struct AddrInfo *Bitmaps;
+    size_t BitmapsCnt;
+    size_t FiltersCnt;
+};
+
+static bool chooseIndexes(const struct StorageController *const Controller,
+                          const struct Graph *const Graph,
+                          const struct AttributeFilter *FilterChain,
+                          struct IndexChoice *const Choice) {
+    Choice->Chosen = NULL;
+    Choice->BitmapsCnt = 0;
+    Choice->FiltersCnt = 0;
+    int ChosenSelectivity = 0;
+    for (const struct AttributeFilter *Filter = FilterChain; Filter != NULL;
+         Filter = Filter->Next) {
+        Choice->FiltersCnt++;
+    }
+    Choice->Mark = arenaMark(Controller->Scratch);
+    Choice->Bitmaps = arenaAlloc(Controller->Scratch, Choice->FiltersCnt * sizeof(struct AddrInfo));
+    for (const struct AttributeFilter *Filter = FilterChain; Filter != NULL;
+         Filter = Filter->Next) {
+        const int Selectivity = getFilterSelectivity(Filter);
+        if (Filter->Type != BOOL_FILTER && Selectivity <= ChosenSelectivity) {
+            continue;
+        }
+        struct AttributeIndex Index;
+        if (!findIndex(Controller, Graph, Filter->AttributeId, &Index).HasValue ||
+            Index.AttributeType != getFilterDataType(Filter)) {
+            continue;
+        }
+        if (Filter->Type == BOOL_FILTER) {
+            Choice->Bitmaps[Choice->BitmapsCnt++] =
+                    getValueBitmapAddr(Index.Root, Filter->Data.Bool.Value);
+            continue;
+        }
+        Choice->Chosen = Filter;
+        ChosenSelectivity = Selectivity;
+        Choice->ChosenIndex = Index;
+    }
+    if (Choice->Chosen == NULL && Choice->BitmapsCnt == 0) {
+        arenaRelease(Controller->Scratch, Choice->Mark);
+        return false;
+    }
+    return true;
+}
+
+// True when the ids selected by the indexes match the whole chain.
+static bool isChoiceExact(const struct IndexChoice *const Choice) {
+    if (Choice->Chosen == NULL) {
+        return Choice->BitmapsCnt == Choice->FiltersCnt;
+    }
+    return Choice->ChosenIndex.Type == BTREE_INDEX && Choice->FiltersCnt == 1;
+}
+
+// Returns the number of selected ids and stores them to NodeIds if it is not
+// NULL. Ranges are not followed past Limit ids. Releases the bitmaps of the
+// choice.
+static size_t collectChosenIds(const struct StorageController *const Controller,
+                               struct IndexChoice *const Choice, const size_t Limit,
+                               size_t **NodeIds) {
+    if (Choice->Chosen == NULL) {
+        const size_t Cnt =
+                bitmapIntersect(Controller, Choice->Bitmaps, Choice->BitmapsCnt, NodeIds);
+        arenaRelease(Controller->Scratch, Choice->Mark);
+        return Cnt;
+    }
+    arenaRelease(Controller->Scratch, Choice->Mark);
+    struct NodeIdList Result = {.NodeIds = NULL, .Cnt = 0, .Capacity = 0};
+    struct NodeIdList *const List = NodeIds != NULL ? &Result : NULL;
+    const struct AddrInfo Root = Choice->ChosenIndex.Root;
+    size_t Cnt = 0;
+    uint64_t Min;
+    uint64_t Max;
+    getFilterKeyRange(Choice->Chosen, &Min, &Max);
+    if (Min <= Max) {
+        Cnt += btreeCollectRange(Controller, Root, Min, Max, Limit, List);
+    }
+    if (Choice->Chosen->Type == FLOAT_FILTER && Max < NAN_KEY) {
+        Cnt += btreeCollectRange(Controller, Root, NAN_KEY, NAN_KEY, Limit - Cnt, List);
+    }
+    if (NodeIds != NULL) {
+        *NodeIds = Result.NodeIds;
+    }
+    return Cnt;
+}
+
+bool attributeIndexesSelect(const struct StorageController *const Controller,
+                            const struct Graph *const Graph,
+                            const struct AttributeFilter *FilterChain, size_t **NodeIds,
+                            size_t *NodeIdsNumber, bool *const Exact) {
+    struct IndexChoice Choice;
+    if (!chooseIndexes(Controller, Graph, FilterChain, &Choice)) {
+        return false;
+    }
+    *Exact = isChoiceExact(&Choice);
+    *NodeIdsNumber = collectChosenIds(Controller, &Choice, SIZE_MAX, NodeIds);
+    return true;
+}
+
+bool attributeIndexesCount(const struct StorageController *const Controller,
+                           const struct Graph *const Graph,
+                           const struct AttributeFilter *FilterChain, const size_t Limit,
+                           size_t *const Count) {
+    struct IndexChoice Choice;
+    if (!chooseIndexes(Controller, Graph, FilterChain, &Choice)) {
+        return false;
+    }
+    if (!isChoiceExact(&Choice)) {
+        arenaRelease(Controller->Scratch, Choice.Mark);
+        return false;
+    }
+    *Count = collectChosenIds(Controller, &Choice, Limit, NULL);
+    return true;
+}
+
+void attributeIndexesDrop(const struct StorageController *const Controller,
+                          struct Graph *const Graph) {
+    struct AddrInfo IndexAddr = Graph->AttributeIndexes;
+    while (IndexAddr.HasValue) {
+        struct AttributeIndex Index;
+        fetchData(Controller->Allocator, IndexAddr, sizeof(Index), &Index);
+        if (Index.Type == BITMAP_INDEX) {
+            bitmapDrop(Controller, getValueBitmapAddr(Index.Root, 0));
+            bitmapDrop(Controller, getValueBitmapAddr(Index.Root, 1));
+            deallocate(Controller->Allocator, Index.Root);
+        } else {
+            btreeDrop(Controller, Index.Root);
+        }
+        deallocate(Controller->Allocator, IndexAddr);
+        IndexAddr = Index.Next;
+    }
+    Graph->AttributeIndexes = NULL_FULL_ADDR;
+}
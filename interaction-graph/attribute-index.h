@@ -0,0 +1,57 @@
+#ifndef LLP_LAB1_ATTRIBUTE_INDEX_H
+#define LLP_LAB1_ATTRIBUTE_INDEX_H
+
+#include "../structures-data/types.h"
+#include "../structures-request/request-structures.h"
+#include "storage-manager.h"
+
+// Secondary indexes over node attribute values. A graph keeps the list of its
+// indexes in Graph.AttributeIndexes. INT and FLOAT attributes are indexed by a
+// B+tree of (value, node id) pairs serving range filters, STRING attributes by
+// (value hash, node id) pairs serving STRING_EQUAL filters, BOOL attributes by
+// bitmaps of node ids intersected for every BOOL filter in the chain. Indexes
+// store node ids instead of node addresses, so moving nodes does not touch
+// them; ids are resolved through the node index.
+
+// Adds an empty index over the attribute to the graph, the caller fills it with
+// attributeIndexAddNode and stores the graph. Returns NULL_FULL_ADDR if the
+// attribute is already indexed or its type can not be indexed.
+struct AddrInfo attributeIndexCreate(const struct StorageController *const Controller,
+                                     struct Graph *const Graph, size_t AttributeId,
+                                     enum DATA_TYPE AttributeType);
+void attributeIndexAddNode(const struct StorageController *const Controller,
+                           struct AddrInfo IndexAddr, size_t NodeId,
+                           const struct Attribute *const Attributes, size_t AttributesNumber);
+
+void attributeIndexesAddNode(const struct StorageController *const Controller,
+                             const struct Graph *const Graph, size_t NodeId,
+                             const struct Attribute *const Attributes);
+void attributeIndexesRemoveNode(const struct StorageController *const Controller,
+                                const struct Graph *const Graph, size_t NodeId,
+                                const struct Attribute *const Attributes);
+void attributeIndexesUpdateNode(const struct StorageController *const Controller,
+                                const struct Graph *const Graph, size_t NodeId,
+                                const struct Attribute *const OldAttributes,
+                                const struct Attribute *const NewAttributes);
+
+// Picks the indexes able to serve filters of the chain and returns the ids of
+// the nodes they select. Exact is set when the ids match the whole chain,
+// otherwise the candidates still have to be checked. Returns false when no
+// index applies.
+bool attributeIndexesSelect(const struct StorageController *const Controller,
+                            const struct Graph *const Graph,
+                            const struct AttributeFilter *FilterChain, size_t **NodeIds,
+                            size_t *NodeIdsNumber, bool *const Exact);
+
+// Counts the nodes matching the whole chain without collecting their ids, a
+// B+tree range stops being counted at Limit. Returns false when the indexes
+// can not answer the chain exactly.
+bool attributeIndexesCount(const struct StorageController *const Controller,
+                           const struct Graph *const Graph,
+                           const struct AttributeFilter *FilterChain, size_t Limit,
+                           size_t *const Count);
+
+void attributeIndexesDrop(const struct StorageController *const Controller,
+                          struct Graph *const Graph);
+
+#endif //LLP_LAB1_ATTRIBUTE_INDEX_H
@@ -0,0 +1,432 @@
+#include "bitmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "arena.h"
+
+#define CONTAINER_BITS 16
+#define BITSET_WORDS ((1 << CONTAINER_BITS) / 64)
+// A bitset takes as much space as an array of this many 16 bit values. Dense
+// containers become arrays again only when half empty, so a container near the
+// limit does not switch back and forth.
+#define ARRAY_CONTAINER_LIMIT 4096
+#define MIN_ARRAY_CAPACITY 16
+#define MIN_DIRECTORY_CAPACITY 8
+
+struct BitmapContainer {
+    size_t Key;
+    size_t Cardinality;
+    bool IsBitset;
+    size_t Capacity;
+    struct AddrInfo Data;
+};
+
+static struct AddrInfo shiftAddr(const struct AddrInfo Addr, const size_t Offset) {
+    return getOptionalFullAddr(Addr.BlockOffset, Addr.DataOffset + Offset);
+}
+
+static struct AddrInfo getContainerAddr(const struct Bitmap *const Bitmap, const size_t Pos) {
+    return shiftAddr(Bitmap->Containers, Pos * sizeof(struct BitmapContainer));
+}
+
+// Position of the container with the key, or of the place to insert it.
+static size_t findContainer(const struct StorageController *const Controller,
+                            const struct Bitmap *const Bitmap, const size_t Key,
+                            bool *const Found) {
+    size_t Left = 0;
+    size_t Right = Bitmap->ContainerCounter;
+    *Found = false;
+    while (Left < Right) {
+        const size_t Middle = (Left + Right) / 2;
+        struct BitmapContainer Container;
+        fetchData(Controller->Allocator, getContainerAddr(Bitmap, Middle), sizeof(Container),
+                  &Container);
+        if (Container.Key == Key) {
+            *Found = true;
+            return Middle;
+        }
+        if (Container.Key < Key) {
+            Left = Middle + 1;
+        } else {
+            Right = Middle;
+        }
+    }
+    return Left;
+}
+
+static void insertContainer(const struct StorageController *const Controller,
+                            const struct AddrInfo BitmapAddr, struct Bitmap *const Bitmap,
+                            const size_t Pos, const struct BitmapContainer *const Container) {
+    const size_t EntrySize = sizeof(struct BitmapContainer);
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct BitmapContainer *Containers =
+            arenaAlloc(Controller->Scratch, (Bitmap->ContainerCounter + 1) * EntrySize);
+    if (Bitmap->ContainerCounter > 0) {
+        fetchData(Controller->Allocator, Bitmap->Containers, Bitmap->ContainerCounter * EntrySize,
+                  Containers);
+    }
+    memmove(Containers + Pos + 1, Containers + Pos, (Bitmap->ContainerCounter - Pos) * EntrySize);
+    Containers[Pos] = *Container;
+    Bitmap->ContainerCounter++;
+    if (Bitmap->ContainerCounter > Bitmap->ContainerCapacity) {
+        if (Bitmap->Containers.HasValue) {
+            deallocate(Controller->Allocator, Bitmap->Containers);
+        }
+        Bitmap->ContainerCapacity = Bitmap->ContainerCapacity == 0
+                                            ? MIN_DIRECTORY_CAPACITY
+                                            : Bitmap->ContainerCapacity * 2;
+        Bitmap->Containers = allocate(Controller->Allocator, Bitmap->ContainerCapacity * EntrySize);
+        storeData(Controller->Allocator, Bitmap->Containers, Bitmap->ContainerCounter * EntrySize,
+                  Containers);
+    } else {
+        storeData(Controller->Allocator, getContainerAddr(Bitmap, Pos),
+                  (Bitmap->ContainerCounter - Pos) * EntrySize, Containers + Pos);
+    }
+    storeData(Controller->Allocator, BitmapAddr, sizeof(*Bitmap), Bitmap);
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+static void removeContainer(const struct StorageController *const Controller,
+                            const struct AddrInfo BitmapAddr, struct Bitmap *const Bitmap,
+                            const size_t Pos) {
+    const size_t EntrySize = sizeof(struct BitmapContainer);
+    const size_t TailSize = (Bitmap->ContainerCounter - Pos - 1) * EntrySize;
+    if (TailSize > 0) {
+        const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+        char *Tail = arenaAlloc(Controller->Scratch, TailSize);
+        fetchData(Controller->Allocator, getContainerAddr(Bitmap, Pos + 1), TailSize, Tail);
+        storeData(Controller->Allocator, getContainerAddr(Bitmap, Pos), TailSize, Tail);
+        arenaRelease(Controller->Scratch, Mark);
+    }
+    Bitmap->ContainerCounter--;
+    storeData(Controller->Allocator, BitmapAddr, sizeof(*Bitmap), Bitmap);
+}
+
+static size_t findArrayValue(const uint16_t *const Values, const size_t Cnt,
+                             const uint16_t Value) {
+    size_t Left = 0;
+    size_t Right = Cnt;
+    while (Left < Right) {
+        const size_t Middle = (Left + Right) / 2;
+        if (Values[Middle] < Value) {
+            Left = Middle + 1;
+        } else {
+            Right = Middle;
+        }
+    }
+    return Left;
+}
+
+static void storeAsBitset(const struct StorageController *const Controller,
+                          struct BitmapContainer *const Container, const uint16_t *const Values,
+                          const size_t Cnt) {
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    uint64_t *Words = arenaAlloc(Controller->Scratch, BITSET_WORDS * sizeof(uint64_t));
+    memset(Words, 0, BITSET_WORDS * sizeof(uint64_t));
+    for (size_t i = 0; i < Cnt; ++i) {
+        Words[Values[i] / 64] |= 1ull << (Values[i] % 64);
+    }
+    deallocate(Controller->Allocator, Container->Data);
+    Container->Data = allocate(Controller->Allocator, BITSET_WORDS * sizeof(uint64_t));
+    storeData(Controller->Allocator, Container->Data, BITSET_WORDS * sizeof(uint64_t), Words);
+    Container->IsBitset = true;
+    Container->Capacity = 0;
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+static void storeAsArray(const struct StorageController *const Controller,
+                         struct BitmapContainer *const Container, const uint16_t *const Values,
+                         const size_t Cnt, const size_t Capacity) {
+    deallocate(Controller->Allocator, Container->Data);
+    Container->Data = allocate(Controller->Allocator, Capacity * sizeof(uint16_t));
+    storeData(Controller->Allocator, Container->Data, Cnt * sizeof(uint16_t), Values);
+    Container->IsBitset = false;
+    Container->Capacity = Capacity;
+}
+
+// Returns false if the value was already there.
+static bool containerAdd(const struct StorageController *const Controller,
+                         struct BitmapContainer *const Container, const uint16_t Value) {
+    if (Container->IsBitset) {
+        const struct AddrInfo WordAddr =
+                shiftAddr(Container->Data, Value / 64 * sizeof(uint64_t));
+        uint64_t Word;
+        fetchData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+        if (Word & (1ull << (Value % 64))) {
+            return false;
+        }
+        Word |= 1ull << (Value % 64);
+        storeData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+        Container->Cardinality++;
+        return true;
+    }
+    const size_t Cnt = Container->Cardinality;
+    if (Cnt > 0 && Cnt < Container->Capacity) {
+        uint16_t Last;
+        fetchData(Controller->Allocator, shiftAddr(Container->Data, (Cnt - 1) * sizeof(uint16_t)),
+                  sizeof(Last), &Last);
+        if (Last < Value) {
+            storeData(Controller->Allocator, shiftAddr(Container->Data, Cnt * sizeof(uint16_t)),
+                      sizeof(Value), &Value);
+            Container->Cardinality++;
+            return true;
+        }
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    // One more place for the inserted value
+    uint16_t *Values = arenaAlloc(Controller->Scratch, (Cnt + 1) * sizeof(uint16_t));
+    fetchData(Controller->Allocator, Container->Data, Cnt * sizeof(uint16_t), Values);
+    const size_t Pos = findArrayValue(Values, Cnt, Value);
+    if (Pos < Cnt && Values[Pos] == Value) {
+        arenaRelease(Controller->Scratch, Mark);
+        return false;
+    }
+    memmove(Values + Pos + 1, Values + Pos, (Cnt - Pos) * sizeof(uint16_t));
+    Values[Pos] = Value;
+    Container->Cardinality++;
+    if (Container->Cardinality > ARRAY_CONTAINER_LIMIT) {
+        storeAsBitset(Controller, Container, Values, Container->Cardinality);
+    } else if (Container->Cardinality > Container->Capacity) {
+        const size_t Capacity = Container->Capacity * 2 > ARRAY_CONTAINER_LIMIT
+                                        ? ARRAY_CONTAINER_LIMIT
+                                        : Container->Capacity * 2;
+        storeAsArray(Controller, Container, Values, Container->Cardinality, Capacity);
+    } else {
+        storeData(Controller->Allocator, shiftAddr(Container->Data, Pos * sizeof(uint16_t)),
+                  (Container->Cardinality - Pos) * sizeof(uint16_t), Values + Pos);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+    return true;
+}
+
+// Returns false if the value was not there.
+static bool containerRemove(const struct StorageController *const Controller,
+                            struct BitmapContainer *const Container, const uint16_t Value) {
+    if (Container->IsBitset) {
+        const struct AddrInfo WordAddr =
+                shiftAddr(Container->Data, Value / 64 * sizeof(uint64_t));
+        uint64_t Word;
+        fetchData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+        if (!(Word & (1ull << (Value % 64)))) {
+            return false;
+        }
+        Word &= ~(1ull << (Value % 64));
+        storeData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+        Container->Cardinality--;
+        // An emptied container is dropped by the caller
+        if (Container->Cardinality > 0 && Container->Cardinality <= ARRAY_CONTAINER_LIMIT / 2) {
+            const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+            uint64_t *Words = arenaAlloc(Controller->Scratch, BITSET_WORDS * sizeof(uint64_t));
+            fetchData(Controller->Allocator, Container->Data, BITSET_WORDS * sizeof(uint64_t),
+                      Words);
+            uint16_t *Values =
+                    arenaAlloc(Controller->Scratch, Container->Cardinality * sizeof(uint16_t));
+            size_t Cnt = 0;
+            for (size_t i = 0; i < BITSET_WORDS; ++i) {
+                for (uint64_t Bits = Words[i]; Bits != 0; Bits &= Bits - 1) {
+                    Values[Cnt++] = i * 64 + __builtin_ctzll(Bits);
+                }
+            }
+            storeAsArray(Controller, Container, Values, Cnt, ARRAY_CONTAINER_LIMIT);
+            arenaRelease(Controller->Scratch, Mark);
+        }
+        return true;
+    }
+    const size_t Cnt = Container->Cardinality;
+    if (Cnt == 0) {
+        return false;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    uint16_t *Values = arenaAlloc(Controller->Scratch, Cnt * sizeof(uint16_t));
+    fetchData(Controller->Allocator, Container->Data, Cnt * sizeof(uint16_t), Values);
+    const size_t Pos = findArrayValue(Values, Cnt, Value);
+    if (Pos == Cnt || Values[Pos] != Value) {
+        arenaRelease(Controller->Scratch, Mark);
+        return false;
+    }
+    Container->Cardinality--;
+    storeData(Controller->Allocator, shiftAddr(Container->Data, Pos * sizeof(uint16_t)),
+              (Cnt - Pos - 1) * sizeof(uint16_t), Values + Pos + 1);
+    arenaRelease(Controller->Scratch, Mark);
+    return true;
+}
+
+void bitmapInit(const struct StorageController *const Controller,
+                const struct AddrInfo BitmapAddr) {
+    const struct Bitmap Bitmap = {
+            .ContainerCounter = 0, .ContainerCapacity = 0, .Containers = NULL_FULL_ADDR};
+    storeData(Controller->Allocator, BitmapAddr, sizeof(Bitmap), &Bitmap);
+}
+
+void bitmapAdd(const struct StorageController *const Controller, const struct AddrInfo BitmapAddr,
+               const size_t Value) {
+    struct Bitmap Bitmap;
+    fetchData(Controller->Allocator, BitmapAddr, sizeof(Bitmap), &Bitmap);
+    const size_t Key = Value >> CONTAINER_BITS;
+    bool Found;
+    const size_t Pos = findContainer(Controller, &Bitmap, Key, &Found);
+    struct BitmapContainer Container;
+    if (!Found) {
+        Container.Key = Key;
+        Container.Cardinality = 0;
+        Container.IsBitset = false;
+        Container.Capacity = MIN_ARRAY_CAPACITY;
+        Container.Data = allocate(Controller->Allocator, MIN_ARRAY_CAPACITY * sizeof(uint16_t));
+        insertContainer(Controller, BitmapAddr, &Bitmap, Pos, &Container);
+    } else {
+        fetchData(Controller->Allocator, getContainerAddr(&Bitmap, Pos), sizeof(Container),
+                  &Container);
+    }
+    if (containerAdd(Controller, &Container, Value & ((1 << CONTAINER_BITS) - 1))) {
+        storeData(Controller->Allocator, getContainerAddr(&Bitmap, Pos), sizeof(Container),
+                  &Container);
+    }
+}
+
+void bitmapRemove(const struct StorageController *const Controller,
+                  const struct AddrInfo BitmapAddr, const size_t Value) {
+    struct Bitmap Bitmap;
+    fetchData(Controller->Allocator, BitmapAddr, sizeof(Bitmap), &Bitmap);
+    bool Found;
+    const size_t Pos = findContainer(Controller, &Bitmap, Value >> CONTAINER_BITS, &Found);
+    if (!Found) {
+        return;
+    }
+    struct BitmapContainer Container;
+    fetchData(Controller->Allocator, getContainerAddr(&Bitmap, Pos), sizeof(Container),
+              &Container);
+    if (!containerRemove(Controller, &Container, Value & ((1 << CONTAINER_BITS) - 1))) {
+        return;
+    }
+    if (Container.Cardinality == 0) {
+        deallocate(Controller->Allocator, Container.Data);
+        removeContainer(Controller, BitmapAddr, &Bitmap, Pos);
+        return;
+    }
+    storeData(Controller->Allocator, getContainerAddr(&Bitmap, Pos), sizeof(Container),
+              &Container);
+}
+
+static void loadContainer(const struct StorageController *const Controller,
+                          const struct BitmapContainer *const Container, uint64_t *const Words) {
+    if (Container->IsBitset) {
+        fetchData(Controller->Allocator, Container->Data, BITSET_WORDS * sizeof(uint64_t), Words);
+        return;
+    }
+    memset(Words, 0, BITSET_WORDS * sizeof(uint64_t));
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    uint16_t *Values = arenaAlloc(Controller->Scratch, Container->Cardinality * sizeof(uint16_t));
+    fetchData(Controller->Allocator, Container->Data, Container->Cardinality * sizeof(uint16_t),
+              Values);
+    for (size_t i = 0; i < Container->Cardinality; ++i) {
+        Words[Values[i] / 64] |= 1ull << (Values[i] % 64);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+static const struct BitmapContainer *
+findLoadedContainer(const struct BitmapContainer *const Containers, const size_t Cnt,
+                    const size_t Key) {
+    size_t Left = 0;
+    size_t Right = Cnt;
+    while (Left < Right) {
+        const size_t Middle = (Left + Right) / 2;
+        if (Containers[Middle].Key == Key) {
+            return Containers + Middle;
+        }
+        if (Containers[Middle].Key < Key) {
+            Left = Middle + 1;
+        } else {
+            Right = Middle;
+        }
+    }
+    return NULL;
+}
+
+size_t bitmapIntersect(const struct StorageController *const Controller,
+                       const struct AddrInfo *const BitmapAddrs, const size_t BitmapsNumber,
+                       size_t **Values) {
+    // The result grows with realloc and is handed to the caller, the rest is
+    // scratch
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Bitmap *Bitmaps = arenaAlloc(Controller->Scratch, BitmapsNumber * sizeof(struct Bitmap));
+    struct BitmapContainer **Containers =
+            arenaAlloc(Controller->Scratch, BitmapsNumber * sizeof(struct BitmapContainer *));
+    size_t Smallest = 0;
+    for (size_t i = 0; i < BitmapsNumber; ++i) {
+        fetchData(Controller->Allocator, BitmapAddrs[i], sizeof(struct Bitmap), Bitmaps + i);
+        Containers[i] = arenaAlloc(Controller->Scratch,
+                                   Bitmaps[i].ContainerCounter * sizeof(struct BitmapContainer));
+        if (Bitmaps[i].ContainerCounter > 0) {
+            fetchData(Controller->Allocator, Bitmaps[i].Containers,
+                      Bitmaps[i].ContainerCounter * sizeof(struct BitmapContainer),
+                      Containers[i]);
+        }
+        if (Bitmaps[i].ContainerCounter < Bitmaps[Smallest].ContainerCounter) {
+            Smallest = i;
+        }
+    }
+    size_t Cnt = 0;
+    size_t Capacity = 0;
+    if (Values != NULL) {
+        *Values = NULL;
+    }
+    uint64_t *Words = arenaAlloc(Controller->Scratch, BITSET_WORDS * sizeof(uint64_t));
+    uint64_t *OtherWords = arenaAlloc(Controller->Scratch, BITSET_WORDS * sizeof(uint64_t));
+    for (size_t c = 0; BitmapsNumber > 0 && c < Bitmaps[Smallest].ContainerCounter; ++c) {
+        const size_t Key = Containers[Smallest][c].Key;
+        loadContainer(Controller, &(Containers[Smallest][c]), Words);
+        bool Empty = false;
+        for (size_t i = 0; i < BitmapsNumber && !Empty; ++i) {
+            if (i == Smallest) {
+                continue;
+            }
+            const struct BitmapContainer *const Other =
+                    findLoadedContainer(Containers[i], Bitmaps[i].ContainerCounter, Key);
+            if (Other == NULL) {
+                Empty = true;
+                break;
+            }
+            loadContainer(Controller, Other, OtherWords);
+            for (size_t w = 0; w < BITSET_WORDS; ++w) {
+                Words[w] &= OtherWords[w];
+            }
+        }
+        if (Empty) {
+            continue;
+        }
+        for (size_t w = 0; w < BITSET_WORDS; ++w) {
+            if (Values == NULL) {
+                Cnt += __builtin_popcountll(Words[w]);
+                continue;
+            }
+            for (uint64_t Bits = Words[w]; Bits != 0; Bits &= Bits - 1) {
+                if (Cnt == Capacity) {
+                    Capacity = Capacity == 0 ? 1024 : Capacity * 2;
+                    *Values = realloc(*Values, Capacity * sizeof(size_t));
+                }
+                (*Values)[Cnt++] = (Key << CONTAINER_BITS) | (w * 64 + __builtin_ctzll(Bits));
+            }
+        }
+    }
+    arenaRelease(Controller->Scratch, Mark);
+    return Cnt;
+}
+
+void bitmapDrop(const struct StorageController *const Controller,
+                const struct AddrInfo BitmapAddr) {
+    struct Bitmap Bitmap;
+    fetchData(Controller->Allocator, BitmapAddr, sizeof(Bitmap), &Bitmap);
+    for (size_t i = 0; i < Bitmap.ContainerCounter; ++i) {
+        struct BitmapContainer Container;
+        fetchData(Controller->Allocator, getContainerAddr(&Bitmap, i), sizeof(Container),
+                  &Container);
+        deallocate(Controller->Allocator, Container.Data);
+    }
+    if (Bitmap.Containers.HasValue) {
+        deallocate(Controller->Allocator, Bitmap.Containers);
+    }
+    bitmapInit(Controller, BitmapAddr);
+}
@@ -0,0 +1,28 @@
+#ifndef LLP_LAB1_BITMAP_H
+#define LLP_LAB1_BITMAP_H
+
+#include "../structures-data/types.h"
+#include "storage-manager.h"
+
+// Compressed set of size_t values kept in the file. Values are split by their
+// high bits into containers of 2^16 values; a container stores the sorted low
+// 16 bits of its values while it is sparse and a plain bitset once it is dense.
+struct Bitmap {
+    size_t ContainerCounter;
+    size_t ContainerCapacity;
+    struct AddrInfo Containers;
+};
+
+void bitmapInit(const struct StorageController *const Controller, struct AddrInfo BitmapAddr);
+void bitmapAdd(const struct StorageController *const Controller, struct AddrInfo BitmapAddr,
+               size_t Value);
+void bitmapRemove(const struct StorageController *const Controller, struct AddrInfo BitmapAddr,
+                  size_t Value);
+// Returns the number of values present in every bitmap, and the values
+// themselves in ascending order if Values is not NULL.
+size_t bitmapIntersect(const struct StorageController *const Controller,
+                       const struct AddrInfo *const BitmapAddrs, size_t BitmapsNumber,
+                       size_t **Values);
+void bitmapDrop(const struct StorageController *const Controller, struct AddrInfo BitmapAddr);
+
+#endif //LLP_LAB1_BITMAP_H
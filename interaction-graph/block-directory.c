@@ -0,0 +1,128 @@
+#include "block-directory.h"
+
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "arena.h"
+
+#define BLOCK_DIRECTORY_MIN_ENTRIES 4
+
+static struct AddrInfo getEntryAddr(const struct BlockDirectory *const Directory,
+                                    const size_t Index) {
+    return getOptionalFullAddr(Directory->Entries.BlockOffset,
+                               Directory->Entries.DataOffset +
+                                       Index * sizeof(struct BlockDirectoryEntry));
+}
+
+static void resize(const struct StorageController *const Controller,
+                   struct BlockDirectory *const Directory, const size_t NewCapacity) {
+    const size_t NewSize = NewCapacity * sizeof(struct BlockDirectoryEntry);
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct BlockDirectoryEntry *Entries = arenaAlloc(Controller->Scratch, NewSize);
+    memset(Entries, 0, NewSize);
+    if (Directory->Entries.HasValue) {
+        fetchData(Controller->Allocator, Directory->Entries,
+                  Directory->Used * sizeof(struct BlockDirectoryEntry), Entries);
+        deallocate(Controller->Allocator, Directory->Entries);
+    }
+    Directory->Entries = allocate(Controller->Allocator, NewSize);
+    storeData(Controller->Allocator, Directory->Entries, NewSize, Entries);
+    Directory->Capacity = NewCapacity;
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+void blockDirectoryAppend(const struct StorageController *const Controller,
+                          struct BlockDirectory *const Directory, const struct AddrInfo Addr,
+                          const size_t Count, const size_t RecordSize) {
+    if (Count == 0) {
+        return;
+    }
+    struct BlockDirectoryEntry Last;
+    if (Directory->Used != 0) {
+        blockDirectoryGetEntry(Controller, Directory, Directory->Used - 1, &Last);
+        if (inOneBlock(Last.Addr, Addr) &&
+            Last.Addr.DataOffset + Last.Count * RecordSize == Addr.DataOffset) {
+            Last.Count += Count;
+            storeData(Controller->Allocator, getEntryAddr(Directory, Directory->Used - 1),
+                      sizeof(Last), &Last);
+            Directory->Records += Count;
+            return;
+        }
+    }
+    if (Directory->Used == Directory->Capacity) {
+        resize(Controller, Directory,
+               Directory->Capacity ? Directory->Capacity * 2 : BLOCK_DIRECTORY_MIN_ENTRIES);
+    }
+    const struct BlockDirectoryEntry Entry = {Addr, Directory->Records, Count};
+    storeData(Controller->Allocator, getEntryAddr(Directory, Directory->Used), sizeof(Entry),
+              &Entry);
+    Directory->Used++;
+    Directory->Records += Count;
+}
+
+void blockDirectoryRemoveLast(const struct StorageController *const Controller,
+                              struct BlockDirectory *const Directory) {
+    if (Directory->Used == 0) {
+        return;
+    }
+    struct BlockDirectoryEntry Last;
+    blockDirectoryGetEntry(Controller, Directory, Directory->Used - 1, &Last);
+    Directory->Records--;
+    if (--Last.Count == 0) {
+        Directory->Used--;
+        return;
+    }
+    storeData(Controller->Allocator, getEntryAddr(Directory, Directory->Used - 1), sizeof(Last),
+              &Last);
+}
+
+size_t blockDirectoryFindEntry(const struct StorageController *const Controller,
+                               const struct BlockDirectory *const Directory, const size_t Number) {
+    if (Number >= Directory->Records) {
+        return Directory->Used;
+    }
+    // Runs are read in place, nothing is written during the search
+    const struct BlockDirectoryEntry *const Entries =
+            getDataPointer(Controller->Allocator, Directory->Entries);
+    size_t Low = 0;
+    size_t High = Directory->Used - 1;
+    while (Low < High) {
+        const size_t Middle = Low + (High - Low + 1) / 2;
+        if (Entries[Middle].First <= Number) {
+            Low = Middle;
+        } else {
+            High = Middle - 1;
+        }
+    }
+    return Low;
+}
+
+void blockDirectoryGetEntry(const struct StorageController *const Controller,
+                            const struct BlockDirectory *const Directory, const size_t Index,
+                            struct BlockDirectoryEntry *const Entry) {
+    fetchData(Controller->Allocator, getEntryAddr(Directory, Index), sizeof(*Entry), Entry);
+}
+
+struct AddrInfo blockDirectoryFind(const struct StorageController *const Controller,
+                                   const struct BlockDirectory *const Directory,
+                                   const size_t Number, const size_t RecordSize) {
+    const size_t Index = blockDirectoryFindEntry(Controller, Directory, Number);
+    if (Index == Directory->Used) {
+        return NULL_FULL_ADDR;
+    }
+    struct BlockDirectoryEntry Entry;
+    blockDirectoryGetEntry(Controller, Directory, Index, &Entry);
+    return getOptionalFullAddr(Entry.Addr.BlockOffset,
+                               Entry.Addr.DataOffset + (Number - Entry.First) * RecordSize);
+}
+
+void blockDirectoryDrop(const struct StorageController *const Controller,
+                        struct BlockDirectory *const Directory) {
+    if (Directory->Entries.HasValue) {
+        deallocate(Controller->Allocator, Directory->Entries);
+    }
+    Directory->Entries = NULL_FULL_ADDR;
+    Directory->Capacity = 0;
+    Directory->Used = 0;
+    Directory->Records = 0;
+}
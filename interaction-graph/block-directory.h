@@ -0,0 +1,42 @@
+#ifndef LLP_LAB1_BLOCK_DIRECTORY_H
+#define LLP_LAB1_BLOCK_DIRECTORY_H
+
+#include "../structures-data/types.h"
+#include "storage-manager.h"
+
+// Persistent array of the runs a record chain is made of, in chain order. A
+// run is a part of the chain lying one after another in a block, so a chain
+// filled block by block has one run per block. Records are numbered along the
+// chain from zero, for nodes the number is the slot. Any record is found by its
+// number with a binary search over the runs, without following the chain.
+
+struct BlockDirectoryEntry {
+    struct AddrInfo Addr;
+    // Number of the first record of the run
+    size_t First;
+    size_t Count;
+};
+
+// Count records starting at Addr are put after the last record of the chain,
+// they continue its last run if they follow it in the same block.
+void blockDirectoryAppend(const struct StorageController *const Controller,
+                          struct BlockDirectory *const Directory, struct AddrInfo Addr,
+                          size_t Count, size_t RecordSize);
+// Called for every record trimmed from the end of the chain.
+void blockDirectoryRemoveLast(const struct StorageController *const Controller,
+                              struct BlockDirectory *const Directory);
+// Returns the index of the run holding record Number, or Directory->Used if
+// the chain is shorter.
+size_t blockDirectoryFindEntry(const struct StorageController *const Controller,
+                               const struct BlockDirectory *const Directory, size_t Number);
+void blockDirectoryGetEntry(const struct StorageController *const Controller,
+                            const struct BlockDirectory *const Directory, size_t Index,
+                            struct BlockDirectoryEntry *const Entry);
+// Address of record Number, has no value if the chain is shorter.
+struct AddrInfo blockDirectoryFind(const struct StorageController *const Controller,
+                                   const struct BlockDirectory *const Directory, size_t Number,
+                                   size_t RecordSize);
+void blockDirectoryDrop(const struct StorageController *const Controller,
+                        struct BlockDirectory *const Directory);
+
+#endif //LLP_LAB1_BLOCK_DIRECTORY_H
@@ -0,0 +1,226 @@
+#include "column-store.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "arena.h"
+
+size_t getColumnWidth(const enum DATA_TYPE Type) {
+    return Type == STRING ? sizeof(struct MyString) : sizeof(uint32_t);
+}
+
+void columnStoreLayout(struct GraphCatalogEntry *const Entry) {
+    Entry->ColumnOffsets = NULL;
+    Entry->ColumnRegionSize = 0;
+    if (!Entry->Header.Columnar) {
+        return;
+    }
+    Entry->ColumnOffsets = malloc(sizeof(size_t) * (Entry->Header.AttributeCounter + 1));
+    size_t Offset = COLUMN_BITMAP_SIZE;
+    for (size_t i = 0; i < Entry->Header.AttributeCounter; ++i) {
+        Entry->ColumnOffsets[i] = Offset;
+        Offset += GRAPH_NODES_PER_BLOCK * getColumnWidth(Entry->Attributes[i].Type);
+    }
+    Entry->ColumnRegionSize = Offset;
+}
+
+static const struct GraphCatalogEntry *getEntry(const struct StorageController *const Controller,
+                                                const struct Graph *const Graph) {
+    return graphCatalogFindById(Controller->Catalog, Graph->Id);
+}
+
+size_t getNodeRecordSize(const struct Graph *const Graph) {
+    if (Graph->Columnar) {
+        return sizeof(struct Node);
+    }
+    return sizeof(struct Node) + sizeof(struct Attribute) * Graph->AttributeCounter;
+}
+
+size_t getNodeBlockSize(const struct StorageController *const Controller,
+                        const struct Graph *const Graph) {
+    const size_t RecordsSize = getNodeRecordSize(Graph) * GRAPH_NODES_PER_BLOCK;
+    if (!Graph->Columnar) {
+        return RecordsSize;
+    }
+    return RecordsSize + getEntry(Controller, Graph)->ColumnRegionSize;
+}
+
+struct AddrInfo getNodeAttributesAddr(const struct Graph *const Graph,
+                                      const struct AddrInfo NodeAddr, const size_t Slot) {
+    if (!Graph->Columnar) {
+        return getOptionalFullAddr(NodeAddr.BlockOffset, NodeAddr.DataOffset + sizeof(struct Node));
+    }
+    const size_t BlockStart =
+            NodeAddr.DataOffset - Slot % GRAPH_NODES_PER_BLOCK * sizeof(struct Node);
+    return getOptionalFullAddr(NodeAddr.BlockOffset,
+                               BlockStart + GRAPH_NODES_PER_BLOCK * sizeof(struct Node));
+}
+
+static struct AddrInfo getColumnValueAddr(const struct Node *const Node, const size_t Offset,
+                                          const size_t Width) {
+    const struct AddrInfo Region = unpackAddr(Node->Attributes);
+    return getOptionalFullAddr(Region.BlockOffset, Region.DataOffset + Offset +
+                                                           Node->Slot % GRAPH_NODES_PER_BLOCK *
+                                                                   Width);
+}
+
+// Value as it is kept in a column, BOOL values get their unused bytes cleared.
+static union Value getColumnValue(const struct Attribute *const Attribute) {
+    union Value Value;
+    memset(&Value, 0, sizeof(Value));
+    if (Attribute->Type == BOOL) {
+        Value.BoolValue = Attribute->Value.BoolValue;
+    } else {
+        memcpy(&Value, &Attribute->Value, getColumnWidth(Attribute->Type));
+    }
+    return Value;
+}
+
+static void fetchColumnValue(const struct StorageController *const Controller,
+                             const struct GraphCatalogEntry *const Entry,
+                             const struct Node *const Node, const size_t AttributeId,
+                             struct Attribute *const Result) {
+    const size_t Width = getColumnWidth(Entry->Attributes[AttributeId].Type);
+    Result->Id = AttributeId;
+    Result->Type = Entry->Attributes[AttributeId].Type;
+    memset(&Result->Value, 0, sizeof(Result->Value));
+    fetchData(Controller->Allocator,
+              getColumnValueAddr(Node, Entry->ColumnOffsets[AttributeId], Width), Width,
+              &Result->Value);
+}
+
+void fetchNodeAttributes(const struct StorageController *const Controller,
+                         const struct Graph *const Graph, const struct Node *const Node,
+                         struct Attribute *const Result) {
+    if (!Graph->Columnar) {
+        fetchData(Controller->Allocator, unpackAddr(Node->Attributes),
+                  sizeof(struct Attribute) * Graph->AttributeCounter, Result);
+        return;
+    }
+    const struct GraphCatalogEntry *const Entry = getEntry(Controller, Graph);
+    for (size_t i = 0; i < Graph->AttributeCounter; ++i) {
+        fetchColumnValue(Controller, Entry, Node, i, &Result[i]);
+    }
+}
+
+bool fetchNodeAttribute(const struct StorageController *const Controller,
+                        const struct Graph *const Graph, const struct Node *const Node,
+                        const size_t AttributeId, struct Attribute *const Result) {
+    if (AttributeId >= Graph->AttributeCounter) {
+        return false;
+    }
+    fetchColumnValue(Controller, getEntry(Controller, Graph), Node, AttributeId, Result);
+    return true;
+}
+
+static void setLive(const struct StorageController *const Controller,
+                    const struct Node *const Node, const bool Live) {
+    const size_t Index = Node->Slot % GRAPH_NODES_PER_BLOCK;
+    const struct AddrInfo Region = unpackAddr(Node->Attributes);
+    const struct AddrInfo WordAddr = getOptionalFullAddr(
+            Region.BlockOffset, Region.DataOffset + Index / 64 * sizeof(uint64_t));
+    uint64_t Word;
+    fetchData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+    if (Live) {
+        Word |= (uint64_t) 1 << (Index % 64);
+    } else {
+        Word &= ~((uint64_t) 1 << (Index % 64));
+    }
+    storeData(Controller->Allocator, WordAddr, sizeof(Word), &Word);
+}
+
+void storeNodeAttributes(const struct StorageController *const Controller,
+                         const struct Graph *const Graph, const struct Node *const Node,
+                         const struct Attribute *const Attributes) {
+    if (!Graph->Columnar) {
+        storeData(Controller->Allocator, unpackAddr(Node->Attributes),
+                  sizeof(struct Attribute) * Graph->AttributeCounter, Attributes);
+        return;
+    }
+    const struct GraphCatalogEntry *const Entry = getEntry(Controller, Graph);
+    for (size_t i = 0; i < Graph->AttributeCounter; ++i) {
+        const size_t Column = Attributes[i].Id;
+        const size_t Width = getColumnWidth(Entry->Attributes[Column].Type);
+        const union Value Value = getColumnValue(&Attributes[i]);
+        storeData(Controller->Allocator,
+                  getColumnValueAddr(Node, Entry->ColumnOffsets[Column], Width), Width, &Value);
+    }
+    setLive(Controller, Node, true);
+}
+
+void storeColumnsRun(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, const struct Node *const First,
+                     const size_t Count, const struct Attribute *const Attributes) {
+    const struct GraphCatalogEntry *const Entry = getEntry(Controller, Graph);
+    const size_t AttributeCounter = Graph->AttributeCounter;
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    char *const Values = arenaAlloc(Controller->Scratch, sizeof(struct MyString) * Count);
+    for (size_t Column = 0; Column < AttributeCounter; ++Column) {
+        const size_t Width = getColumnWidth(Entry->Attributes[Column].Type);
+        for (size_t i = 0; i < Count; ++i) {
+            const struct Attribute *const NodeAttributes = Attributes + i * AttributeCounter;
+            size_t Position = Column;
+            if (NodeAttributes[Position].Id != Column) {
+                Position = 0;
+                while (NodeAttributes[Position].Id != Column) {
+                    Position++;
+                }
+            }
+            const union Value Value = getColumnValue(&NodeAttributes[Position]);
+            memcpy(Values + i * Width, &Value, Width);
+        }
+        storeData(Controller->Allocator,
+                  getColumnValueAddr(First, Entry->ColumnOffsets[Column], Width), Count * Width,
+                  Values);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+    uint64_t Live[COLUMN_BITMAP_SIZE / sizeof(uint64_t)];
+    const struct AddrInfo Region = unpackAddr(First->Attributes);
+    fetchData(Controller->Allocator, Region, COLUMN_BITMAP_SIZE, Live);
+    const size_t Index = First->Slot % GRAPH_NODES_PER_BLOCK;
+    for (size_t i = Index; i < Index + Count; ++i) {
+        Live[i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+    storeData(Controller->Allocator, Region, COLUMN_BITMAP_SIZE, Live);
+}
+
+void moveNodeAttributes(const struct StorageController *const Controller,
+                        const struct Graph *const Graph, const struct Node *const From,
+                        const struct Node *const To) {
+    // Attributes of row graphs are moved with the record
+    if (!Graph->Columnar) {
+        return;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *const Attributes =
+            arenaAlloc(Controller->Scratch, sizeof(struct Attribute) * Graph->AttributeCounter);
+    fetchNodeAttributes(Controller, Graph, From, Attributes);
+    setLive(Controller, From, false);
+    storeNodeAttributes(Controller, Graph, To, Attributes);
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+void columnStoreRemoveNode(const struct StorageController *const Controller,
+                           const struct Graph *const Graph, const struct Node *const Node) {
+    if (Graph->Columnar) {
+        setLive(Controller, Node, false);
+    }
+}
+
+void columnStoreGetLive(const char *const Region, const size_t First, const size_t Count,
+                        uint64_t *const Live) {
+    const uint64_t *const Bitmap = (const uint64_t *) Region;
+    const size_t Shift = First % 64;
+    for (size_t w = 0; w * 64 < Count; ++w) {
+        const size_t Word = First / 64 + w;
+        uint64_t Bits = Bitmap[Word] >> Shift;
+        if (Shift != 0 && (Word + 1) * 64 < First + Count) {
+            Bits |= Bitmap[Word + 1] << (64 - Shift);
+        }
+        if (Count - w * 64 < 64) {
+            Bits &= ((uint64_t) 1 << (Count - w * 64)) - 1;
+        }
+        Live[w] = Bits;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef LLP_LAB1_COLUMN_STORE_H
+#define LLP_LAB1_COLUMN_STORE_H
+
+#include "../configs/config.h"
+#include "../structures-data/types.h"
+#include "graph-catalog.h"
+#include "storage-manager.h"
+
+// Attributes of a graph created with Columnar set are kept apart from its node
+// records. A node block of such a graph holds GRAPH_NODES_PER_BLOCK bare node
+// records followed by the column region of the block: a bitmap of the live
+// slots of the block, then one column per attribute in id order holding the
+// values of the nodes of the block in slot order. INT, FLOAT and BOOL values
+// take four bytes, STRING values keep their struct MyString. Node.Attributes of
+// a columnar node points to the region of its block and the node is at
+// Slot % GRAPH_NODES_PER_BLOCK in every column. Attributes read from a columnar
+// node are ordered by id.
+//
+// The functions below work for row graphs too, where the attributes follow
+// the node record.
+
+#define COLUMN_BITMAP_SIZE ((GRAPH_NODES_PER_BLOCK + 63) / 64 * sizeof(uint64_t))
+
+size_t getColumnWidth(enum DATA_TYPE Type);
+// Sets the column offsets and the region size of a columnar graph entry.
+void columnStoreLayout(struct GraphCatalogEntry *const Entry);
+
+// Distance between two node records of a block.
+size_t getNodeRecordSize(const struct Graph *const Graph);
+size_t getNodeBlockSize(const struct StorageController *const Controller,
+                        const struct Graph *const Graph);
+// Value of Node.Attributes for a node put at NodeAddr into Slot.
+struct AddrInfo getNodeAttributesAddr(const struct Graph *const Graph, struct AddrInfo NodeAddr,
+                                      size_t Slot);
+
+// Result gets all attributes of the node.
+void fetchNodeAttributes(const struct StorageController *const Controller,
+                         const struct Graph *const Graph, const struct Node *const Node,
+                         struct Attribute *const Result);
+// Columnar graphs only, returns false if the graph has no attribute with the id.
+bool fetchNodeAttribute(const struct StorageController *const Controller,
+                        const struct Graph *const Graph, const struct Node *const Node,
+                        size_t AttributeId, struct Attribute *const Result);
+// Stores all attributes of the node and marks it live.
+void storeNodeAttributes(const struct StorageController *const Controller,
+                         const struct Graph *const Graph, const struct Node *const Node,
+                         const struct Attribute *const Attributes);
+// Columnar graphs only: Attributes holds Count attribute arrays of the nodes
+// in the slots starting with the one of First, all in the block of First.
+// Every column is written once.
+void storeColumnsRun(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, const struct Node *const First, size_t Count,
+                     const struct Attribute *const Attributes);
+// Called after the record of a node has been moved from From to To.
+void moveNodeAttributes(const struct StorageController *const Controller,
+                        const struct Graph *const Graph, const struct Node *const From,
+                        const struct Node *const To);
+// Clears the live bit of a deleted node of a columnar graph.
+void columnStoreRemoveNode(const struct StorageController *const Controller,
+                           const struct Graph *const Graph, const struct Node *const Node);
+
+// Bit i of Live is set if slot First + i of the block owning the column
+// region Region is live, for Count slots.
+void columnStoreGetLive(const char *const Region, size_t First, size_t Count,
+                        uint64_t *const Live);
+
+#endif //LLP_LAB1_COLUMN_STORE_H
@@ -1,10 +1,27 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "../structures-data/types.h"
 #include "../structures-request/data-interfaces.h"
 #include "../interaction-file/file-io.h"
+#include "arena.h"
+#include "attribute-index.h"
+#include "block-directory.h"
+#include "column-store.h"
+#include "filter-program.h"
+#include "graph-catalog.h"
 #include "graph-db.h"
+#include "node-index.h"
 #include "storage-manager.h"
+#include "worker-pool.h"
+#include "zone-map.h"
+
+// Link records are addressed with packed addresses, so a bulk block must end
+// within the offset they can hold
+#define MAX_LINKS_PER_BULK_BLOCK                                                               \
+    ((PACKED_DATA_OFFSET_LIMIT - sizeof(struct BlockHeader)) / sizeof(struct NodeLink))
 
 struct AddrInfo findGraphAddrById(const struct StorageController *Controller,
                                   size_t Id);
@@ -30,43 +47,15 @@ size_t findNodeLinksByIdAndType(const struct StorageController *Controller,
 
 struct AddrInfo findGraphAddrById(const struct StorageController *const Controller,
                                   const size_t Id) {
-    struct AddrInfo GraphAddr = Controller->Storage.Graphs;
-    while (GraphAddr.HasValue) {
-        struct Graph Graph;
-        fetchData(Controller->Allocator, GraphAddr, sizeof(struct Graph), &Graph);
-        if (Graph.Id == Id) {
-            return GraphAddr;
-        }
-        GraphAddr = Graph.Next;
-    }
-    return NULL_FULL_ADDR;
+    const struct GraphCatalogEntry *const Entry = graphCatalogFindById(Controller->Catalog, Id);
+    return Entry != NULL ? Entry->Addr : NULL_FULL_ADDR;
 }
 
 struct AddrInfo findGraphAddrByName(const struct StorageController *const Controller,
                                     const char *const Name) {
-    struct AddrInfo GraphAddr = Controller->Storage.Graphs;
-    struct AddrInfo Result = NULL_FULL_ADDR;
-    while (GraphAddr.HasValue) {
-        struct Graph Graph;
-        fetchData(Controller->Allocator, GraphAddr, sizeof(struct Graph), &Graph);
-        struct MyString GraphName = Graph.Name;
-        char *GraphNameStr = malloc(GraphName.Length + 1);
-        if (GraphName.Length > SMALL_STRING_LIMIT) {
-            fetchData(Controller->Allocator, GraphName.Data.DataPtr, GraphName.Length,
-                      GraphNameStr);
-        } else {
-            memcpy(GraphNameStr, GraphName.Data.InlinedData, GraphName.Length);
-        }
-        GraphNameStr[GraphName.Length] = 0;
-        if (strcmp(GraphNameStr, Name) == 0) {
-            Result = GraphAddr;
-        }
-        free(GraphNameStr);
-        if (Result.HasValue)
-            return Result;
-        GraphAddr = Graph.Next;
-    }
-    return NULL_FULL_ADDR;
+    const struct GraphCatalogEntry *const Entry =
+            graphCatalogFindByName(Controller->Catalog, Name);
+    return Entry != NULL ? Entry->Addr : NULL_FULL_ADDR;
 }
 
 struct AddrInfo findGraphAddrByGraphId(const struct StorageController *const Controller,
@@ -81,233 +70,442 @@ struct AddrInfo findGraphAddrByGraphId(const struct StorageController *const Con
     return NULL_FULL_ADDR;
 }
 
-static bool matchIntFilter(const struct IntFilter *const Filter, int32_t Value) {
-    if (Filter->HasMin && Filter->Min > Value) {
-        return false;
+// State of a search for the nodes matching a filter chain that stops once
+// the buffer it fills is full and continues from there on the next call.
+// Candidates given by an attribute index are checked first, otherwise the
+// node chain is scanned.
+struct NodeScan {
+    struct AddrInfo GraphAddr;
+    struct Graph Graph;
+    const struct AttributeFilter *FilterChain;
+    struct FilterProgram Program;
+    size_t *CandidateIds;
+    size_t CandidatesCnt;
+    size_t CandidateIndex;
+    bool ExactCandidates;
+    bool ByIndex;
+    // Next node of the chain to check, has no value when the scan is over
+    struct AddrInfo NodeAddr;
+    bool UseZoneMaps;
+    size_t LastSlot;
+    // Nodes of the chain lying one after another in a block are checked all at
+    // once, RunMask has the matches of such a run not returned yet
+    bool UseRuns;
+    struct AddrInfo RunAddr;
+    size_t RunCount;
+    size_t RunIndex;
+    uint64_t RunMask[FILTER_RUN_WORDS];
+    // Matches still to be skipped and to be returned before the scan is over
+    size_t ToSkip;
+    size_t Left;
+};
+
+static void nodeScanBegin(const struct StorageController *const Controller,
+                          const struct AddrInfo GraphAddr,
+                          const struct AttributeFilter *const FilterChain,
+                          struct NodeScan *const Scan) {
+    Scan->GraphAddr = GraphAddr;
+    fetchGraph(Controller, GraphAddr, &Scan->Graph);
+    Scan->FilterChain = FilterChain;
+    filterProgramCompile(graphCatalogFindByAddr(Controller->Catalog, GraphAddr), FilterChain,
+                         &Scan->Program);
+    Scan->CandidateIndex = 0;
+    Scan->NodeAddr = NULL_FULL_ADDR;
+    Scan->UseZoneMaps = false;
+    Scan->LastSlot = 0;
+    Scan->UseRuns = false;
+    Scan->RunCount = 0;
+    Scan->RunIndex = 0;
+    Scan->ToSkip = 0;
+    Scan->Left = SIZE_MAX;
+    Scan->ByIndex = attributeIndexesSelect(Controller, &Scan->Graph, FilterChain,
+                                           &Scan->CandidateIds, &Scan->CandidatesCnt,
+                                           &Scan->ExactCandidates);
+    if (Scan->ByIndex) {
+        return;
     }
-    if (Filter->HasMax && Filter->Max < Value) {
-        return false;
+    Scan->CandidateIds = NULL;
+    Scan->CandidatesCnt = 0;
+    Scan->NodeAddr = Scan->Graph.Nodes;
+    Scan->UseZoneMaps = Scan->Graph.ZoneMaps.HasValue && Scan->NodeAddr.HasValue &&
+                        zoneMapCanSkip(FilterChain);
+    Scan->UseRuns = filterProgramHasVectorizedOps(&Scan->Program);
+    if (Scan->NodeAddr.HasValue) {
+        struct Node LastNode;
+        fetchData(Controller->Allocator, Scan->Graph.LastNode, sizeof(LastNode), &LastNode);
+        Scan->LastSlot = LastNode.Slot;
     }
-    return true;
 }
 
-static bool matchFloatFilter(const struct FloatFilter *const Filter, float Value) {
-    if (Filter->HasMin && Filter->Min > Value) {
-        return false;
+// The directory of the graph as it is now, a scan may outlive its copy of the
+// header.
+static const struct BlockDirectory *getNodeBlocks(const struct StorageController *const Controller,
+                                                  const struct NodeScan *const Scan) {
+    return &graphCatalogFindByAddr(Controller->Catalog, Scan->GraphAddr)->Header.NodeBlocks;
+}
+
+// Moves the scan right after the node the token was taken at. Chain tokens
+// keep the slot of that node and index tokens its id, if the node can not be
+// found that way the matches before it are skipped instead.
+static void nodeScanResume(const struct StorageController *const Controller,
+                           struct NodeScan *const Scan, const struct ResumeToken *const Token) {
+    if (!Token->HasValue) {
+        return;
     }
-    if (Filter->HasMax && Filter->Max < Value) {
+    if (Token->ByIndex != Scan->ByIndex) {
+        Scan->ToSkip += Token->Passed;
+        return;
+    }
+    if (Token->ByIndex) {
+        for (size_t i = 0; i < Scan->CandidatesCnt; ++i) {
+            if (Scan->CandidateIds[i] == Token->Key) {
+                Scan->CandidateIndex = i + 1;
+                return;
+            }
+        }
+        Scan->ToSkip += Token->Passed;
+        return;
+    }
+    if (!Scan->NodeAddr.HasValue) {
+        return;
+    }
+    if (Token->Key >= Scan->LastSlot) {
+        Scan->NodeAddr = NULL_FULL_ADDR;
+        return;
+    }
+    // Slots of the chain go one after another, so the node after the slot is
+    // the right place even if the token node has been moved since
+    const size_t FullNodeSize = getNodeRecordSize(&Scan->Graph);
+    Scan->NodeAddr = blockDirectoryFind(Controller, getNodeBlocks(Controller, Scan),
+                                        Token->Key + 1, FullNodeSize);
+}
+
+static bool nodeScanIsExhausted(const struct NodeScan *const Scan) {
+    return Scan->CandidateIndex == Scan->CandidatesCnt && Scan->RunIndex == Scan->RunCount &&
+           !Scan->NodeAddr.HasValue;
+}
+
+static bool nodeScanIsOver(const struct NodeScan *const Scan) {
+    return Scan->Left == 0 || nodeScanIsExhausted(Scan);
+}
+
+// Counts a match against the offset and the limit, returns true if it has to
+// be returned.
+static bool nodeScanTake(struct NodeScan *const Scan) {
+    if (Scan->ToSkip > 0) {
+        Scan->ToSkip--;
         return false;
     }
+    Scan->Left--;
     return true;
 }
 
-static bool matchFilterAndAttributeType(enum FILTER_TYPE FT, enum DATA_TYPE AT) {
-    if (AT == INT)
-        return FT == INT_FILTER;
-    if (AT == FLOAT)
-        return FT == FLOAT_FILTER;
-    if (AT == BOOL)
-        return FT == BOOL_FILTER;
-    if (AT == STRING)
-        return FT == STRING_FILTER;
-    return false;
+// Returns how many of at most Count nodes starting with First at NodeAddr lie
+// in one run of the block directory, Next is set to the link of the last of
+// them. A node the directory places elsewhere is counted alone.
+static size_t countAdjacentNodes(const struct StorageController *const Controller,
+                                 const struct NodeScan *const Scan, const struct AddrInfo NodeAddr,
+                                 const struct Node *const First, const size_t Count,
+                                 const size_t FullNodeSize, struct AddrInfo *const Next) {
+    const struct BlockDirectory *const Directory = getNodeBlocks(Controller, Scan);
+    const size_t Index = blockDirectoryFindEntry(Controller, Directory, First->Slot);
+    *Next = unpackAddr(First->Next);
+    if (Index == Directory->Used) {
+        return 1;
+    }
+    struct BlockDirectoryEntry Entry;
+    blockDirectoryGetEntry(Controller, Directory, Index, &Entry);
+    if (!inOneBlock(Entry.Addr, NodeAddr) ||
+        Entry.Addr.DataOffset + (First->Slot - Entry.First) * FullNodeSize != NodeAddr.DataOffset) {
+        return 1;
+    }
+    size_t Adjacent = Entry.First + Entry.Count - First->Slot;
+    if (Count < Adjacent) {
+        Adjacent = Count;
+    }
+    const char *Records = getDataPointer(Controller->Allocator, NodeAddr);
+    struct PackedAddr LastNext;
+    memcpy(&LastNext, Records + (Adjacent - 1) * FullNodeSize + offsetof(struct Node, Next),
+           sizeof(LastNext));
+    *Next = unpackAddr(LastNext);
+    return Adjacent;
+}
+
+// Checks the nodes from the one at NodeAddr to the end of its chunk at once,
+// returns false if fewer than two of them lie one after another in the block.
+static bool nodeScanBeginRun(const struct StorageController *const Controller,
+                             struct NodeScan *const Scan, const struct AddrInfo NodeAddr,
+                             const struct Node *const First) {
+    const struct Graph *const Graph = &Scan->Graph;
+    size_t Count = GRAPH_NODES_PER_BLOCK - First->Slot % GRAPH_NODES_PER_BLOCK;
+    if (Scan->LastSlot - First->Slot + 1 < Count) {
+        Count = Scan->LastSlot - First->Slot + 1;
+    }
+    const size_t FullNodeSize = getNodeRecordSize(Graph);
+    struct AddrInfo Next;
+    Count = countAdjacentNodes(Controller, Scan, NodeAddr, First, Count, FullNodeSize, &Next);
+    if (Count < 2) {
+        return false;
+    }
+    const struct AddrInfo LastAddr = getOptionalFullAddr(
+            NodeAddr.BlockOffset, NodeAddr.DataOffset + (Count - 1) * FullNodeSize);
+    filterProgramMatchRun(Controller, &Scan->Program, NodeAddr, FullNodeSize, Count,
+                          Scan->RunMask);
+    Scan->RunAddr = NodeAddr;
+    Scan->RunCount = Count;
+    Scan->RunIndex = 0;
+    Scan->NodeAddr = isOptionalFullAddrsEq(LastAddr, Graph->LastNode) ? NULL_FULL_ADDR : Next;
+    return true;
 }
 
-static bool checkNodeMatchesFilter(const struct StorageController *const Controller,
-                                   const struct AddrInfo NodeAddr,
-                                   const struct Graph *const Graph,
-                                   const struct AddrInfo GraphAddr,
-                                   const struct AttributeFilter *const FilterChain) {
-    if (FilterChain == NULL) {
-        return true;
+// Stores up to Capacity addresses of matching nodes to Result and returns
+// their number, which is less than Capacity only if the scan is over.
+static size_t nodeScanNext(const struct StorageController *const Controller,
+                           struct NodeScan *const Scan, struct AddrInfo *const Result,
+                           const size_t Capacity) {
+    const struct Graph *const Graph = &Scan->Graph;
+    size_t GoodNodesCnt = 0;
+    while (Scan->CandidateIndex < Scan->CandidatesCnt && GoodNodesCnt < Capacity &&
+           Scan->Left > 0) {
+        const struct AddrInfo NodeAddr =
+                nodeIndexFind(Controller, Graph, Scan->CandidateIds[Scan->CandidateIndex++]);
+        if (!NodeAddr.HasValue) {
+            continue;
+        }
+        bool Matches = Scan->ExactCandidates;
+        if (!Matches) {
+            struct Node Candidate;
+            fetchData(Controller->Allocator, NodeAddr, sizeof(Candidate), &Candidate);
+            Matches = filterProgramMatches(Controller, &Scan->Program, &Candidate);
+        }
+        if (Matches && nodeScanTake(Scan)) {
+            Result[GoodNodesCnt] = NodeAddr;
+            GoodNodesCnt++;
+        }
     }
-    struct Node ToCheck;
-    fetchData(Controller->Allocator, NodeAddr, sizeof(ToCheck), &ToCheck);
-    const size_t AttributesSize = sizeof(struct Attribute) * Graph->AttributeCounter;
-    struct Attribute *Attributes = malloc(AttributesSize);
-    fetchData(Controller->Allocator, ToCheck.Attributes, AttributesSize, Attributes);
-    const struct AttributeFilter *Filter = FilterChain;
-    bool result = true;
-    while (Filter != NULL) {
-        if (Filter->Type == LINK_FILTER) {
-            if (Filter->Data.Link.Relation == HAS_LINK_TO) {
-                struct AddrInfo *LinkAddrs;
-                bool HasLink = false;
-                size_t NeighboursCnt = findNodeLinksByIdAndType(
-                        Controller, GraphAddr, BY_LEFT_NODE_ID, ToCheck.Id, &LinkAddrs);
-                for (size_t i = 0; i < NeighboursCnt; ++i) {
-                    struct NodeLink Link;
-                    fetchData(Controller->Allocator, LinkAddrs[i], sizeof(Link), &Link);
-                    if (Link.RightNodeId == Filter->Data.Link.NodeId) {
-                        if (matchFloatFilter(&(Filter->Data.Link.WeightFilter), Link.Weight)) {
-                            HasLink = true;
-                            break;
-                        }
-                    }
-                }
-                free(LinkAddrs);
-                if (!HasLink) {
-                    NeighboursCnt = findNodeLinksByIdAndType(
-                            Controller, GraphAddr, BY_RIGHT_NODE_ID, ToCheck.Id, &LinkAddrs);
-                    for (size_t i = 0; i < NeighboursCnt; ++i) {
-                        struct NodeLink Link;
-                        fetchData(Controller->Allocator, LinkAddrs[i], sizeof(Link), &Link);
-                        if (Link.LeftNodeId == Filter->Data.Link.NodeId &&
-                            Link.Type == UNIDIRECTIONAL) {
-                            if (matchFloatFilter(&(Filter->Data.Link.WeightFilter),
-                                                 Link.Weight)) {
-                                HasLink = true;
-                                break;
-                            }
-                        }
-                    }
-                    free(LinkAddrs);
-                }
-                if (!HasLink) {
-                    result = false;
-                    break;
+    const size_t FullNodeSize = getNodeRecordSize(Graph);
+    while ((Scan->RunIndex < Scan->RunCount || Scan->NodeAddr.HasValue) &&
+           GoodNodesCnt < Capacity && Scan->Left > 0) {
+        if (Scan->RunIndex < Scan->RunCount) {
+            const uint64_t Rest = Scan->RunMask[Scan->RunIndex / 64] >> (Scan->RunIndex % 64);
+            if (Rest == 0) {
+                Scan->RunIndex = (Scan->RunIndex / 64 + 1) * 64;
+                if (Scan->RunIndex > Scan->RunCount) {
+                    Scan->RunIndex = Scan->RunCount;
                 }
+                continue;
             }
-            if (Filter->Data.Link.Relation == HAS_LINK_FROM) {
-                struct AddrInfo *LinkAddrs;
-                bool HasLink = false;
-                size_t NeighboursCnt = findNodeLinksByIdAndType(
-                        Controller, GraphAddr, BY_RIGHT_NODE_ID, ToCheck.Id, &LinkAddrs);
-                for (size_t i = 0; i < NeighboursCnt; ++i) {
-                    struct NodeLink Link;
-                    fetchData(Controller->Allocator, LinkAddrs[i], sizeof(Link), &Link);
-                    if (Link.LeftNodeId == Filter->Data.Link.NodeId) {
-                        if (matchFloatFilter(&(Filter->Data.Link.WeightFilter), Link.Weight)) {
-                            HasLink = true;
-                            break;
-                        }
-                    }
-                }
-                free(LinkAddrs);
-                if (!HasLink) {
-                    NeighboursCnt = findNodeLinksByIdAndType(
-                            Controller, GraphAddr, BY_LEFT_NODE_ID, ToCheck.Id, &LinkAddrs);
-                    for (size_t i = 0; i < NeighboursCnt; ++i) {
-                        struct NodeLink Link;
-                        fetchData(Controller->Allocator, LinkAddrs[i], sizeof(Link), &Link);
-                        if (Link.RightNodeId == Filter->Data.Link.NodeId &&
-                            Link.Type == UNIDIRECTIONAL) {
-                            if (matchFloatFilter(&(Filter->Data.Link.WeightFilter),
-                                                 Link.Weight)) {
-                                HasLink = true;
-                                break;
-                            }
-                        }
-                    }
-                    free(LinkAddrs);
-                }
-                if (!HasLink) {
-                    result = false;
-                    break;
-                }
+            Scan->RunIndex += __builtin_ctzll(Rest);
+            const size_t Index = Scan->RunIndex++;
+            if (nodeScanTake(Scan)) {
+                Result[GoodNodesCnt] = getOptionalFullAddr(
+                        Scan->RunAddr.BlockOffset, Scan->RunAddr.DataOffset + Index * FullNodeSize);
+                GoodNodesCnt++;
             }
-            Filter = Filter->Next;
             continue;
         }
-        if (Graph->AttributeCounter == 0) {
-            return false;
+        const struct AddrInfo NodeAddr = Scan->NodeAddr;
+        struct Node ToCheck;
+        fetchData(Controller->Allocator, NodeAddr, sizeof(ToCheck), &ToCheck);
+        if (Scan->UseZoneMaps && ToCheck.Slot % GRAPH_NODES_PER_BLOCK == 0 &&
+            !zoneMapMayMatch(Controller, Graph, ToCheck.Slot / GRAPH_NODES_PER_BLOCK,
+                             Scan->FilterChain)) {
+            if (ToCheck.Slot / GRAPH_NODES_PER_BLOCK == Scan->LastSlot / GRAPH_NODES_PER_BLOCK) {
+                Scan->NodeAddr = NULL_FULL_ADDR;
+                break;
+            }
+            Scan->NodeAddr = blockDirectoryFind(Controller, getNodeBlocks(Controller, Scan),
+                                                ToCheck.Slot + GRAPH_NODES_PER_BLOCK,
+                                                FullNodeSize);
+            continue;
         }
-        for (size_t i = 0; i < Graph->AttributeCounter; ++i) {
-            if (Attributes[i].Id == Filter->AttributeId &&
-                matchFilterAndAttributeType(Filter->Type, Attributes[i].Type)) {
-                if (Filter->Type == BOOL_FILTER) {
-                    if (Attributes[i].Value.BoolValue != Filter->Data.Bool.Value) {
-                        result = false;
-                        break;
-                    }
-                    continue;
-                }
-                if (Filter->Type == INT_FILTER) {
-                    if (!matchIntFilter(&(Filter->Data.Int), Attributes[i].Value.IntValue)) {
-                        result = false;
-                        break;
-                    }
-                    continue;
-                }
-                if (Filter->Type == FLOAT_FILTER) {
-                    if (!matchFloatFilter(&(Filter->Data.Float),
-                                          Attributes[i].Value.FloatValue)) {
-                        result = false;
-                        break;
-                    }
-                    continue;
-                }
-                if (Filter->Type == STRING_FILTER) {
-                    struct MyString AttributeString = Attributes[i].Value.StringValue;
-                    if (Filter->Data.String.Type == STRLEN_RANGE) {
-                        const size_t AttributeStringLength = AttributeString.Length;
-                        if (!matchIntFilter(&(Filter->Data.String.Data.StrlenRange),
-                                            AttributeStringLength)) {
-                            result = false;
-                            break;
-                        }
-                        continue;
-                    }
-                    if (Filter->Data.String.Type == STRING_EQUAL) {
-                        char *AttributeStringStr = malloc(AttributeString.Length + 1);
-                        if (AttributeString.Length > SMALL_STRING_LIMIT) {
-                            fetchData(Controller->Allocator, AttributeString.Data.DataPtr,
-                                      AttributeString.Length + 1, AttributeStringStr);
-                        } else {
-                            memcpy(AttributeStringStr, AttributeString.Data.InlinedData,
-                                   AttributeString.Length + 1);
-                        }
-                        if (strcmp(AttributeStringStr, Filter->Data.String.Data.StringEqual) !=
-                            0) {
-                            result = false;
-                        }
-                        free(AttributeStringStr);
-                        if (!result)
-                            break;
-                        continue;
-                    }
-                }
+        if (Scan->UseRuns && nodeScanBeginRun(Controller, Scan, NodeAddr, &ToCheck)) {
+            continue;
+        }
+        if (!ToCheck.Deleted && filterProgramMatches(Controller, &Scan->Program, &ToCheck) &&
+            nodeScanTake(Scan)) {
+            Result[GoodNodesCnt] = NodeAddr;
+            GoodNodesCnt++;
+        }
+        if (!isOptionalFullAddrsEq(NodeAddr, Graph->LastNode)) {
+            Scan->NodeAddr = unpackAddr(ToCheck.Next);
+        } else {
+            Scan->NodeAddr = NULL_FULL_ADDR;
+        }
+    }
+    return GoodNodesCnt;
+}
+
+static void nodeScanEnd(struct NodeScan *const Scan) {
+    filterProgramFree(&Scan->Program);
+    free(Scan->CandidateIds);
+    Scan->CandidateIds = NULL;
+}
+
+// Part of the node chain lying one after another in a block, checked by one
+// task of a parallel scan.
+struct ScanPiece {
+    struct AddrInfo Addr;
+    size_t Count;
+    // Zone maps rule out matches in the piece
+    bool Skipped;
+    uint64_t Mask[FILTER_RUN_WORDS];
+};
+
+struct ParallelScan {
+    const struct StorageController *Controller;
+    const struct NodeScan *Scan;
+    struct ScanPiece *Pieces;
+    size_t FullNodeSize;
+};
+
+static bool nodeScanCanSplit(const struct StorageController *const Controller,
+                             const struct NodeScan *const Scan) {
+    return workerPoolGetSize(Controller->Workers) > 1 && !Scan->ByIndex &&
+           Scan->NodeAddr.HasValue && Scan->RunIndex == Scan->RunCount && Scan->ToSkip == 0 &&
+           Scan->Left == SIZE_MAX && Scan->LastSlot >= GRAPH_NODES_PER_BLOCK;
+}
+
+// Cuts the rest of the chain into pieces along the runs of the block
+// directory, ending them at chunk ends too. Returns the number of pieces and
+// moves Scan->NodeAddr past the last one, leaves it as it is and returns 0 if
+// the directory does not know the next node.
+static size_t nodeScanSplit(const struct StorageController *const Controller,
+                            struct NodeScan *const Scan, const size_t FullNodeSize,
+                            struct ScanPiece **Pieces) {
+    const struct Graph *const Graph = &Scan->Graph;
+    const struct BlockDirectory *const Directory = getNodeBlocks(Controller, Scan);
+    struct Node First;
+    fetchData(Controller->Allocator, Scan->NodeAddr, sizeof(First), &First);
+    size_t Slot = First.Slot;
+    size_t Index = blockDirectoryFindEntry(Controller, Directory, Slot);
+    if (Index == Directory->Used || Slot > Scan->LastSlot ||
+        !isOptionalFullAddrsEq(blockDirectoryFind(Controller, Directory, Slot, FullNodeSize),
+                               Scan->NodeAddr)) {
+        *Pieces = NULL;
+        return 0;
+    }
+    size_t Capacity = Directory->Used + (Scan->LastSlot - Slot) / GRAPH_NODES_PER_BLOCK + 1;
+    *Pieces = malloc(sizeof(struct ScanPiece) * Capacity);
+    size_t PiecesCnt = 0;
+    struct BlockDirectoryEntry Entry;
+    blockDirectoryGetEntry(Controller, Directory, Index, &Entry);
+    while (Slot <= Scan->LastSlot) {
+        if (Slot == Entry.First + Entry.Count) {
+            if (++Index == Directory->Used) {
+                break;
             }
+            blockDirectoryGetEntry(Controller, Directory, Index, &Entry);
         }
-        if (!result) {
-            break;
+        size_t End = (Slot / GRAPH_NODES_PER_BLOCK + 1) * GRAPH_NODES_PER_BLOCK;
+        if (Entry.First + Entry.Count < End) {
+            End = Entry.First + Entry.Count;
+        }
+        if (Scan->LastSlot + 1 < End) {
+            End = Scan->LastSlot + 1;
+        }
+        struct ScanPiece *const Piece = *Pieces + PiecesCnt++;
+        Piece->Addr = getOptionalFullAddr(
+                Entry.Addr.BlockOffset, Entry.Addr.DataOffset + (Slot - Entry.First) * FullNodeSize);
+        Piece->Count = End - Slot;
+        Piece->Skipped = Scan->UseZoneMaps &&
+                         !zoneMapMayMatch(Controller, Graph, Slot / GRAPH_NODES_PER_BLOCK,
+                                          Scan->FilterChain);
+        Slot = End;
+    }
+    Scan->NodeAddr = NULL_FULL_ADDR;
+    return PiecesCnt;
+}
+
+static void checkScanPiece(void *Context, const size_t Index) {
+    const struct ParallelScan *const Parallel = Context;
+    const struct StorageController *const Controller = Parallel->Controller;
+    const struct NodeScan *const Scan = Parallel->Scan;
+    struct ScanPiece *const Piece = Parallel->Pieces + Index;
+    memset(Piece->Mask, 0, sizeof(Piece->Mask));
+    if (Piece->Skipped) {
+        return;
+    }
+    if (Scan->UseRuns) {
+        filterProgramMatchRun(Controller, &Scan->Program, Piece->Addr, Parallel->FullNodeSize,
+                              Piece->Count, Piece->Mask);
+        return;
+    }
+    const char *const Records = getDataPointer(Controller->Allocator, Piece->Addr);
+    for (size_t i = 0; i < Piece->Count; ++i) {
+        const struct Node *const Node =
+                (const struct Node *) (Records + i * Parallel->FullNodeSize);
+        if (!Node->Deleted && filterProgramMatches(Controller, &Scan->Program, Node)) {
+            Piece->Mask[i / 64] |= (uint64_t) 1 << (i % 64);
         }
-        Filter = Filter->Next;
     }
-    free(Attributes);
-    return result;
 }
 
-size_t findNodesByFilters(const struct StorageController *const Controller,
-                          const struct AddrInfo GraphAddr,
-                          const struct AttributeFilter *AttributeFilterChain,
-                          struct AddrInfo **Result) {
-    struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+// Checks the pieces of the chain on the worker pool and appends the matches
+// to Result in chain order.
+static size_t nodeScanSplitAll(const struct StorageController *const Controller,
+                               struct NodeScan *const Scan, struct AddrInfo **Result,
+                               size_t *const ResultCapacity) {
+    const size_t FullNodeSize = getNodeRecordSize(&Scan->Graph);
+    struct ScanPiece *Pieces;
+    const size_t PiecesCnt = nodeScanSplit(Controller, Scan, FullNodeSize, &Pieces);
+    struct ParallelScan Parallel = {Controller, Scan, Pieces, FullNodeSize};
+    workerPoolRun(Controller->Workers, checkScanPiece, &Parallel, PiecesCnt);
     size_t GoodNodesCnt = 0;
-    struct AddrInfo NodeAddr = Graph.Nodes;
-    *Result = malloc(sizeof(struct AddrInfo) * GRAPH_NODES_PER_BLOCK);
-    size_t ResultCapacity = GRAPH_NODES_PER_BLOCK;
-    while (NodeAddr.HasValue) {
-        struct Node ToCheck;
-        fetchData(Controller->Allocator, NodeAddr, sizeof(ToCheck), &ToCheck);
-        if (!ToCheck.Deleted && checkNodeMatchesFilter(Controller, NodeAddr, &Graph, GraphAddr,
-                                                       AttributeFilterChain)) {
-            (*Result)[GoodNodesCnt] = NodeAddr;
-            GoodNodesCnt++;
+    for (size_t p = 0; p < PiecesCnt; ++p) {
+        const struct ScanPiece *const Piece = Pieces + p;
+        for (size_t w = 0; w * 64 < Piece->Count; ++w) {
+            for (uint64_t Bits = Piece->Mask[w]; Bits != 0; Bits &= Bits - 1) {
+                if (GoodNodesCnt == *ResultCapacity) {
+                    *ResultCapacity *= 2;
+                    *Result = realloc(*Result, *ResultCapacity * sizeof(struct AddrInfo));
+                }
+                const size_t i = w * 64 + __builtin_ctzll(Bits);
+                (*Result)[GoodNodesCnt++] = getOptionalFullAddr(
+                        Piece->Addr.BlockOffset, Piece->Addr.DataOffset + i * FullNodeSize);
+            }
+        }
+    }
+    free(Pieces);
+    return GoodNodesCnt;
+}
+
+static size_t nodeScanAll(const struct StorageController *const Controller,
+                          struct NodeScan *const Scan, struct AddrInfo **Result) {
+    size_t ResultCapacity = Scan->CandidatesCnt != 0 ? Scan->CandidatesCnt : GRAPH_NODES_PER_BLOCK;
+    if (Scan->Left < ResultCapacity) {
+        ResultCapacity = Scan->Left != 0 ? Scan->Left : 1;
+    }
+    *Result = malloc(sizeof(struct AddrInfo) * ResultCapacity);
+    size_t GoodNodesCnt = 0;
+    if (nodeScanCanSplit(Controller, Scan)) {
+        GoodNodesCnt = nodeScanSplitAll(Controller, Scan, Result, &ResultCapacity);
+    }
+    while (true) {
+        GoodNodesCnt += nodeScanNext(Controller, Scan, *Result + GoodNodesCnt,
+                                     ResultCapacity - GoodNodesCnt);
+        if (nodeScanIsOver(Scan)) {
+            break;
         }
-        if (GoodNodesCnt + 3 > ResultCapacity) {
+        if (GoodNodesCnt == ResultCapacity) {
             *Result = realloc(*Result, ResultCapacity * 2 * sizeof(struct AddrInfo));
             ResultCapacity = ResultCapacity * 2;
         }
-        if (!isOptionalFullAddrsEq(NodeAddr, Graph.LastNode)) {
-            NodeAddr = ToCheck.Next;
-        } else
-            break;
     }
     return GoodNodesCnt;
 }
 
+size_t findNodesByFilters(const struct StorageController *const Controller,
+                          const struct AddrInfo GraphAddr,
+                          const struct AttributeFilter *AttributeFilterChain,
+                          struct AddrInfo **Result) {
+    struct NodeScan Scan;
+    nodeScanBegin(Controller, GraphAddr, AttributeFilterChain, &Scan);
+    const size_t GoodNodesCnt = nodeScanAll(Controller, &Scan, Result);
+    nodeScanEnd(&Scan);
+    return GoodNodesCnt;
+}
+
 static bool checkNodeLinkMatchRequest(const struct NodeLink *const Link,
                                       const enum NodeLinkRequestType Type, const size_t Id) {
     return Type == ALL || (Type == BY_ID && Link->Id == Id) ||
@@ -315,46 +513,101 @@ static bool checkNodeLinkMatchRequest(const struct NodeLink *const Link,
            (Type == BY_RIGHT_NODE_ID && Link->RightNodeId == Id);
 }
 
-size_t findNodeLinksByIdAndType(const struct StorageController *Controller,
+// Links of a read request, the page starts after the token link and the first
+// Offset matches and holds at most Limit links if it is not 0. Adjacency lists
+// begin with the newest link, so their ids only go down and a token link that
+// is gone is passed by its id. Complete is set if no more links follow.
+static size_t findNodeLinksPage(const struct StorageController *Controller,
                                 const struct AddrInfo GraphAddr,
                                 const enum NodeLinkRequestType Type, const size_t Id,
-                                struct AddrInfo **Result) {
+                                const struct ResumeToken *const After, size_t Offset,
+                                const size_t Limit, struct AddrInfo **Result,
+                                bool *const Complete) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-    size_t Cnt = 0;
-    struct AddrInfo NodeLinkAddr = Graph.Links;
-    while (NodeLinkAddr.HasValue) {
-        struct NodeLink Link;
-        fetchData(Controller->Allocator, NodeLinkAddr, sizeof(Link), &Link);
-        if (!Link.Deleted && checkNodeLinkMatchRequest(&Link, Type, Id)) {
-            Cnt++;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    const bool Adjacent = Type == BY_LEFT_NODE_ID || Type == BY_RIGHT_NODE_ID;
+    const bool Outgoing = Type == BY_LEFT_NODE_ID;
+    struct AddrInfo LinkAddr = Graph.Links;
+    if (Adjacent) {
+        const struct AddrInfo NodeAddr = nodeIndexFind(Controller, &Graph, Id);
+        struct Node Node = {.OutLinks = NULL_PACKED_ADDR, .InLinks = NULL_PACKED_ADDR};
+        if (NodeAddr.HasValue) {
+            fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+        }
+        LinkAddr = Outgoing ? unpackAddr(Node.OutLinks) : unpackAddr(Node.InLinks);
+    }
+    struct NodeLink Link;
+    if (After != NULL && After->HasValue) {
+        bool Found = false;
+        if (After->Addr.HasValue) {
+            fetchData(Controller->Allocator, After->Addr, sizeof(Link), &Link);
+            // Deleted links keep their place in the chain but not in the lists
+            Found = Link.Id == After->Key &&
+                    (!Adjacent || (!Link.Deleted &&
+                                   (Outgoing ? Link.LeftNodeId : Link.RightNodeId) == Id));
+        }
+        if (Found && Adjacent) {
+            LinkAddr = Outgoing ? unpackAddr(Link.NextOutLink) : unpackAddr(Link.NextInLink);
+        } else if (Found) {
+            LinkAddr = isOptionalFullAddrsEq(After->Addr, Graph.LastLink) ? NULL_FULL_ADDR
+                                                                          : unpackAddr(Link.Next);
+        } else if (Adjacent) {
+            while (LinkAddr.HasValue) {
+                fetchData(Controller->Allocator, LinkAddr, sizeof(Link), &Link);
+                if (Link.Id < After->Key) {
+                    break;
+                }
+                LinkAddr = Outgoing ? unpackAddr(Link.NextOutLink) : unpackAddr(Link.NextInLink);
+            }
+        } else {
+            Offset += After->Passed;
         }
-        if (isOptionalFullAddrsEq(NodeLinkAddr, Graph.LastLink))
-            break;
-        NodeLinkAddr = Link.Next;
     }
-    *Result = malloc(sizeof(struct AddrInfo) * Cnt);
-    NodeLinkAddr = Graph.Links;
-    size_t Index = 0;
-    while (NodeLinkAddr.HasValue) {
-        struct NodeLink Link;
-        fetchData(Controller->Allocator, NodeLinkAddr, sizeof(Link), &Link);
-        if (!Link.Deleted && checkNodeLinkMatchRequest(&Link, Type, Id)) {
-            (*Result)[Index] = NodeLinkAddr;
-            Index++;
+    size_t Capacity = Limit != 0 && Limit < GRAPH_LINKS_PER_BLOCK ? Limit : GRAPH_LINKS_PER_BLOCK;
+    *Result = malloc(sizeof(struct AddrInfo) * Capacity);
+    size_t Cnt = 0;
+    *Complete = true;
+    while (LinkAddr.HasValue) {
+        fetchData(Controller->Allocator, LinkAddr, sizeof(Link), &Link);
+        if (!Link.Deleted && (Adjacent || checkNodeLinkMatchRequest(&Link, Type, Id))) {
+            if (Offset > 0) {
+                Offset--;
+            } else if (Limit != 0 && Cnt == Limit) {
+                *Complete = false;
+                break;
+            } else {
+                if (Cnt == Capacity) {
+                    Capacity *= 2;
+                    *Result = realloc(*Result, sizeof(struct AddrInfo) * Capacity);
+                }
+                (*Result)[Cnt] = LinkAddr;
+                Cnt++;
+            }
         }
-        if (isOptionalFullAddrsEq(NodeLinkAddr, Graph.LastLink))
+        if (Adjacent) {
+            LinkAddr = Outgoing ? unpackAddr(Link.NextOutLink) : unpackAddr(Link.NextInLink);
+        } else if (isOptionalFullAddrsEq(LinkAddr, Graph.LastLink)) {
             break;
-        NodeLinkAddr = Link.Next;
+        } else {
+            LinkAddr = unpackAddr(Link.Next);
+        }
     }
     return Cnt;
 }
 
+size_t findNodeLinksByIdAndType(const struct StorageController *Controller,
+                                const struct AddrInfo GraphAddr,
+                                const enum NodeLinkRequestType Type, const size_t Id,
+                                struct AddrInfo **Result) {
+    bool Complete;
+    return findNodeLinksPage(Controller, GraphAddr, Type, Id, NULL, 0, 0, Result, &Complete);
+}
+
 struct AddrInfo findNodeLinkAddrById(const struct StorageController *const Controller,
                                      const struct AddrInfo GraphAddr,
                                      const size_t Id) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
     struct AddrInfo NodeLinkAddr = Graph.Links;
     while (NodeLinkAddr.HasValue) {
         struct NodeLink Link;
@@ -362,7 +615,11 @@ struct AddrInfo findNodeLinkAddrById(const struct StorageController *const Contr
         if (Link.Id == Id && !Link.Deleted) {
             return NodeLinkAddr;
         }
-        NodeLinkAddr = Link.Next;
+        // Next of the last link points to the free slot after it
+        if (isOptionalFullAddrsEq(NodeLinkAddr, Graph.LastLink)) {
+            break;
+        }
+        NodeLinkAddr = unpackAddr(Link.Next);
     }
     return NULL_FULL_ADDR;
 }
@@ -370,20 +627,8 @@ struct AddrInfo findNodeLinkAddrById(const struct StorageController *const Contr
 struct AddrInfo findNodeAddrById(const struct StorageController *const Controller,
                                  const struct AddrInfo GraphAddr, size_t Id) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-    struct AddrInfo NodeAddr = Graph.Nodes;
-    while (NodeAddr.HasValue) {
-        struct Node Node;
-        fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
-        if (Node.Id == Id && !Node.Deleted) {
-            return NodeAddr;
-        }
-        if (!isOptionalFullAddrsEq(NodeAddr, Graph.LastNode)) {
-            NodeAddr = Node.Next;
-        } else
-            break;
-    }
-    return NULL_FULL_ADDR;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    return nodeIndexFind(Controller, &Graph, Id);
 }
 
 
@@ -392,15 +637,12 @@ struct MyString createString(struct StorageController *const Controller,
     size_t StringLength = strlen(String) + 1;
     struct MyString MyString;
     MyString.Length = StringLength;
-    if (StringLength < SMALL_STRING_LIMIT) {
+    if (StringLength <= SMALL_STRING_LIMIT) {
         memcpy(MyString.Data.InlinedData, String, StringLength);
-        MyString.Data.InlinedData[StringLength] = 0;
     } else {
         struct AddrInfo StringAddr = allocate(Controller->Allocator, StringLength);
-        storeData(Controller->Allocator, StringAddr, sizeof(struct MyString), &MyString);
-        MyString.Data.DataPtr = StringAddr;
-        size_t CharsWritten =
-                storeData(Controller->Allocator, MyString.Data.DataPtr, StringLength + 1, String);
+        MyString.Data.DataPtr = packAddr(StringAddr);
+        size_t CharsWritten = storeData(Controller->Allocator, StringAddr, StringLength, String);
         if (CharsWritten < StringLength) {
             perror("Error while writing string");
         }
@@ -452,15 +694,33 @@ static void writeGraphAttributesDescription(struct StorageController *const Cont
     } while (CurrentExternal != NULL);
 }
 
+// Size of the column region of a node block of a columnar graph.
+static size_t getColumnRegionSize(const struct CreateGraphRequest *const Request) {
+    size_t Size = COLUMN_BITMAP_SIZE;
+    const struct ExternalAttributeDescription *CurrentAttributeDescription =
+            (const struct ExternalAttributeDescription *)Request->AttributesDescription;
+    while (CurrentAttributeDescription != NULL) {
+        Size += GRAPH_NODES_PER_BLOCK * getColumnWidth(CurrentAttributeDescription->Type);
+        CurrentAttributeDescription =
+                (const struct ExternalAttributeDescription *)CurrentAttributeDescription->Next;
+    }
+    return Size;
+}
+
 size_t createGraph(struct StorageController *const Controller,
                    const struct CreateGraphRequest *const Request) {
     size_t Id = Controller->Storage.NextGraphId;
     const size_t AttributeDescriptionNumber = getAttributeDescriptionNumber(Request);
     const size_t NodeSize =
-            sizeof(struct Node) + sizeof(struct Attribute) * AttributeDescriptionNumber;
+            Request->Columnar
+                    ? sizeof(struct Node)
+                    : sizeof(struct Node) + sizeof(struct Attribute) * AttributeDescriptionNumber;
     const size_t GraphSize =
             sizeof(struct Graph) + sizeof(struct AttributeDescription) * AttributeDescriptionNumber;
-    const size_t BlockNodesSize = GRAPH_NODES_PER_BLOCK * NodeSize;
+    size_t BlockNodesSize = GRAPH_NODES_PER_BLOCK * NodeSize;
+    if (Request->Columnar) {
+        BlockNodesSize += getColumnRegionSize(Request);
+    }
     const size_t BlockLinksSize = GRAPH_LINKS_PER_BLOCK * sizeof(struct NodeLink);
     const size_t GraphAndDataSize = BlockNodesSize + BlockLinksSize + GraphSize;
     struct AddrInfo GraphAddr = allocate(Controller->Allocator, GraphAndDataSize);
@@ -492,7 +752,18 @@ size_t createGraph(struct StorageController *const Controller,
     Graph->PlacedLinks = 0;
     Graph->LazyDeletedNodeCounter = 0;
     Graph->LazyDeletedLinkCounter = 0;
+    Graph->NodeIndex = NULL_FULL_ADDR;
+    Graph->NodeIndexCapacity = 0;
+    Graph->NodeIndexUsed = 0;
+    Graph->AttributeIndexes = NULL_FULL_ADDR;
+    Graph->ZoneMaps = NULL_FULL_ADDR;
+    Graph->ZoneMapChunks = 0;
+    const struct BlockDirectory EmptyDirectory = {NULL_FULL_ADDR, 0, 0, 0};
+    Graph->NodeBlocks = EmptyDirectory;
+    Graph->LinkBlocks = EmptyDirectory;
+    Graph->Columnar = Request->Columnar;
     storeData(Controller->Allocator, GraphAddr, sizeof(struct Graph), Graph);
+    graphCatalogAdd(Controller, GraphAddr);
     increaseGraphNumber(Controller);
     if (!Controller->Storage.Graphs.HasValue) {
         updateFirstGraph(Controller, GraphAddr);
@@ -514,57 +785,46 @@ static struct AddrInfo getNewNodeAddr(struct StorageController *const Controller
         if (Graph->LastNode.HasValue) {
             struct Node LastNode;
             fetchData(Controller->Allocator, Graph->LastNode, sizeof(LastNode), &LastNode);
-            if (LastNode.Next.HasValue) {
-                return LastNode.Next;
+            if (unpackAddr(LastNode.Next).HasValue) {
+                return unpackAddr(LastNode.Next);
             }
         }
         return NULL_FULL_ADDR;
     }
-    const size_t NodesBlockSize =
-            (sizeof(struct Node) + sizeof(struct Attribute) * Graph->AttributeCounter) *
-            GRAPH_NODES_PER_BLOCK;
+    const size_t NodesBlockSize = getNodeBlockSize(Controller, Graph);
     struct Node LastNode;
     fetchData(Controller->Allocator, Graph->LastNode, sizeof(LastNode), &LastNode);
     const struct AddrInfo NewBlockAddr =
             allocate(Controller->Allocator, NodesBlockSize);
     Graph->NodesPlaceable = GRAPH_NODES_PER_BLOCK;
-    LastNode.Next = NewBlockAddr;
+    LastNode.Next = packAddr(NewBlockAddr);
     storeData(Controller->Allocator, Graph->LastNode, sizeof(LastNode), &LastNode);
     return NewBlockAddr;
 }
 
-static size_t createNodeByGraphAddr(struct StorageController *const Controller,
-                                    const struct AddrInfo Addr,
-                                    struct ExternalAttribute *Attributes) {
-    struct Graph Graph;
-    fetchData(Controller->Allocator, Addr, sizeof(Graph), &Graph);
-    struct Node NewNode;
-    const struct AddrInfo NewNodeAddr = getNewNodeAddr(Controller, &Graph);
-    const size_t AttributesSize = sizeof(struct Attribute) * Graph.AttributeCounter;
-    struct Attribute *AttributesToStore = malloc(AttributesSize);
-    const struct AddrInfo AttributesAddr = getOptionalFullAddr(
-            NewNodeAddr.BlockOffset, NewNodeAddr.DataOffset + sizeof(struct Node));
-    struct AttributeDescription *GraphAttributesDescription =
-            malloc(sizeof(struct AttributeDescription) * Graph.AttributeCounter);
-    fetchData(Controller->Allocator, Graph.AttributesDecription,
-              sizeof(struct AttributeDescription) * Graph.AttributeCounter,
-              GraphAttributesDescription);
-    for (size_t i = 0; i < Graph.AttributeCounter; ++i) {
+// Every attribute has to be declared by the graph and have its type.
+static bool checkAttributeTypes(const struct GraphCatalogEntry *const GraphEntry,
+                                const struct ExternalAttribute *const Attributes,
+                                const size_t AttributesNumber) {
+    for (size_t i = 0; i < AttributesNumber; ++i) {
         size_t AttributeId = Attributes[i].Id;
-        if (Attributes[i].Type != GraphAttributesDescription[AttributeId].Type) {
-            return 0;
+        if (AttributeId >= GraphEntry->Header.AttributeCounter ||
+            Attributes[i].Type != GraphEntry->Attributes[AttributeId].Type) {
+            return false;
         }
     }
-    for (size_t i = 0; i < Graph.AttributeCounter; ++i) {
+    return true;
+}
+
+// Builds the attribute records of a node, strings too long to be inlined are
+// written to the file.
+static void attributesFromExternal(struct StorageController *const Controller,
+                                   const size_t AttributeCounter,
+                                   const struct ExternalAttribute *const Attributes,
+                                   struct Attribute *const Result) {
+    for (size_t i = 0; i < AttributeCounter; ++i) {
         struct Attribute Attribute;
         Attribute.Id = Attributes[i].Id;
-        if (i != Graph.AttributeCounter - 1) {
-            Attribute.Next =
-                    getOptionalFullAddr(AttributesAddr.BlockOffset,
-                                        AttributesAddr.DataOffset + (i + 1) * sizeof(Attribute));
-        } else {
-            Attribute.Next = NULL_FULL_ADDR;
-        }
         Attribute.Type = Attributes[i].Type;
         if (Attribute.Type == INT) {
             Attribute.Value.IntValue = Attributes[i].Value.IntValue;
@@ -579,41 +839,67 @@ static size_t createNodeByGraphAddr(struct StorageController *const Controller,
             Attribute.Value.StringValue =
                     createString(Controller, Attributes[i].Value.StringAddr);
         }
-        AttributesToStore[i] = Attribute;
+        Result[i] = Attribute;
+    }
+}
+
+static size_t createNodeByGraphAddr(struct StorageController *const Controller,
+                                    const struct AddrInfo Addr,
+                                    struct ExternalAttribute *Attributes) {
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, Addr);
+    if (GraphEntry == NULL || !checkAttributeTypes(GraphEntry, Attributes,
+                                                   GraphEntry->Header.AttributeCounter)) {
+        return 0;
     }
-    storeData(Controller->Allocator, AttributesAddr, AttributesSize, AttributesToStore);
+    struct Graph Graph = GraphEntry->Header;
+    struct Node NewNode;
+    const struct AddrInfo NewNodeAddr = getNewNodeAddr(Controller, &Graph);
+    const size_t AttributesSize = sizeof(struct Attribute) * Graph.AttributeCounter;
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *AttributesToStore = arenaAlloc(Controller->Scratch, AttributesSize);
+    attributesFromExternal(Controller, Graph.AttributeCounter, Attributes, AttributesToStore);
     Graph.NodesPlaceable -= 1;
     Graph.PlacedNodes += 1;
     NewNode.Id = Controller->Storage.NextNodeId;
-    NewNode.Attributes = AttributesAddr;
+    NewNode.OutLinks = NULL_PACKED_ADDR;
+    NewNode.InLinks = NULL_PACKED_ADDR;
     if (Graph.NodesPlaceable > 0) {
-        const size_t FullNodeSize =
-                sizeof(struct Node) + Graph.AttributeCounter * sizeof(struct Attribute);
-        NewNode.Next =
-                getOptionalFullAddr(NewNodeAddr.BlockOffset, NewNodeAddr.DataOffset + FullNodeSize);
+        const size_t FullNodeSize = getNodeRecordSize(&Graph);
+        NewNode.Next = packAddr(getOptionalFullAddr(NewNodeAddr.BlockOffset,
+                                                    NewNodeAddr.DataOffset + FullNodeSize));
     } else {
-        NewNode.Next = NULL_FULL_ADDR;
+        NewNode.Next = NULL_PACKED_ADDR;
     }
     NewNode.Deleted = false;
     increaseNodeNumber(Controller);
     Graph.NodeCounter += 1;
+    nodeIndexInsert(Controller, &Graph, NewNode.Id, NewNodeAddr);
+    attributeIndexesAddNode(Controller, &Graph, NewNode.Id, AttributesToStore);
     if (!Graph.Nodes.HasValue) {
         Graph.Nodes = Graph.LastNode = NewNodeAddr;
-        storeData(Controller->Allocator, Addr, sizeof(Graph), &Graph);
-        NewNode.Previous = NULL_FULL_ADDR;
+        storeGraph(Controller, Addr, &Graph);
+        NewNode.Previous = NULL_PACKED_ADDR;
+        NewNode.Slot = 0;
     } else {
         struct Node OldLastNode;
         fetchData(Controller->Allocator, Graph.LastNode, sizeof(OldLastNode), &OldLastNode);
-        OldLastNode.Next = NewNodeAddr;
+        OldLastNode.Next = packAddr(NewNodeAddr);
         storeData(Controller->Allocator, Graph.LastNode, sizeof(OldLastNode), &OldLastNode);
-        NewNode.Previous = Graph.LastNode;
+        NewNode.Previous = packAddr(Graph.LastNode);
+        NewNode.Slot = OldLastNode.Slot + 1;
         Graph.LastNode = NewNodeAddr;
     }
-    storeData(Controller->Allocator, Addr, sizeof(Graph), &Graph);
+    NewNode.Attributes = packAddr(getNodeAttributesAddr(&Graph, NewNodeAddr, NewNode.Slot));
+    storeNodeAttributes(Controller, &Graph, &NewNode, AttributesToStore);
+    zoneMapPrepareSlot(Controller, &Graph, NewNode.Slot);
+    zoneMapAddNode(Controller, &Graph, NewNode.Slot, AttributesToStore);
+    blockDirectoryAppend(Controller, &Graph.NodeBlocks, NewNodeAddr, 1,
+                         getNodeRecordSize(&Graph));
+    storeGraph(Controller, Addr, &Graph);
     storeData(Controller->Allocator, NewNodeAddr, sizeof(NewNode), &NewNode);
 
-    free(AttributesToStore);
-    free(GraphAttributesDescription);
+    arenaRelease(Controller->Scratch, Mark);
     return NewNode.Id;
 }
 
@@ -624,6 +910,117 @@ size_t createNode(struct StorageController *const Controller,
     return createNodeByGraphAddr(Controller, GraphAddr, Request->Attributes);
 }
 
+// Fills the free slots of the last node block, then of newly allocated blocks,
+// one run of consecutive slots at a time. A run is built in memory and stored
+// with a single write, the graph header and the storage header are stored once
+// per call.
+size_t createNodesBulk(struct StorageController *const Controller,
+                       const struct CreateNodesBulkRequest *const Request) {
+    const struct AddrInfo GraphAddr =
+            findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    if (GraphEntry == NULL || Request->NodesNumber == 0) {
+        return 0;
+    }
+    const size_t AttributeCounter = GraphEntry->Header.AttributeCounter;
+    for (size_t k = 0; k < Request->NodesNumber; ++k) {
+        if (!checkAttributeTypes(GraphEntry, Request->Attributes + k * AttributeCounter,
+                                 AttributeCounter)) {
+            return 0;
+        }
+    }
+    struct Graph Graph = GraphEntry->Header;
+    const size_t AttributesSize = sizeof(struct Attribute) * AttributeCounter;
+    const size_t FullNodeSize = getNodeRecordSize(&Graph);
+    const size_t MaxRunLength = Request->NodesNumber < GRAPH_NODES_PER_BLOCK
+                                        ? Request->NodesNumber
+                                        : GRAPH_NODES_PER_BLOCK;
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    char *Run = arenaAlloc(Controller->Scratch, MaxRunLength * FullNodeSize);
+    struct Attribute *RunAttributes =
+            arenaAlloc(Controller->Scratch, MaxRunLength * AttributesSize);
+    const size_t FirstId = reserveNodeIds(Controller, Request->NodesNumber);
+    size_t Created = 0;
+    while (Created < Request->NodesNumber) {
+        const struct AddrInfo RunAddr = getNewNodeAddr(Controller, &Graph);
+        const size_t RunLength = Request->NodesNumber - Created < Graph.NodesPlaceable
+                                         ? Request->NodesNumber - Created
+                                         : Graph.NodesPlaceable;
+        struct AddrInfo PreviousAddr = NULL_FULL_ADDR;
+        size_t FirstSlot = 0;
+        if (Graph.Nodes.HasValue) {
+            struct Node OldLastNode;
+            fetchData(Controller->Allocator, Graph.LastNode, sizeof(OldLastNode), &OldLastNode);
+            OldLastNode.Next = packAddr(RunAddr);
+            storeData(Controller->Allocator, Graph.LastNode, sizeof(OldLastNode), &OldLastNode);
+            PreviousAddr = Graph.LastNode;
+            FirstSlot = OldLastNode.Slot + 1;
+        } else {
+            Graph.Nodes = RunAddr;
+        }
+        for (size_t i = 0; i < RunLength; ++i) {
+            const struct AddrInfo NodeAddr =
+                    getOptionalFullAddr(RunAddr.BlockOffset, RunAddr.DataOffset + i * FullNodeSize);
+            struct Node *const Node = (struct Node *) (Run + i * FullNodeSize);
+            struct Attribute *const Attributes = RunAttributes + i * AttributeCounter;
+            Node->Id = FirstId + Created + i;
+            Node->Deleted = false;
+            Node->Slot = FirstSlot + i;
+            Node->Previous = packAddr(PreviousAddr);
+            Node->Attributes = packAddr(getNodeAttributesAddr(&Graph, NodeAddr, Node->Slot));
+            if (i + 1 < RunLength || RunLength < Graph.NodesPlaceable) {
+                Node->Next = packAddr(getOptionalFullAddr(NodeAddr.BlockOffset,
+                                                 NodeAddr.DataOffset + FullNodeSize));
+            } else {
+                Node->Next = NULL_PACKED_ADDR;
+            }
+            Node->OutLinks = NULL_PACKED_ADDR;
+            Node->InLinks = NULL_PACKED_ADDR;
+            attributesFromExternal(Controller, AttributeCounter,
+                                   Request->Attributes + (Created + i) * AttributeCounter,
+                                   Attributes);
+            if (!Graph.Columnar) {
+                memcpy(Node + 1, Attributes, AttributesSize);
+            }
+            nodeIndexInsert(Controller, &Graph, Node->Id, NodeAddr);
+            attributeIndexesAddNode(Controller, &Graph, Node->Id, Attributes);
+            if (i == 0 || Node->Slot % GRAPH_NODES_PER_BLOCK == 0) {
+                zoneMapPrepareSlot(Controller, &Graph, Node->Slot);
+            }
+            PreviousAddr = NodeAddr;
+        }
+        zoneMapAddNodes(Controller, &Graph, FirstSlot, RunAttributes, RunLength);
+        storeData(Controller->Allocator, RunAddr, RunLength * FullNodeSize, Run);
+        if (Graph.Columnar) {
+            storeColumnsRun(Controller, &Graph, (const struct Node *) Run, RunLength,
+                            RunAttributes);
+        }
+        blockDirectoryAppend(Controller, &Graph.NodeBlocks, RunAddr, RunLength, FullNodeSize);
+        Graph.NodesPlaceable -= RunLength;
+        Graph.PlacedNodes += RunLength;
+        Graph.NodeCounter += RunLength;
+        Graph.LastNode = PreviousAddr;
+        Created += RunLength;
+    }
+    storeGraph(Controller, GraphAddr, &Graph);
+    arenaRelease(Controller->Scratch, Mark);
+    return FirstId;
+}
+
+// Appends a block of LinksNumber link slots to the link chain.
+static struct AddrInfo allocateLinkBlock(struct StorageController *const Controller,
+                                         struct Graph *const Graph, const size_t LinksNumber) {
+    struct NodeLink LastLink;
+    fetchData(Controller->Allocator, Graph->LastLink, sizeof(LastLink), &LastLink);
+    const struct AddrInfo NewBlockAddr =
+            allocate(Controller->Allocator, sizeof(struct NodeLink) * LinksNumber);
+    Graph->LinksPlaceable = LinksNumber;
+    LastLink.Next = packAddr(NewBlockAddr);
+    storeData(Controller->Allocator, Graph->LastLink, sizeof(LastLink), &LastLink);
+    return NewBlockAddr;
+}
+
 static struct AddrInfo getNewLinkAddr(struct StorageController *const Controller,
                                       struct Graph *const Graph) {
     if (Graph->LinksPlaceable > 0) {
@@ -635,27 +1032,114 @@ static struct AddrInfo getNewLinkAddr(struct StorageController *const Controller
         if (Graph->LastLink.HasValue) {
             struct NodeLink LastLink;
             fetchData(Controller->Allocator, Graph->LastLink, sizeof(LastLink), &LastLink);
-            if (LastLink.Next.HasValue) {
-                return LastLink.Next;
+            if (unpackAddr(LastLink.Next).HasValue) {
+                return unpackAddr(LastLink.Next);
             }
         }
         return NULL_FULL_ADDR;
     }
-    const size_t LinkBlockSize = sizeof(struct NodeLink) * GRAPH_LINKS_PER_BLOCK;
-    struct NodeLink LastLink;
-    fetchData(Controller->Allocator, Graph->LastLink, sizeof(LastLink), &LastLink);
-    const struct AddrInfo NewBlockAddr = allocate(Controller->Allocator, LinkBlockSize);
-    Graph->LinksPlaceable = GRAPH_NODES_PER_BLOCK;
-    LastLink.Next = NewBlockAddr;
-    storeData(Controller->Allocator, Graph->LastLink, sizeof(LastLink), &LastLink);
-    return NewBlockAddr;
+    return allocateLinkBlock(Controller, Graph, GRAPH_LINKS_PER_BLOCK);
+}
+
+static void setAdjacencyHead(const struct StorageController *const Controller,
+                             const struct Graph *const Graph, const size_t NodeId,
+                             const bool Outgoing, const struct AddrInfo LinkAddr) {
+    const struct AddrInfo NodeAddr = nodeIndexFind(Controller, Graph, NodeId);
+    if (!NodeAddr.HasValue) {
+        return;
+    }
+    struct Node Node;
+    fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+    if (Outgoing) {
+        Node.OutLinks = packAddr(LinkAddr);
+    } else {
+        Node.InLinks = packAddr(LinkAddr);
+    }
+    storeData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+}
+
+// Makes the neighbours of Link in both adjacency lists (or the endpoint nodes
+// when it is a list head) point to LinkAddr. Used to put a new link into the
+// lists and to follow a link record moved by vacuumation.
+static void attachLinkNeighbours(const struct StorageController *const Controller,
+                                 const struct Graph *const Graph,
+                                 const struct NodeLink *const Link,
+                                 const struct AddrInfo LinkAddr) {
+    const struct AddrInfo PrevOutLink = unpackAddr(Link->PrevOutLink);
+    const struct AddrInfo NextOutLink = unpackAddr(Link->NextOutLink);
+    const struct AddrInfo PrevInLink = unpackAddr(Link->PrevInLink);
+    const struct AddrInfo NextInLink = unpackAddr(Link->NextInLink);
+    struct NodeLink Neighbour;
+    if (PrevOutLink.HasValue) {
+        fetchData(Controller->Allocator, PrevOutLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.NextOutLink = packAddr(LinkAddr);
+        storeData(Controller->Allocator, PrevOutLink, sizeof(Neighbour), &Neighbour);
+    } else {
+        setAdjacencyHead(Controller, Graph, Link->LeftNodeId, true, LinkAddr);
+    }
+    if (NextOutLink.HasValue) {
+        fetchData(Controller->Allocator, NextOutLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.PrevOutLink = packAddr(LinkAddr);
+        storeData(Controller->Allocator, NextOutLink, sizeof(Neighbour), &Neighbour);
+    }
+    if (PrevInLink.HasValue) {
+        fetchData(Controller->Allocator, PrevInLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.NextInLink = packAddr(LinkAddr);
+        storeData(Controller->Allocator, PrevInLink, sizeof(Neighbour), &Neighbour);
+    } else {
+        setAdjacencyHead(Controller, Graph, Link->RightNodeId, false, LinkAddr);
+    }
+    if (NextInLink.HasValue) {
+        fetchData(Controller->Allocator, NextInLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.PrevInLink = packAddr(LinkAddr);
+        storeData(Controller->Allocator, NextInLink, sizeof(Neighbour), &Neighbour);
+    }
+}
+
+static void detachLinkNeighbours(const struct StorageController *const Controller,
+                                 const struct Graph *const Graph,
+                                 const struct NodeLink *const Link) {
+    const struct AddrInfo PrevOutLink = unpackAddr(Link->PrevOutLink);
+    const struct AddrInfo NextOutLink = unpackAddr(Link->NextOutLink);
+    const struct AddrInfo PrevInLink = unpackAddr(Link->PrevInLink);
+    const struct AddrInfo NextInLink = unpackAddr(Link->NextInLink);
+    struct NodeLink Neighbour;
+    if (PrevOutLink.HasValue) {
+        fetchData(Controller->Allocator, PrevOutLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.NextOutLink = Link->NextOutLink;
+        storeData(Controller->Allocator, PrevOutLink, sizeof(Neighbour), &Neighbour);
+    } else {
+        setAdjacencyHead(Controller, Graph, Link->LeftNodeId, true, NextOutLink);
+    }
+    if (NextOutLink.HasValue) {
+        fetchData(Controller->Allocator, NextOutLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.PrevOutLink = Link->PrevOutLink;
+        storeData(Controller->Allocator, NextOutLink, sizeof(Neighbour), &Neighbour);
+    }
+    if (PrevInLink.HasValue) {
+        fetchData(Controller->Allocator, PrevInLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.NextInLink = Link->NextInLink;
+        storeData(Controller->Allocator, PrevInLink, sizeof(Neighbour), &Neighbour);
+    } else {
+        setAdjacencyHead(Controller, Graph, Link->RightNodeId, false, NextInLink);
+    }
+    if (NextInLink.HasValue) {
+        fetchData(Controller->Allocator, NextInLink, sizeof(Neighbour), &Neighbour);
+        Neighbour.PrevInLink = Link->PrevInLink;
+        storeData(Controller->Allocator, NextInLink, sizeof(Neighbour), &Neighbour);
+    }
 }
 
 static size_t createNodeLinkByGraphAddr(struct StorageController *const Controller,
                                         struct AddrInfo GraphAddr,
                                         const struct CreateNodeLinkRequest *const Request) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
+    const struct AddrInfo LeftNodeAddr = nodeIndexFind(Controller, &Graph, Request->LeftNodeId);
+    const struct AddrInfo RightNodeAddr = nodeIndexFind(Controller, &Graph, Request->RightNodeId);
+    if (!LeftNodeAddr.HasValue || !RightNodeAddr.HasValue) {
+        return 0;
+    }
     struct AddrInfo NewLinkAddr = getNewLinkAddr(Controller, &Graph);
     struct NodeLink NewLink;
     Graph.LinksPlaceable -= 1;
@@ -663,41 +1147,36 @@ static size_t createNodeLinkByGraphAddr(struct StorageController *const Controll
     NewLink.Id = Controller->Storage.NextNodeLinkId;
     NewLink.Type = Request->Type;
     if (Graph.LinksPlaceable > 0) {
-        NewLink.Next = getOptionalFullAddr(NewLinkAddr.BlockOffset,
-                                           NewLinkAddr.DataOffset + sizeof(NewLink));
+        NewLink.Next = packAddr(getOptionalFullAddr(NewLinkAddr.BlockOffset,
+                                                    NewLinkAddr.DataOffset + sizeof(NewLink)));
     } else {
-        NewLink.Next = NULL_FULL_ADDR;
+        NewLink.Next = NULL_PACKED_ADDR;
     }
-    if (!Graph.Links.HasValue) {
-        Graph.Links = Graph.LastLink = NewLinkAddr;
-        storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-        NewLink.Previous = NULL_FULL_ADDR;
+    // getNewLinkAddr hands out the slot the last link already points to and
+    // repoints the last link itself when it has to take a new block
+    if (Graph.Links.HasValue) {
+        NewLink.Previous = packAddr(Graph.LastLink);
     } else {
-        struct NodeLink OldLastLink;
-        fetchData(Controller->Allocator, Graph.LastLink, sizeof(OldLastLink), &OldLastLink);
-        OldLastLink.Next = NewLinkAddr;
-        storeData(Controller->Allocator, Graph.LastLink, sizeof(OldLastLink), &OldLastLink);
-        NewLink.Previous = Graph.LastLink;
-        Graph.LastLink = NewLinkAddr;
-        storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+        Graph.Links = NewLinkAddr;
+        NewLink.Previous = NULL_PACKED_ADDR;
     }
     NewLink.LeftNodeId = Request->LeftNodeId;
     NewLink.RightNodeId = Request->RightNodeId;
     NewLink.Weight = Request->Weight;
     NewLink.Deleted = false;
-    if (Graph.LastLink.HasValue) {
-        struct NodeLink OldLast;
-        fetchData(Controller->Allocator, Graph.LastLink, sizeof(OldLast), &OldLast);
-        OldLast.Next = NewLinkAddr;
-        storeData(Controller->Allocator, Graph.LastLink, sizeof(OldLast), &OldLast);
-    }
+    struct Node Endpoint;
+    fetchData(Controller->Allocator, LeftNodeAddr, sizeof(Endpoint), &Endpoint);
+    NewLink.NextOutLink = Endpoint.OutLinks;
+    NewLink.PrevOutLink = NULL_PACKED_ADDR;
+    fetchData(Controller->Allocator, RightNodeAddr, sizeof(Endpoint), &Endpoint);
+    NewLink.NextInLink = Endpoint.InLinks;
+    NewLink.PrevInLink = NULL_PACKED_ADDR;
     storeData(Controller->Allocator, NewLinkAddr, sizeof(NewLink), &NewLink);
+    attachLinkNeighbours(Controller, &Graph, &NewLink, NewLinkAddr);
     Graph.LastLink = NewLinkAddr;
+    blockDirectoryAppend(Controller, &Graph.LinkBlocks, NewLinkAddr, 1, sizeof(struct NodeLink));
     Graph.LinkCounter += 1;
-    if (!Graph.Links.HasValue) {
-        Graph.Links = NewLinkAddr;
-    }
-    storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    storeGraph(Controller, GraphAddr, &Graph);
     increaseNodeLinkNumber(Controller);
     return NewLink.Id;
 }
@@ -709,10 +1188,254 @@ size_t createNodeLink(struct StorageController *const Controller,
     return createNodeLinkByGraphAddr(Controller, GraphAddr, Request);
 }
 
+// An endpoint of the links of a bulk insert with the heads its adjacency lists
+// will have. A head placed by the batch is kept as an index into the batch.
+struct LinkEndpoint {
+    size_t NodeId;
+    struct AddrInfo NodeAddr;
+    struct AddrInfo OutHead;
+    struct AddrInfo InHead;
+    size_t OutHeadLink;
+    size_t InHeadLink;
+};
+
+#define NO_BATCH_LINK SIZE_MAX
+
+// Open addressing table of the distinct endpoints of a batch. Capacity is a
+// power of two at least twice the number of endpoints, so probing ends.
+struct LinkEndpointTable {
+    size_t Capacity;
+    struct LinkEndpoint *Endpoints;
+};
+
+static struct LinkEndpoint *findLinkEndpoint(const struct StorageController *const Controller,
+                                             const struct Graph *const Graph,
+                                             struct LinkEndpointTable *const Table,
+                                             const size_t NodeId) {
+    size_t Position = NodeId * 0x9e3779b97f4a7c15ull >> 16 & (Table->Capacity - 1);
+    while (Table->Endpoints[Position].NodeAddr.HasValue) {
+        if (Table->Endpoints[Position].NodeId == NodeId) {
+            return Table->Endpoints + Position;
+        }
+        Position = (Position + 1) & (Table->Capacity - 1);
+    }
+    const struct AddrInfo NodeAddr = nodeIndexFind(Controller, Graph, NodeId);
+    if (!NodeAddr.HasValue) {
+        return NULL;
+    }
+    struct Node Node;
+    fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+    struct LinkEndpoint *const Endpoint = Table->Endpoints + Position;
+    Endpoint->NodeId = NodeId;
+    Endpoint->NodeAddr = NodeAddr;
+    Endpoint->OutHead = unpackAddr(Node.OutLinks);
+    Endpoint->InHead = unpackAddr(Node.InLinks);
+    Endpoint->OutHeadLink = NO_BATCH_LINK;
+    Endpoint->InHeadLink = NO_BATCH_LINK;
+    return Endpoint;
+}
+
+// Puts link Index of the batch at the head of an adjacency list of Endpoint,
+// the previous head gets its back pointer updated in Links or in the file.
+static void pushAdjacencyHead(const struct StorageController *const Controller,
+                              struct LinkEndpoint *const Endpoint, struct NodeLink *const Links,
+                              const struct AddrInfo *const LinkAddrs, const size_t Index,
+                              const bool Outgoing) {
+    struct AddrInfo *const Head = Outgoing ? &Endpoint->OutHead : &Endpoint->InHead;
+    size_t *const HeadLink = Outgoing ? &Endpoint->OutHeadLink : &Endpoint->InHeadLink;
+    if (Outgoing) {
+        Links[Index].NextOutLink = packAddr(*Head);
+        Links[Index].PrevOutLink = NULL_PACKED_ADDR;
+    } else {
+        Links[Index].NextInLink = packAddr(*Head);
+        Links[Index].PrevInLink = NULL_PACKED_ADDR;
+    }
+    if (*HeadLink != NO_BATCH_LINK) {
+        if (Outgoing) {
+            Links[*HeadLink].PrevOutLink = packAddr(LinkAddrs[Index]);
+        } else {
+            Links[*HeadLink].PrevInLink = packAddr(LinkAddrs[Index]);
+        }
+    } else if (Head->HasValue) {
+        struct NodeLink OldHead;
+        fetchData(Controller->Allocator, *Head, sizeof(OldHead), &OldHead);
+        if (Outgoing) {
+            OldHead.PrevOutLink = packAddr(LinkAddrs[Index]);
+        } else {
+            OldHead.PrevInLink = packAddr(LinkAddrs[Index]);
+        }
+        storeData(Controller->Allocator, *Head, sizeof(OldHead), &OldHead);
+    }
+    *Head = LinkAddrs[Index];
+    *HeadLink = Index;
+}
+
+// Links are placed as consecutive createNodeLink calls would place them, but
+// a block allocated for the batch is big enough for all of its remaining
+// links. The records are built in memory and each run of consecutive slots is
+// stored with a single write. Endpoints are looked up once per distinct node
+// and every endpoint node is stored once with its final list heads.
+size_t createNodeLinksBulk(struct StorageController *const Controller,
+                           const struct CreateNodeLinksBulkRequest *const Request) {
+    const struct AddrInfo GraphAddr =
+            findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    if (GraphEntry == NULL || Request->LinksNumber == 0) {
+        return 0;
+    }
+    const size_t LinksNumber = Request->LinksNumber;
+    struct Graph Graph = GraphEntry->Header;
+    struct LinkEndpointTable Table = {.Capacity = 16};
+    while (Table.Capacity < 4 * LinksNumber) {
+        Table.Capacity *= 2;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    Table.Endpoints = arenaAlloc(Controller->Scratch, sizeof(struct LinkEndpoint) * Table.Capacity);
+    memset(Table.Endpoints, 0, sizeof(struct LinkEndpoint) * Table.Capacity);
+    struct LinkEndpoint **Lefts =
+            arenaAlloc(Controller->Scratch, sizeof(struct LinkEndpoint *) * LinksNumber);
+    struct LinkEndpoint **Rights =
+            arenaAlloc(Controller->Scratch, sizeof(struct LinkEndpoint *) * LinksNumber);
+    for (size_t i = 0; i < LinksNumber; ++i) {
+        Lefts[i] = findLinkEndpoint(Controller, &Graph, &Table, Request->Links[i].LeftNodeId);
+        Rights[i] = findLinkEndpoint(Controller, &Graph, &Table, Request->Links[i].RightNodeId);
+        if (Lefts[i] == NULL || Rights[i] == NULL) {
+            arenaRelease(Controller->Scratch, Mark);
+            return 0;
+        }
+    }
+    struct NodeLink *Links = arenaAlloc(Controller->Scratch, sizeof(struct NodeLink) * LinksNumber);
+    struct AddrInfo *LinkAddrs =
+            arenaAlloc(Controller->Scratch, sizeof(struct AddrInfo) * LinksNumber);
+    const size_t FirstId = reserveNodeLinkIds(Controller, LinksNumber);
+    size_t Placed = 0;
+    while (Placed < LinksNumber) {
+        size_t Left = LinksNumber - Placed;
+        if (Left > MAX_LINKS_PER_BULK_BLOCK) {
+            Left = MAX_LINKS_PER_BULK_BLOCK;
+        }
+        const struct AddrInfo RunAddr =
+                Graph.LinksPlaceable > 0
+                        ? getNewLinkAddr(Controller, &Graph)
+                        : allocateLinkBlock(Controller, &Graph,
+                                            Left > GRAPH_LINKS_PER_BLOCK ? Left
+                                                                         : GRAPH_LINKS_PER_BLOCK);
+        const size_t RunLength = Left < Graph.LinksPlaceable ? Left : Graph.LinksPlaceable;
+        struct AddrInfo PreviousAddr = NULL_FULL_ADDR;
+        if (Placed > 0) {
+            Links[Placed - 1].Next = packAddr(RunAddr);
+            PreviousAddr = Graph.LastLink;
+        } else if (Graph.Links.HasValue) {
+            // The last link already points to the run, see createNodeLinkByGraphAddr
+            PreviousAddr = Graph.LastLink;
+        } else {
+            Graph.Links = RunAddr;
+        }
+        for (size_t i = Placed; i < Placed + RunLength; ++i) {
+            const struct ExternalNodeLink *const External = Request->Links + i;
+            struct NodeLink *const Link = Links + i;
+            LinkAddrs[i] = getOptionalFullAddr(
+                    RunAddr.BlockOffset, RunAddr.DataOffset + (i - Placed) * sizeof(struct NodeLink));
+            Link->Id = FirstId + i;
+            Link->Deleted = false;
+            Link->LeftNodeId = External->LeftNodeId;
+            Link->RightNodeId = External->RightNodeId;
+            Link->Type = External->Type;
+            Link->Weight = External->Weight;
+            Link->Previous = packAddr(PreviousAddr);
+            if (i + 1 < Placed + RunLength || RunLength < Graph.LinksPlaceable) {
+                Link->Next = packAddr(getOptionalFullAddr(LinkAddrs[i].BlockOffset,
+                                                          LinkAddrs[i].DataOffset +
+                                                                  sizeof(struct NodeLink)));
+            } else {
+                Link->Next = NULL_PACKED_ADDR;
+            }
+            PreviousAddr = LinkAddrs[i];
+        }
+        blockDirectoryAppend(Controller, &Graph.LinkBlocks, RunAddr, RunLength,
+                             sizeof(struct NodeLink));
+        Graph.LinksPlaceable -= RunLength;
+        Graph.PlacedLinks += RunLength;
+        Graph.LastLink = PreviousAddr;
+        Placed += RunLength;
+    }
+    for (size_t i = 0; i < LinksNumber; ++i) {
+        pushAdjacencyHead(Controller, Lefts[i], Links, LinkAddrs, i, true);
+        pushAdjacencyHead(Controller, Rights[i], Links, LinkAddrs, i, false);
+    }
+    size_t RunStart = 0;
+    for (size_t i = 1; i <= LinksNumber; ++i) {
+        if (i == LinksNumber || LinkAddrs[i].BlockOffset != LinkAddrs[i - 1].BlockOffset ||
+            LinkAddrs[i].DataOffset != LinkAddrs[i - 1].DataOffset + sizeof(struct NodeLink)) {
+            storeData(Controller->Allocator, LinkAddrs[RunStart],
+                      (i - RunStart) * sizeof(struct NodeLink), Links + RunStart);
+            RunStart = i;
+        }
+    }
+    for (size_t i = 0; i < Table.Capacity; ++i) {
+        const struct LinkEndpoint *const Endpoint = Table.Endpoints + i;
+        if (!Endpoint->NodeAddr.HasValue) {
+            continue;
+        }
+        struct Node Node;
+        fetchData(Controller->Allocator, Endpoint->NodeAddr, sizeof(Node), &Node);
+        Node.OutLinks = packAddr(Endpoint->OutHead);
+        Node.InLinks = packAddr(Endpoint->InHead);
+        storeData(Controller->Allocator, Endpoint->NodeAddr, sizeof(Node), &Node);
+    }
+    Graph.LinkCounter += LinksNumber;
+    storeGraph(Controller, GraphAddr, &Graph);
+    arenaRelease(Controller->Scratch, Mark);
+    return FirstId;
+}
+
+bool createIndex(struct StorageController *const Controller,
+                 const struct CreateIndexRequest *const Request) {
+    const struct AddrInfo GraphAddr =
+            findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
+    if (!GraphAddr.HasValue) {
+        return false;
+    }
+    struct Graph Graph;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    if (Request->AttributeId >= Graph.AttributeCounter) {
+        return false;
+    }
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    const struct AddrInfo IndexAddr = attributeIndexCreate(
+            Controller, &Graph, Request->AttributeId,
+            GraphEntry->Attributes[Request->AttributeId].Type);
+    if (!IndexAddr.HasValue) {
+        return false;
+    }
+    storeGraph(Controller, GraphAddr, &Graph);
+    const size_t AttributesSize = sizeof(struct Attribute) * Graph.AttributeCounter;
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *Attributes = arenaAlloc(Controller->Scratch, AttributesSize);
+    struct AddrInfo NodeAddr = Graph.Nodes;
+    while (NodeAddr.HasValue) {
+        struct Node Node;
+        fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+        if (!Node.Deleted) {
+            fetchNodeAttributes(Controller, &Graph, &Node, Attributes);
+            attributeIndexAddNode(Controller, IndexAddr, Node.Id, Attributes,
+                                  Graph.AttributeCounter);
+        }
+        if (isOptionalFullAddrsEq(NodeAddr, Graph.LastNode)) {
+            break;
+        }
+        NodeAddr = unpackAddr(Node.Next);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+    return true;
+}
+
 void deleteString(const struct StorageController *const Controller,
                   const struct MyString String) {
     if (String.Length > SMALL_STRING_LIMIT) {
-        deallocate(Controller->Allocator, String.Data.DataPtr);
+        deallocateAfterReaders(Controller, unpackAddr(String.Data.DataPtr));
     }
 }
 
@@ -722,7 +1445,8 @@ static void supressLinksEnd(const struct StorageController *const Controller,
     struct NodeLink LinkC = *ToDelete;
     struct AddrInfo CurrAddr = Addr;
     while (LinkC.Deleted) {
-        struct AddrInfo PAddr = LinkC.Previous;
+        blockDirectoryRemoveLast(Controller, &Graph->LinkBlocks);
+        struct AddrInfo PAddr = unpackAddr(LinkC.Previous);
         if (isOptionalFullAddrsEq(PAddr, NULL_FULL_ADDR)) {
             Graph->Links = NULL_FULL_ADDR;
             Graph->LastLink = CurrAddr;
@@ -737,7 +1461,7 @@ static void supressLinksEnd(const struct StorageController *const Controller,
         if (inDifferentBlocks(CurrAddr, PAddr)) {
             deallocate(Controller->Allocator, CurrAddr);
             Graph->LinksPlaceable = 0;
-            LinkP.Next = NULL_FULL_ADDR;
+            LinkP.Next = NULL_PACKED_ADDR;
             storeData(Controller->Allocator, PAddr, sizeof(LinkP), &LinkP);
         }
         Graph->LastLink = PAddr;
@@ -749,7 +1473,7 @@ static void supressLinksEnd(const struct StorageController *const Controller,
 static void vacuumateLinks(const struct StorageController *const Controller,
                            const struct AddrInfo GraphAddr) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
     struct AddrInfo SpaceAddr = Graph.Links;
     if (!SpaceAddr.HasValue) {
         return;
@@ -757,9 +1481,9 @@ static void vacuumateLinks(const struct StorageController *const Controller,
     while (Graph.LazyDeletedLinkCounter != 0) {
         struct NodeLink Space;
         fetchData(Controller->Allocator, SpaceAddr, sizeof(Space), &Space);
-        while (!Space.Deleted && Space.Next.HasValue &&
+        while (!Space.Deleted && unpackAddr(Space.Next).HasValue &&
                !isOptionalFullAddrsEq(SpaceAddr, Graph.LastLink)) {
-            SpaceAddr = Space.Next;
+            SpaceAddr = unpackAddr(Space.Next);
             fetchData(Controller->Allocator, SpaceAddr, sizeof(Space), &Space);
         }
         if (!Space.Deleted) {
@@ -767,11 +1491,11 @@ static void vacuumateLinks(const struct StorageController *const Controller,
         }
         struct AddrInfo LoadAddr = SpaceAddr;
         struct NodeLink Load;
-        fetchData(Controller->Allocator, LoadAddr, sizeof(struct Node), &Load);
-        while (Load.Deleted && Load.Next.HasValue &&
+        fetchData(Controller->Allocator, LoadAddr, sizeof(Load), &Load);
+        while (Load.Deleted && unpackAddr(Load.Next).HasValue &&
                !isOptionalFullAddrsEq(LoadAddr, Graph.LastLink)) {
-            LoadAddr = Load.Next;
-            fetchData(Controller->Allocator, LoadAddr, sizeof(struct Node), &Load);
+            LoadAddr = unpackAddr(Load.Next);
+            fetchData(Controller->Allocator, LoadAddr, sizeof(Load), &Load);
         }
         if (Load.Deleted && isOptionalFullAddrsEq(Graph.LastLink, LoadAddr)) {
             supressLinksEnd(Controller, LoadAddr, &Graph, &Load);
@@ -784,60 +1508,55 @@ static void vacuumateLinks(const struct StorageController *const Controller,
         Load.Previous = Space.Previous;
         Load.Deleted = false;
         storeData(Controller->Allocator, SpaceAddr, sizeof(Load), &Load);
-        SpaceAddr = Space.Next;
+        attachLinkNeighbours(Controller, &Graph, &Load, SpaceAddr);
+        SpaceAddr = unpackAddr(Space.Next);
     }
-    storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    storeGraph(Controller, GraphAddr, &Graph);
 }
 
 static void deleteSingleNodeLink(const struct StorageController *const Controller,
                                  const struct AddrInfo Addr,
                                  const struct AddrInfo GraphAddr) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
     struct NodeLink ToDelete;
     fetchData(Controller->Allocator, Addr, sizeof(ToDelete), &ToDelete);
+    detachLinkNeighbours(Controller, &Graph, &ToDelete);
     Graph.LinkCounter -= 1;
     ToDelete.Deleted = true;
     Graph.LazyDeletedLinkCounter += 1;
     storeData(Controller->Allocator, Addr, sizeof(ToDelete), &ToDelete);
     if (isOptionalFullAddrsEq(Graph.LastLink, Addr)) {
-        if (isOptionalFullAddrsEq(ToDelete.Previous, NULL_FULL_ADDR)) {
+        if (isOptionalFullAddrsEq(unpackAddr(ToDelete.Previous), NULL_FULL_ADDR)) {
             Graph.Links = NULL_FULL_ADDR;
         } else {
-            Graph.LastLink = ToDelete.Previous;
+            Graph.LastLink = unpackAddr(ToDelete.Previous);
         }
         supressLinksEnd(Controller, Addr, &Graph, &ToDelete);
     }
-    storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    storeGraph(Controller, GraphAddr, &Graph);
 }
 
 static size_t deleteNodeLinksByNodeId(const struct StorageController *const Controller,
                                       const struct AddrInfo GraphAddr,
                                       const size_t NodeId, bool CheckLeft, bool CheckRight) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-    struct AddrInfo NodeLinkAddr = Graph.Links;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    const struct AddrInfo NodeAddr = nodeIndexFind(Controller, &Graph, NodeId);
     size_t deleted = 0;
-    while (NodeLinkAddr.HasValue) {
-        struct NodeLink Link;
-        fetchData(Controller->Allocator, NodeLinkAddr, sizeof(Link), &Link);
-        if (!Link.Deleted) {
-            struct AddrInfo OldAddr = NodeLinkAddr;
-            if ((CheckLeft && Link.LeftNodeId == NodeId) ||
-                (CheckRight && Link.RightNodeId == NodeId)) {
-                deleteSingleNodeLink(Controller, OldAddr, GraphAddr);
-                deleted++;
-                if (isOptionalFullAddrsEq(OldAddr, Graph.LastLink)) {
-                    break;
-                }
-                fetchData(Controller->Allocator, NodeLinkAddr, sizeof(Link), &Link);
-                fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-            } else if (isOptionalFullAddrsEq(OldAddr, Graph.LastLink)) {
-                break;
-            }
+    while (NodeAddr.HasValue) {
+        struct Node Node;
+        fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
+        if (CheckLeft && unpackAddr(Node.OutLinks).HasValue) {
+            deleteSingleNodeLink(Controller, unpackAddr(Node.OutLinks), GraphAddr);
+        } else if (CheckRight && unpackAddr(Node.InLinks).HasValue) {
+            deleteSingleNodeLink(Controller, unpackAddr(Node.InLinks), GraphAddr);
+        } else {
+            break;
         }
-        NodeLinkAddr = Link.Next;
+        deleted++;
     }
+    fetchGraph(Controller, GraphAddr, &Graph);
     if (Graph.LazyDeletedLinkCounter > Graph.PlacedLinks / 2) {
         vacuumateLinks(Controller, GraphAddr);
     }
@@ -850,22 +1569,25 @@ static void supressNodeEnd(const struct StorageController *const Controller,
     struct Node NodeC = *ToDelete;
     struct AddrInfo CAddr = Addr;
     while (NodeC.Deleted) {
-        struct AddrInfo PAddr = NodeC.Previous;
+        blockDirectoryRemoveLast(Controller, &Graph->NodeBlocks);
+        // The first node gives its slot back too, so blocks keep starting at
+        // slots divisible by GRAPH_NODES_PER_BLOCK
+        Graph->PlacedNodes -= 1;
+        Graph->LazyDeletedNodeCounter -= 1;
+        Graph->NodesPlaceable += 1;
+        struct AddrInfo PAddr = unpackAddr(NodeC.Previous);
         if (isOptionalFullAddrsEq(PAddr, NULL_FULL_ADDR)) {
             Graph->Nodes = NULL_FULL_ADDR;
             Graph->LastNode = CAddr;
             Graph->LastNode.HasValue = false;
             break;
         }
-        Graph->PlacedNodes -= 1;
-        Graph->LazyDeletedNodeCounter -= 1;
-        Graph->NodesPlaceable += 1;
         struct Node NodeP;
         fetchData(Controller->Allocator, PAddr, sizeof(NodeP), &NodeP);
         if (inDifferentBlocks(CAddr, PAddr)) {
             deallocate(Controller->Allocator, CAddr);
             Graph->NodesPlaceable = 0;
-            NodeP.Next = NULL_FULL_ADDR;
+            NodeP.Next = NULL_PACKED_ADDR;
             storeData(Controller->Allocator, PAddr, sizeof(NodeP), &NodeP);
         }
         Graph->LastNode = PAddr;
@@ -877,18 +1599,19 @@ static void supressNodeEnd(const struct StorageController *const Controller,
 static void vacuumateNodes(const struct StorageController *const Controller,
                            const struct AddrInfo GraphAddr) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
     struct AddrInfo SpaceAddr = Graph.Nodes;
     if (!SpaceAddr.HasValue) {
         return;
     }
-    size_t NodeSize = sizeof(struct Node) + sizeof(struct Attribute) * Graph.AttributeCounter;
+    size_t NodeSize = getNodeRecordSize(&Graph);
+    struct Attribute *Attributes = malloc(sizeof(struct Attribute) * Graph.AttributeCounter);
     while (Graph.LazyDeletedNodeCounter != 0) {
         struct Node Space;
         fetchData(Controller->Allocator, SpaceAddr, sizeof(Space), &Space);
-        while (!Space.Deleted && Space.Next.HasValue &&
+        while (!Space.Deleted && unpackAddr(Space.Next).HasValue &&
                !isOptionalFullAddrsEq(SpaceAddr, Graph.LastNode)) {
-            SpaceAddr = Space.Next;
+            SpaceAddr = unpackAddr(Space.Next);
             fetchData(Controller->Allocator, SpaceAddr, sizeof(Space), &Space);
         }
         if (!Space.Deleted) {
@@ -897,9 +1620,9 @@ static void vacuumateNodes(const struct StorageController *const Controller,
         struct AddrInfo LoadAddr = SpaceAddr;
         struct Node *Load = malloc(NodeSize);
         fetchData(Controller->Allocator, LoadAddr, sizeof(struct Node), Load);
-        while (Load->Deleted && Load->Next.HasValue &&
+        while (Load->Deleted && unpackAddr(Load->Next).HasValue &&
                !isOptionalFullAddrsEq(LoadAddr, Graph.LastNode)) {
-            LoadAddr = Load->Next;
+            LoadAddr = unpackAddr(Load->Next);
             fetchData(Controller->Allocator, LoadAddr, sizeof(struct Node), Load);
         }
         if (Load->Deleted && isOptionalFullAddrsEq(Graph.LastNode, LoadAddr)) {
@@ -910,14 +1633,22 @@ static void vacuumateNodes(const struct StorageController *const Controller,
         fetchData(Controller->Allocator, LoadAddr, NodeSize, Load);
         Load->Deleted = true;
         storeData(Controller->Allocator, LoadAddr, NodeSize, Load);
+        const struct Node Loaded = *Load;
         Load->Next = Space.Next;
         Load->Previous = Space.Previous;
+        Load->Attributes = Space.Attributes;
+        Load->Slot = Space.Slot;
         Load->Deleted = false;
         storeData(Controller->Allocator, SpaceAddr, NodeSize, Load);
-        SpaceAddr = Space.Next;
+        moveNodeAttributes(Controller, &Graph, &Loaded, Load);
+        nodeIndexInsert(Controller, &Graph, Load->Id, SpaceAddr);
+        fetchNodeAttributes(Controller, &Graph, Load, Attributes);
+        zoneMapAddNode(Controller, &Graph, Space.Slot, Attributes);
+        SpaceAddr = unpackAddr(Space.Next);
         free(Load);
     }
-    storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    free(Attributes);
+    storeGraph(Controller, GraphAddr, &Graph);
 }
 
 static size_t deleteSingleNode(const struct StorageController *const Controller,
@@ -927,36 +1658,43 @@ static size_t deleteSingleNode(const struct StorageController *const Controller,
     struct Graph Graph;
     fetchData(Controller->Allocator, Addr, sizeof(ToDelete), &ToDelete);
     deleteNodeLinksByNodeId(Controller, GraphAddr, ToDelete.Id, true, true);
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchData(Controller->Allocator, Addr, sizeof(ToDelete), &ToDelete);
+    fetchGraph(Controller, GraphAddr, &Graph);
     Graph.NodeCounter -= 1;
+    nodeIndexRemove(Controller, &Graph, ToDelete.Id);
     size_t AttributesSize = sizeof(struct Attribute) * Graph.AttributeCounter;
-    struct Attribute *Attributes = malloc(AttributesSize);
-    fetchData(Controller->Allocator, ToDelete.Attributes, AttributesSize, Attributes);
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *Attributes = arenaAlloc(Controller->Scratch, AttributesSize);
+    fetchNodeAttributes(Controller, &Graph, &ToDelete, Attributes);
+    attributeIndexesRemoveNode(Controller, &Graph, ToDelete.Id, Attributes);
     for (size_t i = 0; i < Graph.AttributeCounter; ++i) {
         if (Attributes[i].Type == STRING) {
             deleteString(Controller, Attributes[i].Value.StringValue);
         }
     }
-    free(Attributes);
+    arenaRelease(Controller->Scratch, Mark);
     ToDelete.Deleted = true;
     Graph.LazyDeletedNodeCounter += 1;
     storeData(Controller->Allocator, Addr, sizeof(ToDelete), &ToDelete);
-    if (isOptionalFullAddrsEq(Graph.LastNode, Addr)) {
-        if (isOptionalFullAddrsEq(ToDelete.Previous, NULL_FULL_ADDR)) {
+    columnStoreRemoveNode(Controller, &Graph, &ToDelete);
+    // Under pinned readers the last node stays in the chain like any other
+    // lazily deleted one
+    if (isOptionalFullAddrsEq(Graph.LastNode, Addr) && !isReadEpochPinned(Controller)) {
+        if (isOptionalFullAddrsEq(unpackAddr(ToDelete.Previous), NULL_FULL_ADDR)) {
             Graph.Nodes = NULL_FULL_ADDR;
         } else {
-            Graph.LastNode = ToDelete.Previous;
+            Graph.LastNode = unpackAddr(ToDelete.Previous);
         }
         supressNodeEnd(Controller, Addr, &Graph, &ToDelete);
     }
-    storeData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    storeGraph(Controller, GraphAddr, &Graph);
     return 1;
 }
 
 static void deleteAllNodes(const struct StorageController *const Controller,
                            const struct AddrInfo GraphAddr) {
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    fetchGraph(Controller, GraphAddr, &Graph);
     const struct AddrInfo StartAddr = Graph.Nodes;
     if (!StartAddr.HasValue) {
         return;
@@ -966,45 +1704,52 @@ static void deleteAllNodes(const struct StorageController *const Controller,
         struct Node CurrentNode;
         fetchData(Controller->Allocator, NodeAddr, sizeof(CurrentNode), &CurrentNode);
         struct AddrInfo OldAddr = NodeAddr;
-        deleteSingleNode(Controller, OldAddr, GraphAddr);
+        // Lazily deleted nodes already gave back their strings
+        if (!CurrentNode.Deleted) {
+            deleteSingleNode(Controller, OldAddr, GraphAddr);
+        }
         if (isOptionalFullAddrsEq(Graph.LastNode, NodeAddr))
             break;
-        NodeAddr = CurrentNode.Next;
+        NodeAddr = unpackAddr(CurrentNode.Next);
     }
 }
 
 size_t deleteGraph(struct StorageController *const Controller,
                    const struct DeleteGraphRequest *const Request) {
     struct AddrInfo GraphAddr = findGraphAddrByName(Controller, Request->Name);
+    if (!GraphAddr.HasValue) {
+        return 0;
+    }
     struct Graph ToDelete;
     struct Graph BeforeDeleted;
     struct Graph AfterDeleted;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(ToDelete), &ToDelete);
+    fetchGraph(Controller, GraphAddr, &ToDelete);
     if (ToDelete.Previous.HasValue) {
-        fetchData(Controller->Allocator, ToDelete.Previous, sizeof(BeforeDeleted),
-                  &BeforeDeleted);
+        fetchGraph(Controller, ToDelete.Previous, &BeforeDeleted);
         BeforeDeleted.Next = ToDelete.Next;
-        storeData(Controller->Allocator, ToDelete.Previous, sizeof(BeforeDeleted),
-                  &BeforeDeleted);
+        storeGraph(Controller, ToDelete.Previous, &BeforeDeleted);
     }
     if (ToDelete.Next.HasValue) {
-        fetchData(Controller->Allocator, ToDelete.Next, sizeof(AfterDeleted), &AfterDeleted);
+        fetchGraph(Controller, ToDelete.Next, &AfterDeleted);
         AfterDeleted.Previous = ToDelete.Previous;
-        storeData(Controller->Allocator, ToDelete.Next, sizeof(AfterDeleted), &AfterDeleted);
+        storeGraph(Controller, ToDelete.Next, &AfterDeleted);
     }
-    if (ToDelete.AttributesDecription.HasValue) {
-        struct AttributeDescription *GraphAttributeDescriptions =
-                malloc(ToDelete.AttributeCounter * sizeof(struct AttributeDescription));
-        fetchData(Controller->Allocator, ToDelete.AttributesDecription,
-                  ToDelete.AttributeCounter * sizeof(struct AttributeDescription),
-                  GraphAttributeDescriptions);
-        for (size_t i = 0; i < ToDelete.AttributeCounter; ++i) {
-            deleteString(Controller, GraphAttributeDescriptions[i].Name);
-        }
-        free(GraphAttributeDescriptions);
+    const struct AttributeDescription *const GraphAttributeDescriptions =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr)->Attributes;
+    for (size_t i = 0; i < ToDelete.AttributeCounter; ++i) {
+        deleteString(Controller, GraphAttributeDescriptions[i].Name);
     }
+    attributeIndexesDrop(Controller, &ToDelete);
+    storeGraph(Controller, GraphAddr, &ToDelete);
     deleteAllNodes(Controller, GraphAddr);
+    struct Graph Emptied;
+    fetchGraph(Controller, GraphAddr, &Emptied);
+    nodeIndexDrop(Controller, &Emptied);
+    zoneMapDrop(Controller, &Emptied);
+    blockDirectoryDrop(Controller, &Emptied.NodeBlocks);
+    blockDirectoryDrop(Controller, &Emptied.LinkBlocks);
     deleteString(Controller, ToDelete.Name);
+    graphCatalogRemove(Controller, GraphAddr);
     deallocate(Controller->Allocator, GraphAddr);
     decreaseGraphNumber(Controller);
     if (isOptionalFullAddrsEq(GraphAddr, Controller->Storage.Graphs)) {
@@ -1022,6 +1767,9 @@ size_t deleteNode(const struct StorageController *const Controller,
             findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
     if (Request->ById) {
         struct AddrInfo NodeAddr = findNodeAddrById(Controller, GraphAddr, Request->Id);
+        if (!NodeAddr.HasValue) {
+            return 0;
+        }
         deleteSingleNode(Controller, NodeAddr, GraphAddr);
         return 1;
     }
@@ -1033,8 +1781,9 @@ size_t deleteNode(const struct StorageController *const Controller,
     }
     free(NodesToDelete);
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-    if (Graph.LazyDeletedNodeCounter > Graph.PlacedNodes / 2 + 1) {
+    fetchGraph(Controller, GraphAddr, &Graph);
+    if (Graph.LazyDeletedNodeCounter > Graph.PlacedNodes / 2 + 1 &&
+        !isReadEpochPinned(Controller)) {
         vacuumateNodes(Controller, GraphAddr);
     }
     return NodesCnt;
@@ -1054,10 +1803,13 @@ size_t deleteNodeLink(const struct StorageController *const Controller,
     if (Request->Type == BY_ID) {
         struct AddrInfo NodeLinkAddr =
                 findNodeLinkAddrById(Controller, GraphAddr, Request->Id);
+        if (!NodeLinkAddr.HasValue) {
+            return 0;
+        }
         deleteSingleNodeLink(Controller, NodeLinkAddr, GraphAddr);
         ret = 1;
         struct Graph Graph;
-        fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+        fetchGraph(Controller, GraphAddr, &Graph);
         if (Graph.LazyDeletedLinkCounter > Graph.PlacedLinks / 2) {
             vacuumateLinks(Controller, GraphAddr);
         }
@@ -1070,10 +1822,13 @@ static void updateSingleNode(const struct StorageController *const Controller,
                              size_t UpdatedAttributesNumber,
                              struct ExternalAttribute *NewAttributes, struct Graph *Graph) {
     const size_t AttributesSize = sizeof(struct Attribute) * Graph->AttributeCounter;
-    struct Attribute *Attributes = malloc(AttributesSize);
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *Attributes = arenaAlloc(Controller->Scratch, AttributesSize);
+    struct Attribute *OldAttributes = arenaAlloc(Controller->Scratch, AttributesSize);
     struct Node ToUpdate;
     fetchData(Controller->Allocator, NodeAddr, sizeof(ToUpdate), &ToUpdate);
-    fetchData(Controller->Allocator, ToUpdate.Attributes, AttributesSize, Attributes);
+    fetchNodeAttributes(Controller, Graph, &ToUpdate, Attributes);
+    memcpy(OldAttributes, Attributes, AttributesSize);
     for (size_t i = 0; i < UpdatedAttributesNumber; ++i) {
         const size_t AttrId = NewAttributes[i].Id;
         if (Attributes[AttrId].Type == INT) {
@@ -1091,20 +1846,38 @@ static void updateSingleNode(const struct StorageController *const Controller,
         if (Attributes[AttrId].Type == STRING && NewAttributes[i].Type == STRING) {
             struct MyString NewString =
                     createString(Controller, NewAttributes[i].Value.StringAddr);
-            deleteString(Controller, Attributes[AttrId].Value.StringValue);
+            if (memcmp(&(Attributes[AttrId].Value.StringValue),
+                       &(OldAttributes[AttrId].Value.StringValue), sizeof(struct MyString)) != 0) {
+                deleteString(Controller, Attributes[AttrId].Value.StringValue);
+            }
             Attributes[AttrId].Value.StringValue = NewString;
         }
     }
-    storeData(Controller->Allocator, ToUpdate.Attributes, AttributesSize, Attributes);
-    free(Attributes);
+    storeNodeAttributes(Controller, Graph, &ToUpdate, Attributes);
+    // Replaced strings are freed only now, the indexes need the old values
+    attributeIndexesUpdateNode(Controller, Graph, ToUpdate.Id, OldAttributes, Attributes);
+    zoneMapAddNode(Controller, Graph, ToUpdate.Slot, Attributes);
+    for (size_t i = 0; i < Graph->AttributeCounter; ++i) {
+        if (Attributes[i].Type == STRING &&
+            memcmp(&(Attributes[i].Value.StringValue), &(OldAttributes[i].Value.StringValue),
+                   sizeof(struct MyString)) != 0) {
+            deleteString(Controller, OldAttributes[i].Value.StringValue);
+        }
+    }
+    arenaRelease(Controller->Scratch, Mark);
 }
 
 size_t updateNode(const struct StorageController *const Controller,
                   const struct UpdateNodeRequest *const Request) {
     const struct AddrInfo GraphAddr =
             findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
-    struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    if (GraphEntry == NULL || !checkAttributeTypes(GraphEntry, Request->Attributes,
+                                                   Request->UpdatedAttributesNumber)) {
+        return 0;
+    }
+    struct Graph Graph = GraphEntry->Header;
     if (Request->ById) {
         const struct AddrInfo NodeAddr =
                 findNodeAddrById(Controller, GraphAddr, Request->Id);
@@ -1136,6 +1909,9 @@ size_t updateNodeLink(const struct StorageController *const Controller,
             findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
     const struct AddrInfo NodeLinkAddr =
             findNodeLinkAddrById(Controller, GraphAddr, Request->Id);
+    if (!NodeLinkAddr.HasValue) {
+        return 0;
+    }
     struct NodeLink ToUpdate;
     fetchData(Controller->Allocator, NodeLinkAddr, sizeof(ToUpdate), &ToUpdate);
     ToUpdate.Type = Request->UpdateType ? Request->Type : ToUpdate.Type;
@@ -1144,12 +1920,24 @@ size_t updateNodeLink(const struct StorageController *const Controller,
     return 1;
 }
 
+// A streaming result set keeps its scan and buffers one batch of nodes in
+// NodeAddrs, moving back is only possible inside of the batch. Base is the
+// number of matches before the first node, counted for resume tokens.
 struct NodeResultSet {
     const struct StorageController *Controller;
     struct AddrInfo GraphAddr;
     size_t Cnt;
     size_t Index;
     struct AddrInfo *NodeAddrs;
+    struct NodeScan *Scan;
+    size_t Passed;
+    size_t Base;
+    bool ByIndex;
+    bool Complete;
+    size_t *Projection;
+    size_t ProjectionLength;
+    // Attributes of the last view of a columnar graph
+    struct Attribute *ViewAttributes;
 };
 
 struct NodeLinkResultSet {
@@ -1157,6 +1945,8 @@ struct NodeLinkResultSet {
     size_t Cnt;
     size_t Index;
     struct AddrInfo *LinkAddrs;
+    size_t Base;
+    bool Complete;
 };
 
 struct GraphResultSet {
@@ -1190,26 +1980,87 @@ static size_t getNodeStringsSize(const struct Attribute *const Attributes,
     return Result;
 }
 
+// Fetches the attributes with the given ids in their order and returns their
+// number, ids the node does not have are skipped. An attribute is looked for
+// at the position equal to its id first, as nodes are usually created with
+// attributes ordered by id. Otherwise all attributes are copied to the scratch
+// arena, the caller releases it.
+static size_t fetchProjectedAttributes(const struct StorageController *const Controller,
+                                       const struct Graph *const Graph,
+                                       const struct Node *const Node,
+                                       const size_t *const Projection,
+                                       const size_t ProjectionLength,
+                                       struct Attribute *const Result) {
+    const size_t AttributeCounter = Graph->AttributeCounter;
+    struct Attribute *AllAttributes = NULL;
+    size_t Cnt = 0;
+    for (size_t i = 0; i < ProjectionLength; ++i) {
+        const size_t Id = Projection[i];
+        // Columnar graphs read only the columns of the projection
+        if (Graph->Columnar) {
+            if (fetchNodeAttribute(Controller, Graph, Node, Id, &Result[Cnt])) {
+                Cnt++;
+            }
+            continue;
+        }
+        if (Id < AttributeCounter) {
+            const struct AddrInfo AttributeAddr = getOptionalFullAddr(
+                    unpackAddr(Node->Attributes).BlockOffset,
+                    unpackAddr(Node->Attributes).DataOffset + Id * sizeof(struct Attribute));
+            fetchData(Controller->Allocator, AttributeAddr, sizeof(struct Attribute), &Result[Cnt]);
+            if (Result[Cnt].Id == Id) {
+                Cnt++;
+                continue;
+            }
+        }
+        if (AllAttributes == NULL) {
+            AllAttributes = arenaAlloc(Controller->Scratch,
+                                       sizeof(struct Attribute) * AttributeCounter);
+            fetchData(Controller->Allocator, unpackAddr(Node->Attributes),
+                      sizeof(struct Attribute) * AttributeCounter, AllAttributes);
+        }
+        for (size_t j = 0; j < AttributeCounter; ++j) {
+            if (AllAttributes[j].Id == Id) {
+                Result[Cnt++] = AllAttributes[j];
+                break;
+            }
+        }
+    }
+    return Cnt;
+}
+
+// Only the attributes listed in Projection are returned if it is not NULL.
 static void getExternalNode(const struct StorageController *const Controller,
                             const struct AddrInfo NodeAddr,
                             const struct AddrInfo GraphAddr,
+                            const size_t *const Projection, const size_t ProjectionLength,
                             struct ExternalNode **Result) {
     struct Node Node;
     fetchData(Controller->Allocator, NodeAddr, sizeof(Node), &Node);
     struct Graph Graph;
-    fetchData(Controller->Allocator, GraphAddr, sizeof(Graph), &Graph);
-    const size_t AttributesSize = sizeof(struct Attribute) * Graph.AttributeCounter;
-    struct Attribute *Attributes = malloc(AttributesSize);
-    fetchData(Controller->Allocator, Node.Attributes, AttributesSize, Attributes);
+    fetchGraph(Controller, GraphAddr, &Graph);
+    size_t AttributesNumber = Graph.AttributeCounter;
+    if (Projection != NULL) {
+        AttributesNumber = ProjectionLength;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct Attribute *Attributes =
+            arenaAlloc(Controller->Scratch, sizeof(struct Attribute) * AttributesNumber);
+    if (Projection != NULL) {
+        AttributesNumber = fetchProjectedAttributes(Controller, &Graph, &Node, Projection,
+                                                    ProjectionLength, Attributes);
+    } else {
+        fetchNodeAttributes(Controller, &Graph, &Node, Attributes);
+    }
     size_t ResultSize = sizeof(struct ExternalNode) +
-                        sizeof(struct ExternalAttribute) * Graph.AttributeCounter +
-                        getNodeStringsSize(Attributes, Graph.AttributeCounter);
+                        sizeof(struct ExternalAttribute) * AttributesNumber +
+                        getNodeStringsSize(Attributes, AttributesNumber);
     *Result = malloc(ResultSize);
     struct ExternalAttribute *ExternalAttributes =
             (struct ExternalAttribute *)((char *)*Result + sizeof(struct ExternalNode));
     char *Strings =
-            (char *)ExternalAttributes + Graph.AttributeCounter * sizeof(struct ExternalAttribute);
-    for (size_t i = 0; i < Graph.AttributeCounter; ++i) {
+            (char *)ExternalAttributes + AttributesNumber * sizeof(struct ExternalAttribute);
+    for (size_t i = 0; i < AttributesNumber; ++i) {
         ExternalAttributes[i].Id = Attributes[i].Id;
         ExternalAttributes[i].Type = Attributes[i].Type;
         if (Attributes[i].Type == BOOL) {
@@ -1222,7 +2073,8 @@ static void getExternalNode(const struct StorageController *const Controller,
         } else if (Attributes[i].Type == STRING) {
             struct MyString String = Attributes[i].Value.StringValue;
             if (String.Length > SMALL_STRING_LIMIT) {
-                fetchData(Controller->Allocator, String.Data.DataPtr, String.Length, Strings);
+                fetchData(Controller->Allocator, unpackAddr(String.Data.DataPtr), String.Length,
+                          Strings);
             } else {
                 memcpy(Strings, String.Data.InlinedData, String.Length);
             }
@@ -1232,9 +2084,9 @@ static void getExternalNode(const struct StorageController *const Controller,
         }
     }
     (**Result).Attributes = ExternalAttributes;
-    (**Result).AttributesNumber = Graph.AttributeCounter;
+    (**Result).AttributesNumber = AttributesNumber;
     (**Result).Id = Node.Id;
-    free(Attributes);
+    arenaRelease(Controller->Scratch, Mark);
 }
 
 static size_t getGraphStringsSize(const struct StorageController *const Controller,
@@ -1252,13 +2104,10 @@ static size_t getGraphStringsSize(const struct StorageController *const Controll
 static void getExternalGraph(const struct StorageController *const Controller,
                              const struct AddrInfo Addr,
                              struct ExternalGraph **Result) {
-    struct Graph Graph;
-    fetchData(Controller->Allocator, Addr, sizeof(Graph), &Graph);
-    const size_t AttributesDescriptionsSize =
-            sizeof(struct AttributeDescription) * Graph.AttributeCounter;
-    struct AttributeDescription *AttributesDescriptions = malloc(AttributesDescriptionsSize);
-    fetchData(Controller->Allocator, Graph.AttributesDecription, AttributesDescriptionsSize,
-              AttributesDescriptions);
+    const struct GraphCatalogEntry *const GraphEntry =
+            graphCatalogFindByAddr(Controller->Catalog, Addr);
+    const struct Graph Graph = GraphEntry->Header;
+    const struct AttributeDescription *const AttributesDescriptions = GraphEntry->Attributes;
     size_t ExternalGraphSize =
             sizeof(struct ExternalGraph) +
             Graph.AttributeCounter * sizeof(struct ExternalAttributeDescription) +
@@ -1276,7 +2125,8 @@ static void getExternalGraph(const struct StorageController *const Controller,
     (*Result)->Name = Strings;
     struct MyString GraphName = Graph.Name;
     if (GraphName.Length > SMALL_STRING_LIMIT) {
-        fetchData(Controller->Allocator, GraphName.Data.DataPtr, GraphName.Length, Strings);
+        fetchData(Controller->Allocator, unpackAddr(GraphName.Data.DataPtr), GraphName.Length,
+                  Strings);
     } else {
         memcpy(Strings, GraphName.Data.InlinedData, GraphName.Length);
     }
@@ -1289,8 +2139,8 @@ static void getExternalGraph(const struct StorageController *const Controller,
                 i == Graph.AttributeCounter - 1 ? NULL : ExternalDescriptions + i + 1;
         struct MyString AttrbuteName = AttributesDescriptions[i].Name;
         if (AttrbuteName.Length > SMALL_STRING_LIMIT) {
-            fetchData(Controller->Allocator, AttrbuteName.Data.DataPtr, AttrbuteName.Length,
-                      Strings);
+            fetchData(Controller->Allocator, unpackAddr(AttrbuteName.Data.DataPtr),
+                      AttrbuteName.Length, Strings);
         } else {
             memcpy(Strings, AttrbuteName.Data.InlinedData, AttrbuteName.Length);
         }
@@ -1298,7 +2148,6 @@ static void getExternalGraph(const struct StorageController *const Controller,
         ExternalDescriptions[i].Name = Strings;
         Strings += AttrbuteName.Length + 1;
     }
-    free(AttributesDescriptions);
 }
 
 struct NodeResultSet *readNode(const struct StorageController *const Controller,
@@ -1307,8 +2156,42 @@ struct NodeResultSet *readNode(const struct StorageController *const Controller,
     struct AddrInfo GraphAddr =
             findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
     struct NodeResultSet *Result = malloc(sizeof(struct NodeResultSet));
-    Result->Cnt =
-            findNodesByFilters(Controller, GraphAddr, Request->AttributesFilterChain, &Nodes);
+    Result->Scan = NULL;
+    Result->Passed = 0;
+    Result->Base = Request->Offset + (Request->After.HasValue ? Request->After.Passed : 0);
+    Result->ByIndex = false;
+    Result->Complete = true;
+    Result->Projection = NULL;
+    Result->ProjectionLength = Request->ProjectionLength;
+    Result->ViewAttributes = NULL;
+    if (Request->Projection != NULL) {
+        Result->Projection = malloc(sizeof(size_t) * Request->ProjectionLength);
+        memcpy(Result->Projection, Request->Projection, sizeof(size_t) * Request->ProjectionLength);
+    }
+    if (Request->ById) {
+        Nodes = malloc(sizeof(struct AddrInfo));
+        Nodes[0] = findNodeAddrById(Controller, GraphAddr, Request->Id);
+        Result->Cnt = Nodes[0].HasValue ? 1 : 0;
+    } else {
+        struct NodeScan *Scan = malloc(sizeof(struct NodeScan));
+        nodeScanBegin(Controller, GraphAddr, Request->AttributesFilterChain, Scan);
+        nodeScanResume(Controller, Scan, &Request->After);
+        Scan->ToSkip += Request->Offset;
+        if (Request->Limit != 0) {
+            Scan->Left = Request->Limit;
+        }
+        Result->ByIndex = Scan->ByIndex;
+        if (Request->Streaming) {
+            Result->Scan = Scan;
+            Nodes = malloc(sizeof(struct AddrInfo) * NODE_RESULT_SET_BATCH);
+            Result->Cnt = nodeScanNext(Controller, Scan, Nodes, NODE_RESULT_SET_BATCH);
+        } else {
+            Result->Cnt = nodeScanAll(Controller, Scan, &Nodes);
+            Result->Complete = nodeScanIsExhausted(Scan);
+            nodeScanEnd(Scan);
+            free(Scan);
+        }
+    }
     Result->Index = 0;
     Result->NodeAddrs = Nodes;
     Result->Controller = Controller;
@@ -1316,14 +2199,71 @@ struct NodeResultSet *readNode(const struct StorageController *const Controller,
     return Result;
 }
 
+size_t countNodes(const struct StorageController *const Controller,
+                  const struct ReadNodeRequest *const Request) {
+    const struct AddrInfo GraphAddr =
+            findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
+    if (!GraphAddr.HasValue) {
+        return 0;
+    }
+    if (Request->ById) {
+        return findNodeAddrById(Controller, GraphAddr, Request->Id).HasValue ? 1 : 0;
+    }
+    struct Graph Graph;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    size_t Count = Graph.NodeCounter;
+    if (Request->AttributesFilterChain == NULL ||
+        attributeIndexesCount(Controller, &Graph, Request->AttributesFilterChain, SIZE_MAX,
+                              &Count)) {
+        return Count;
+    }
+    struct NodeScan Scan;
+    nodeScanBegin(Controller, GraphAddr, Request->AttributesFilterChain, &Scan);
+    struct AddrInfo Batch[NODE_RESULT_SET_BATCH];
+    Count = 0;
+    do {
+        Count += nodeScanNext(Controller, &Scan, Batch, NODE_RESULT_SET_BATCH);
+    } while (!nodeScanIsOver(&Scan));
+    nodeScanEnd(&Scan);
+    return Count;
+}
+
+bool existsNode(const struct StorageController *const Controller,
+                const struct ReadNodeRequest *const Request) {
+    const struct AddrInfo GraphAddr =
+            findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
+    if (!GraphAddr.HasValue) {
+        return false;
+    }
+    if (Request->ById) {
+        return findNodeAddrById(Controller, GraphAddr, Request->Id).HasValue;
+    }
+    struct Graph Graph;
+    fetchGraph(Controller, GraphAddr, &Graph);
+    size_t Count = Graph.NodeCounter;
+    if (Request->AttributesFilterChain == NULL ||
+        attributeIndexesCount(Controller, &Graph, Request->AttributesFilterChain, 1, &Count)) {
+        return Count != 0;
+    }
+    struct NodeScan Scan;
+    nodeScanBegin(Controller, GraphAddr, Request->AttributesFilterChain, &Scan);
+    Scan.Left = 1;
+    struct AddrInfo First;
+    const bool Found = nodeScanNext(Controller, &Scan, &First, 1) == 1;
+    nodeScanEnd(&Scan);
+    return Found;
+}
+
 struct NodeLinkResultSet *readNodeLink(const struct StorageController *const Controller,
                                        const struct ReadNodeLinkRequest *const Request) {
     struct AddrInfo *NodeLinks;
     struct AddrInfo GraphAddr =
             findGraphAddrByGraphId(Controller, Request->GraphIdType, Request->GraphId);
     struct NodeLinkResultSet *Result = malloc(sizeof(struct NodeLinkResultSet));
-    Result->Cnt =
-            findNodeLinksByIdAndType(Controller, GraphAddr, Request->Type, Request->Id, &NodeLinks);
+    Result->Cnt = findNodeLinksPage(Controller, GraphAddr, Request->Type, Request->Id,
+                                    &Request->After, Request->Offset, Request->Limit, &NodeLinks,
+                                    &Result->Complete);
+    Result->Base = Request->Offset + (Request->After.HasValue ? Request->After.Passed : 0);
     Result->Controller = Controller;
     Result->Index = 0;
     Result->LinkAddrs = NodeLinks;
@@ -1337,7 +2277,7 @@ struct GraphResultSet *readGraph(const struct StorageController *const Controlle
     *GraphAddr = findGraphAddrByName(Controller, Request->Name);
     Result->GraphAddrs = GraphAddr;
     Result->Controller = Controller;
-    Result->Cnt = 1;
+    Result->Cnt = GraphAddr->HasValue ? 1 : 0;
     Result->Index = 0;
     return Result;
 }
@@ -1346,11 +2286,71 @@ bool readResultNode(struct NodeResultSet *ResultSet, struct ExternalNode **Node)
     if (nodeResultSetIsEmpty(ResultSet))
         return false;
     getExternalNode(ResultSet->Controller, ResultSet->NodeAddrs[ResultSet->Index],
-                    ResultSet->GraphAddr, Node);
+                    ResultSet->GraphAddr, ResultSet->Projection, ResultSet->ProjectionLength, Node);
+    return true;
+}
+
+bool readResultNodeView(struct NodeResultSet *ResultSet, struct NodeView *View) {
+    if (nodeResultSetIsEmpty(ResultSet))
+        return false;
+    const struct FileAllocator *const Allocator = ResultSet->Controller->Allocator;
+    const struct Node *const Node =
+            getDataPointer(Allocator, ResultSet->NodeAddrs[ResultSet->Index]);
+    struct Graph Graph;
+    fetchGraph(ResultSet->Controller, ResultSet->GraphAddr, &Graph);
+    View->Controller = ResultSet->Controller;
+    View->Id = Node->Id;
+    View->AttributesNumber = Graph.AttributeCounter;
+    if (!Graph.Columnar) {
+        View->Attributes = getDataPointer(Allocator, unpackAddr(Node->Attributes));
+        return true;
+    }
+    // Every view of the result set reuses one buffer
+    if (ResultSet->ViewAttributes == NULL) {
+        ResultSet->ViewAttributes = malloc(sizeof(struct Attribute) * Graph.AttributeCounter);
+    }
+    fetchNodeAttributes(ResultSet->Controller, &Graph, Node, ResultSet->ViewAttributes);
+    View->Attributes = ResultSet->ViewAttributes;
     return true;
 }
 
+const struct Attribute *nodeViewGetAttribute(const struct NodeView *View,
+                                             const size_t AttributeId) {
+    if (AttributeId < View->AttributesNumber && View->Attributes[AttributeId].Id == AttributeId) {
+        return &View->Attributes[AttributeId];
+    }
+    for (size_t i = 0; i < View->AttributesNumber; ++i) {
+        if (View->Attributes[i].Id == AttributeId) {
+            return &View->Attributes[i];
+        }
+    }
+    return NULL;
+}
+
+const char *nodeViewGetString(const struct NodeView *View, const struct Attribute *Attribute) {
+    const struct MyString *const String = &Attribute->Value.StringValue;
+    if (String->Length > SMALL_STRING_LIMIT) {
+        return getDataPointer(View->Controller->Allocator, unpackAddr(String->Data.DataPtr));
+    }
+    return String->Data.InlinedData;
+}
+
+// Buffers the next batch of a streaming result set after its current node.
+static void fillNodeResultSet(struct NodeResultSet *ResultSet) {
+    ResultSet->NodeAddrs[0] = ResultSet->NodeAddrs[ResultSet->Index];
+    ResultSet->Passed += ResultSet->Index;
+    ResultSet->Index = 0;
+    ResultSet->Cnt = 1 + nodeScanNext(ResultSet->Controller, ResultSet->Scan,
+                                      ResultSet->NodeAddrs + 1, NODE_RESULT_SET_BATCH - 1);
+}
+
 bool hasNextNode(struct NodeResultSet *ResultSet) {
+    if (ResultSet->Cnt - ResultSet->Index > 1) {
+        return true;
+    }
+    if (ResultSet->Scan != NULL && ResultSet->Cnt != 0 && !nodeScanIsOver(ResultSet->Scan)) {
+        fillNodeResultSet(ResultSet);
+    }
     return ResultSet->Cnt - ResultSet->Index > 1;
 }
 
@@ -1375,7 +2375,13 @@ bool moveToPreviousNode(struct NodeResultSet *ResultSet) {
 bool nodeResultSetIsEmpty(struct NodeResultSet *ResultSet) { return ResultSet->Cnt == 0; }
 
 void deleteNodeResultSet(struct NodeResultSet **ReultSet) {
+    if ((**ReultSet).Scan != NULL) {
+        nodeScanEnd((**ReultSet).Scan);
+        free((**ReultSet).Scan);
+    }
     free((**ReultSet).NodeAddrs);
+    free((**ReultSet).Projection);
+    free((**ReultSet).ViewAttributes);
     free(*ReultSet);
     *ReultSet = NULL;
 }
@@ -1479,9 +2485,47 @@ void deleteExternalGraph(struct ExternalGraph **Graph) {
     *Graph = NULL;
 }
 
-size_t nodeResultSetGetSize(struct NodeResultSet *ResultSet) { return ResultSet->Cnt; }
+size_t nodeResultSetGetSize(struct NodeResultSet *ResultSet) {
+    return ResultSet->Passed + ResultSet->Cnt;
+}
 
 size_t nodeLinkResultSetGetSize(struct NodeLinkResultSet *ResultSet) { return ResultSet->Cnt; }
 
+struct ResumeToken nodeResultSetGetResumeToken(struct NodeResultSet *ResultSet) {
+    struct ResumeToken Token = {.HasValue = false};
+    // A streaming result set is resumed after its current node
+    const size_t Last = ResultSet->Scan != NULL ? ResultSet->Index : ResultSet->Cnt - 1;
+    const bool Complete = ResultSet->Scan != NULL
+                                  ? nodeScanIsExhausted(ResultSet->Scan) &&
+                                            ResultSet->Index + 1 == ResultSet->Cnt
+                                  : ResultSet->Complete;
+    if (ResultSet->Cnt == 0 || Complete) {
+        return Token;
+    }
+    struct Node Node;
+    fetchData(ResultSet->Controller->Allocator, ResultSet->NodeAddrs[Last], sizeof(Node), &Node);
+    Token.HasValue = true;
+    Token.ByIndex = ResultSet->ByIndex;
+    Token.Addr = ResultSet->NodeAddrs[Last];
+    Token.Key = ResultSet->ByIndex ? Node.Id : Node.Slot;
+    Token.Passed = ResultSet->Base + ResultSet->Passed + Last + 1;
+    return Token;
+}
+
+struct ResumeToken nodeLinkResultSetGetResumeToken(struct NodeLinkResultSet *ResultSet) {
+    struct ResumeToken Token = {.HasValue = false};
+    if (ResultSet->Cnt == 0 || ResultSet->Complete) {
+        return Token;
+    }
+    struct NodeLink Link;
+    fetchData(ResultSet->Controller->Allocator, ResultSet->LinkAddrs[ResultSet->Cnt - 1],
+              sizeof(Link), &Link);
+    Token.HasValue = true;
+    Token.Addr = ResultSet->LinkAddrs[ResultSet->Cnt - 1];
+    Token.Key = Link.Id;
+    Token.Passed = ResultSet->Base + ResultSet->Cnt;
+    return Token;
+}
+
 size_t graphSetGetSize(struct GraphResultSet *ResultSet) { return ResultSet->Cnt; }
 
@@ -0,0 +1,238 @@
+#include "filter-kernels.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FILTER_KERNELS_X86
+#endif
+
+static uint64_t intRangeScalar(const char *Base, const size_t Stride, const size_t Count,
+                               const uint32_t Bits, const int32_t Min, const int32_t Max) {
+    uint64_t Word = 0;
+    for (size_t i = 0; i < Count; ++i) {
+        int32_t Value;
+        memcpy(&Value, Base + i * Stride, sizeof(Value));
+        Value = (int32_t) ((uint32_t) Value & Bits);
+        Word |= (uint64_t) (Value >= Min && Value <= Max) << i;
+    }
+    return Word;
+}
+
+static uint64_t floatRangeScalar(const char *Base, const size_t Stride, const size_t Count,
+                                 const float Min, const float Max) {
+    uint64_t Word = 0;
+    for (size_t i = 0; i < Count; ++i) {
+        float Value;
+        memcpy(&Value, Base + i * Stride, sizeof(Value));
+        Word |= (uint64_t) (!(Min > Value) && !(Value > Max)) << i;
+    }
+    return Word;
+}
+
+// Runs Body for every word of Mask having bits set, the word covers Records
+// records.
+#define FOR_EACH_MASK_WORD(Count, Mask, Word, Records, Body)                                      \
+    for (size_t Word = 0; Word * 64 < (Count); ++Word) {                                          \
+        if ((Mask)[Word] == 0) {                                                                  \
+            continue;                                                                             \
+        }                                                                                         \
+        const size_t Records = (Count) - Word * 64 < 64 ? (Count) - Word * 64 : 64;               \
+        Body                                                                                      \
+    }
+
+static void intRangeScalarKernel(const char *Base, const size_t Stride, const size_t Count,
+                                 const uint32_t Bits, const int32_t Min, const int32_t Max,
+                                 uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= intRangeScalar(Base + w * 64 * Stride, Stride, Records, Bits, Min, Max);
+    })
+}
+
+static void floatRangeScalarKernel(const char *Base, const size_t Stride, const size_t Count,
+                                   const float Min, const float Max, uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= floatRangeScalar(Base + w * 64 * Stride, Stride, Records, Min, Max);
+    })
+}
+
+static const struct FilterKernels ScalarKernels = {intRangeScalarKernel, floatRangeScalarKernel,
+                                                   "scalar"};
+
+#ifdef FILTER_KERNELS_X86
+
+// Four records are loaded one by one, SSE has no gathers. A value is in range
+// if clamping it to the range does not change it.
+__attribute__((target("sse4.2"))) static uint64_t
+intRangeSse(const char *Base, const size_t Stride, const size_t Count, const uint32_t Bits,
+            const int32_t Min, const int32_t Max) {
+    const __m128i BitsVector = _mm_set1_epi32((int32_t) Bits);
+    const __m128i MinVector = _mm_set1_epi32(Min);
+    const __m128i MaxVector = _mm_set1_epi32(Max);
+    uint64_t Word = 0;
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4) {
+        __m128i Vector;
+        if (Stride == sizeof(int32_t)) {
+            Vector = _mm_loadu_si128((const __m128i *) (Base + i * Stride));
+        } else {
+            int32_t Values[4];
+            for (size_t j = 0; j < 4; ++j) {
+                memcpy(&Values[j], Base + (i + j) * Stride, sizeof(int32_t));
+            }
+            Vector = _mm_loadu_si128((const __m128i *) Values);
+        }
+        Vector = _mm_and_si128(Vector, BitsVector);
+        const __m128i Clamped = _mm_max_epi32(_mm_min_epi32(Vector, MaxVector), MinVector);
+        const __m128i Passed = _mm_cmpeq_epi32(Clamped, Vector);
+        Word |= (uint64_t) _mm_movemask_ps(_mm_castsi128_ps(Passed)) << i;
+    }
+    if (i < Count) {
+        Word |= intRangeScalar(Base + i * Stride, Stride, Count - i, Bits, Min, Max) << i;
+    }
+    return Word;
+}
+
+__attribute__((target("sse4.2"))) static uint64_t
+floatRangeSse(const char *Base, const size_t Stride, const size_t Count, const float Min,
+              const float Max) {
+    const __m128 MinVector = _mm_set1_ps(Min);
+    const __m128 MaxVector = _mm_set1_ps(Max);
+    uint64_t Word = 0;
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4) {
+        __m128 Vector;
+        if (Stride == sizeof(float)) {
+            Vector = _mm_loadu_ps((const float *) (Base + i * Stride));
+        } else {
+            float Values[4];
+            for (size_t j = 0; j < 4; ++j) {
+                memcpy(&Values[j], Base + (i + j) * Stride, sizeof(float));
+            }
+            Vector = _mm_loadu_ps(Values);
+        }
+        // Not less and not greater comparisons are true for NaN
+        const __m128 Passed =
+                _mm_and_ps(_mm_cmpnlt_ps(Vector, MinVector), _mm_cmpngt_ps(Vector, MaxVector));
+        Word |= (uint64_t) _mm_movemask_ps(Passed) << i;
+    }
+    if (i < Count) {
+        Word |= floatRangeScalar(Base + i * Stride, Stride, Count - i, Min, Max) << i;
+    }
+    return Word;
+}
+
+__attribute__((target("sse4.2"))) static void
+intRangeSseKernel(const char *Base, const size_t Stride, const size_t Count, const uint32_t Bits,
+                  const int32_t Min, const int32_t Max, uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= intRangeSse(Base + w * 64 * Stride, Stride, Records, Bits, Min, Max);
+    })
+}
+
+__attribute__((target("sse4.2"))) static void
+floatRangeSseKernel(const char *Base, const size_t Stride, const size_t Count, const float Min,
+                    const float Max, uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= floatRangeSse(Base + w * 64 * Stride, Stride, Records, Min, Max);
+    })
+}
+
+static const struct FilterKernels SseKernels = {intRangeSseKernel, floatRangeSseKernel, "sse4.2"};
+
+// Eight records are gathered at once, their offsets fit into 32 bits as a
+// run never leaves its block.
+__attribute__((target("avx2"))) static __m256i getGatherOffsets(const size_t Stride) {
+    const int32_t Step = (int32_t) Stride;
+    return _mm256_setr_epi32(0, Step, 2 * Step, 3 * Step, 4 * Step, 5 * Step, 6 * Step, 7 * Step);
+}
+
+__attribute__((target("avx2"))) static uint64_t
+intRangeAvx2(const char *Base, const size_t Stride, const size_t Count, const uint32_t Bits,
+             const int32_t Min, const int32_t Max) {
+    const __m256i Offsets = getGatherOffsets(Stride);
+    const __m256i BitsVector = _mm256_set1_epi32((int32_t) Bits);
+    const __m256i MinVector = _mm256_set1_epi32(Min);
+    const __m256i MaxVector = _mm256_set1_epi32(Max);
+    uint64_t Word = 0;
+    size_t i = 0;
+    for (; i + 8 <= Count; i += 8) {
+        __m256i Vector =
+                Stride == sizeof(int32_t)
+                        ? _mm256_loadu_si256((const __m256i *) (Base + i * Stride))
+                        : _mm256_i32gather_epi32((const int *) (Base + i * Stride), Offsets, 1);
+        Vector = _mm256_and_si256(Vector, BitsVector);
+        const __m256i Clamped = _mm256_max_epi32(_mm256_min_epi32(Vector, MaxVector), MinVector);
+        const __m256i Passed = _mm256_cmpeq_epi32(Clamped, Vector);
+        Word |= (uint64_t) _mm256_movemask_ps(_mm256_castsi256_ps(Passed)) << i;
+    }
+    if (i < Count) {
+        Word |= intRangeScalar(Base + i * Stride, Stride, Count - i, Bits, Min, Max) << i;
+    }
+    return Word;
+}
+
+__attribute__((target("avx2"))) static uint64_t
+floatRangeAvx2(const char *Base, const size_t Stride, const size_t Count, const float Min,
+               const float Max) {
+    const __m256i Offsets = getGatherOffsets(Stride);
+    const __m256 MinVector = _mm256_set1_ps(Min);
+    const __m256 MaxVector = _mm256_set1_ps(Max);
+    uint64_t Word = 0;
+    size_t i = 0;
+    for (; i + 8 <= Count; i += 8) {
+        const __m256 Vector =
+                Stride == sizeof(float)
+                        ? _mm256_loadu_ps((const float *) (Base + i * Stride))
+                        : _mm256_i32gather_ps((const float *) (Base + i * Stride), Offsets, 1);
+        const __m256 Passed = _mm256_and_ps(_mm256_cmp_ps(Vector, MinVector, _CMP_NLT_UQ),
+                                            _mm256_cmp_ps(Vector, MaxVector, _CMP_NGT_UQ));
+        Word |= (uint64_t) _mm256_movemask_ps(Passed) << i;
+    }
+    if (i < Count) {
+        Word |= floatRangeScalar(Base + i * Stride, Stride, Count - i, Min, Max) << i;
+    }
+    return Word;
+}
+
+__attribute__((target("avx2"))) static void
+intRangeAvx2Kernel(const char *Base, const size_t Stride, const size_t Count, const uint32_t Bits,
+                   const int32_t Min, const int32_t Max, uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= intRangeAvx2(Base + w * 64 * Stride, Stride, Records, Bits, Min, Max);
+    })
+}
+
+__attribute__((target("avx2"))) static void
+floatRangeAvx2Kernel(const char *Base, const size_t Stride, const size_t Count, const float Min,
+                     const float Max, uint64_t *Mask) {
+    FOR_EACH_MASK_WORD(Count, Mask, w, Records, {
+        Mask[w] &= floatRangeAvx2(Base + w * 64 * Stride, Stride, Records, Min, Max);
+    })
+}
+
+static const struct FilterKernels Avx2Kernels = {intRangeAvx2Kernel, floatRangeAvx2Kernel,
+                                                 "avx2"};
+
+#endif
+
+const struct FilterKernels *getFilterKernels(void) {
+    // Scan workers may come here at once, every one of them picks the same
+    // kernels
+    static const struct FilterKernels *Kernels = NULL;
+    const struct FilterKernels *Picked = __atomic_load_n(&Kernels, __ATOMIC_ACQUIRE);
+    if (Picked != NULL) {
+        return Picked;
+    }
+    Picked = &ScalarKernels;
+#ifdef FILTER_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        Picked = &Avx2Kernels;
+    } else if (__builtin_cpu_supports("sse4.2")) {
+        Picked = &SseKernels;
+    }
+#endif
+    __atomic_store_n(&Kernels, Picked, __ATOMIC_RELEASE);
+    return Picked;
+}
@@ -0,0 +1,28 @@
+#ifndef LLP_LAB1_FILTER_KERNELS_H
+#define LLP_LAB1_FILTER_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Range checks of one field over Count records lying Stride bytes apart
+// starting at Base, which points to the field of the first record. Bit i of
+// Mask is cleared if record i fails the check, words of Mask already zero are
+// not looked at. Fields packed one after another, as in the columns of a
+// columnar graph, are loaded without gathers. The best implementation the
+// processor supports is picked on the first call.
+
+struct FilterKernels {
+    // Passes if Min <= (Field & Bits) <= Max for the int32_t field, Min must
+    // not be greater than Max
+    void (*IntRange)(const char *Base, size_t Stride, size_t Count, uint32_t Bits, int32_t Min,
+                     int32_t Max, uint64_t *Mask);
+    // Passes if neither Min > Field nor Field > Max for the float field, so
+    // NaN values pass
+    void (*FloatRange)(const char *Base, size_t Stride, size_t Count, float Min, float Max,
+                       uint64_t *Mask);
+    const char *Name;
+};
+
+const struct FilterKernels *getFilterKernels(void);
+
+#endif //LLP_LAB1_FILTER_KERNELS_H
@@ -0,0 +1,383 @@
+#include "filter-program.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "column-store.h"
+#include "filter-kernels.h"
+
+static bool matchFloatFilter(const struct FloatFilter *const Filter, float Value) {
+    if (Filter->HasMin && Filter->Min > Value) {
+        return false;
+    }
+    if (Filter->HasMax && Filter->Max < Value) {
+        return false;
+    }
+    return true;
+}
+
+// Strings of different length are told apart without reading them, long
+// strings of the same length are compared right in the file mapping.
+static bool matchStringEqual(const struct StorageController *const Controller,
+                             const struct MyString String, const char *const Expected,
+                             const size_t ExpectedLength) {
+    if (String.Length != ExpectedLength) {
+        return false;
+    }
+    if (String.Length <= SMALL_STRING_LIMIT) {
+        return memcmp(String.Data.InlinedData, Expected, ExpectedLength) == 0;
+    }
+    return memcmp(getDataPointer(Controller->Allocator, unpackAddr(String.Data.DataPtr)), Expected,
+                  ExpectedLength) == 0;
+}
+
+// Walks the outgoing or incoming adjacency list starting at LinkAddr looking
+// for a link with OtherNodeId on its other end.
+static bool hasMatchingLink(const struct StorageController *const Controller,
+                            struct AddrInfo LinkAddr, const bool Outgoing,
+                            const size_t OtherNodeId, const bool OnlyUnidirectional,
+                            const struct FloatFilter *const WeightFilter) {
+    while (LinkAddr.HasValue) {
+        struct NodeLink Link;
+        fetchData(Controller->Allocator, LinkAddr, sizeof(Link), &Link);
+        const size_t LinkedNodeId = Outgoing ? Link.RightNodeId : Link.LeftNodeId;
+        if (LinkedNodeId == OtherNodeId && (!OnlyUnidirectional || Link.Type == UNIDIRECTIONAL) &&
+            matchFloatFilter(WeightFilter, Link.Weight)) {
+            return true;
+        }
+        LinkAddr = Outgoing ? unpackAddr(Link.NextOutLink) : unpackAddr(Link.NextInLink);
+    }
+    return false;
+}
+
+static bool matchLinkFilter(const struct StorageController *const Controller,
+                            const struct LinkFilter *const Filter, const struct Node *const Node) {
+    if (Filter->Relation == HAS_LINK_TO) {
+        return hasMatchingLink(Controller, unpackAddr(Node->OutLinks), true, Filter->NodeId, false,
+                               &(Filter->WeightFilter)) ||
+               hasMatchingLink(Controller, unpackAddr(Node->InLinks), false, Filter->NodeId, true,
+                               &(Filter->WeightFilter));
+    }
+    return hasMatchingLink(Controller, unpackAddr(Node->InLinks), false, Filter->NodeId, false,
+                           &(Filter->WeightFilter)) ||
+           hasMatchingLink(Controller, unpackAddr(Node->OutLinks), true, Filter->NodeId, true,
+                           &(Filter->WeightFilter));
+}
+
+static enum DATA_TYPE getFilteredType(const enum FILTER_TYPE Type) {
+    switch (Type) {
+        case INT_FILTER:
+            return INT;
+        case FLOAT_FILTER:
+            return FLOAT;
+        case BOOL_FILTER:
+            return BOOL;
+        default:
+            return STRING;
+    }
+}
+
+// Share of nodes passing a range, guessed from the bounds it has.
+static double guessRangeSelectivity(const bool HasMin, const bool HasMax, const bool Point) {
+    if (HasMin && HasMax) {
+        return Point ? 0.05 : 0.25;
+    }
+    return 0.5;
+}
+
+// Returns false if the filter passes every node having the attribute.
+static bool compileAttributeFilter(const struct AttributeFilter *const Filter,
+                                   struct FilterOp *const Op) {
+    double Cost = 1;
+    double Selectivity;
+    if (Filter->Type == BOOL_FILTER) {
+        Op->Code = OP_BOOL_EQUAL;
+        Op->Data.Bool = Filter->Data.Bool.Value;
+        Selectivity = 0.5;
+    } else if (Filter->Type == FLOAT_FILTER) {
+        const struct FloatFilter *const Float = &(Filter->Data.Float);
+        if (!Float->HasMin && !Float->HasMax) {
+            return false;
+        }
+        Op->Code = OP_FLOAT_RANGE;
+        Op->Data.Float.Min = Float->HasMin ? Float->Min : -INFINITY;
+        Op->Data.Float.Max = Float->HasMax ? Float->Max : INFINITY;
+        Selectivity = guessRangeSelectivity(Float->HasMin, Float->HasMax,
+                                            Float->HasMin && Float->HasMax &&
+                                                    Float->Min == Float->Max);
+    } else if (Filter->Type == STRING_FILTER && Filter->Data.String.Type == STRING_EQUAL) {
+        Op->Code = OP_STRING_EQUAL;
+        Op->Data.String.Value = Filter->Data.String.Data.StringEqual;
+        Op->Data.String.Length = strlen(Op->Data.String.Value) + 1;
+        Cost = 2;
+        Selectivity = 0.05;
+    } else {
+        const struct IntFilter *const Int = Filter->Type == INT_FILTER
+                                                    ? &(Filter->Data.Int)
+                                                    : &(Filter->Data.String.Data.StrlenRange);
+        if (!Int->HasMin && !Int->HasMax) {
+            return false;
+        }
+        Op->Code = Filter->Type == INT_FILTER ? OP_INT_RANGE : OP_STRLEN_RANGE;
+        Op->Data.Int.Min = Int->HasMin ? Int->Min : INT32_MIN;
+        Op->Data.Int.Max = Int->HasMax ? Int->Max : INT32_MAX;
+        Selectivity = guessRangeSelectivity(Int->HasMin, Int->HasMax,
+                                            Int->HasMin && Int->HasMax && Int->Min == Int->Max);
+    }
+    Op->Vectorized = Op->Code == OP_BOOL_EQUAL || Op->Code == OP_INT_RANGE ||
+                     Op->Code == OP_FLOAT_RANGE;
+    Op->Rank = Cost / (1 - Selectivity);
+    return true;
+}
+
+void filterProgramCompile(const struct GraphCatalogEntry *const GraphEntry,
+                          const struct AttributeFilter *FilterChain,
+                          struct FilterProgram *const Program) {
+    Program->Ops = NULL;
+    Program->OpsCnt = 0;
+    Program->AttributeCounter = 0;
+    Program->NeedsAttributes = false;
+    Program->Columnar = false;
+    Program->NeverMatches = GraphEntry == NULL;
+    if (GraphEntry == NULL) {
+        return;
+    }
+    Program->Columnar = GraphEntry->Header.Columnar;
+    const size_t AttributeCounter = GraphEntry->Header.AttributeCounter;
+    size_t FiltersCnt = 0;
+    for (const struct AttributeFilter *Filter = FilterChain; Filter != NULL;
+         Filter = Filter->Next) {
+        FiltersCnt++;
+    }
+    Program->Ops = FiltersCnt != 0 ? malloc(FiltersCnt * sizeof(struct FilterOp)) : NULL;
+    Program->AttributeCounter = AttributeCounter;
+    for (; FilterChain != NULL; FilterChain = FilterChain->Next) {
+        struct FilterOp Op;
+        Op.AttributeId = FilterChain->AttributeId;
+        Op.Column = 0;
+        Op.ColumnWidth = 0;
+        if (FilterChain->Type == LINK_FILTER) {
+            Op.Code = OP_LINK;
+            Op.Slot = 0;
+            Op.Vectorized = false;
+            Op.Data.Link = &(FilterChain->Data.Link);
+            Op.Rank = 20 / (1 - 0.1);
+        } else {
+            if (AttributeCounter == 0) {
+                Program->NeverMatches = true;
+                continue;
+            }
+            // Nodes are created with attributes ordered by id, so that is the
+            // slot to look at first
+            Op.Slot = FilterChain->AttributeId;
+            if (Op.Slot >= AttributeCounter ||
+                GraphEntry->Attributes[Op.Slot].Type != getFilteredType(FilterChain->Type) ||
+                !compileAttributeFilter(FilterChain, &Op)) {
+                continue;
+            }
+            Program->NeedsAttributes = true;
+            if (Program->Columnar) {
+                Op.Column = GraphEntry->ColumnOffsets[Op.Slot];
+                Op.ColumnWidth = getColumnWidth(GraphEntry->Attributes[Op.Slot].Type);
+            }
+            // Every node has the attribute, so none can match an empty range
+            if ((Op.Code == OP_INT_RANGE || Op.Code == OP_STRLEN_RANGE) &&
+                Op.Data.Int.Min > Op.Data.Int.Max) {
+                Program->NeverMatches = true;
+            }
+        }
+        size_t i = Program->OpsCnt++;
+        for (; i > 0 && Program->Ops[i - 1].Rank > Op.Rank; --i) {
+            Program->Ops[i] = Program->Ops[i - 1];
+        }
+        Program->Ops[i] = Op;
+    }
+}
+
+void filterProgramFree(struct FilterProgram *const Program) {
+    free(Program->Ops);
+    Program->Ops = NULL;
+    Program->OpsCnt = 0;
+}
+
+static const struct Attribute *findOpAttribute(const struct FilterProgram *const Program,
+                                               const struct FilterOp *const Op,
+                                               const struct Attribute *const Attributes) {
+    if (Attributes[Op->Slot].Id == Op->AttributeId) {
+        return &Attributes[Op->Slot];
+    }
+    for (size_t i = 0; i < Program->AttributeCounter; ++i) {
+        if (Attributes[i].Id == Op->AttributeId) {
+            return &Attributes[i];
+        }
+    }
+    return NULL;
+}
+
+// Copies the value of the node from the column of the op to Buffer.
+static const struct Attribute *readOpColumn(const struct FilterOp *const Op,
+                                            const char *const Columns, const size_t Slot,
+                                            struct Attribute *const Buffer) {
+    memcpy(&Buffer->Value, Columns + Op->Column + Slot % GRAPH_NODES_PER_BLOCK * Op->ColumnWidth,
+           Op->ColumnWidth);
+    return Buffer;
+}
+
+static bool runOp(const struct StorageController *const Controller,
+                  const struct FilterOp *const Op, const struct Node *const Node,
+                  const struct Attribute *const Attribute) {
+    switch (Op->Code) {
+        case OP_BOOL_EQUAL:
+            return Attribute->Value.BoolValue == Op->Data.Bool;
+        case OP_INT_RANGE:
+            return Attribute->Value.IntValue >= Op->Data.Int.Min &&
+                   Attribute->Value.IntValue <= Op->Data.Int.Max;
+        case OP_FLOAT_RANGE:
+            // Written this way NaN values pass, as they do in unfiltered reads
+            return !(Op->Data.Float.Min > Attribute->Value.FloatValue) &&
+                   !(Op->Data.Float.Max < Attribute->Value.FloatValue);
+        case OP_STRLEN_RANGE: {
+            const int32_t Length = (int32_t) Attribute->Value.StringValue.Length;
+            return Length >= Op->Data.Int.Min && Length <= Op->Data.Int.Max;
+        }
+        case OP_STRING_EQUAL:
+            return matchStringEqual(Controller, Attribute->Value.StringValue,
+                                    Op->Data.String.Value, Op->Data.String.Length);
+        case OP_LINK:
+            return matchLinkFilter(Controller, Op->Data.Link, Node);
+    }
+    return true;
+}
+
+static bool runOps(const struct StorageController *const Controller,
+                   const struct FilterProgram *const Program, const struct Node *const Node,
+                   const bool SkipVectorized) {
+    // Nothing is written while the node is checked, so the attributes are read
+    // in place and only the slots or columns of the ops are touched
+    const void *const Attributes =
+            Program->NeedsAttributes
+                    ? getDataPointer(Controller->Allocator, unpackAddr(Node->Attributes))
+                    : NULL;
+    struct Attribute Buffer;
+    bool Result = true;
+    for (size_t i = 0; i < Program->OpsCnt && Result; ++i) {
+        const struct FilterOp *const Op = &Program->Ops[i];
+        if (SkipVectorized && Op->Vectorized) {
+            continue;
+        }
+        const struct Attribute *Attribute = NULL;
+        if (Op->Code != OP_LINK) {
+            Attribute = Program->Columnar ? readOpColumn(Op, Attributes, Node->Slot, &Buffer)
+                                          : findOpAttribute(Program, Op, Attributes);
+            if (Attribute == NULL) {
+                continue;
+            }
+        }
+        Result = runOp(Controller, Op, Node, Attribute);
+    }
+    return Result;
+}
+
+bool filterProgramMatches(const struct StorageController *const Controller,
+                          const struct FilterProgram *const Program,
+                          const struct Node *const Node) {
+    if (Program->NeverMatches) {
+        return false;
+    }
+    return Program->OpsCnt == 0 || runOps(Controller, Program, Node, false);
+}
+
+void filterProgramMatchRun(const struct StorageController *const Controller,
+                           const struct FilterProgram *const Program,
+                           const struct AddrInfo FirstAddr, const size_t Stride,
+                           const size_t Count, uint64_t *const Result) {
+    const size_t Words = (Count + 63) / 64;
+    uint64_t Live[FILTER_RUN_WORDS];
+    uint64_t Checked[FILTER_RUN_WORDS];
+    const struct FilterKernels *const Kernels = getFilterKernels();
+    const char *const Nodes = getDataPointer(Controller->Allocator, FirstAddr);
+    // Nodes of a run share the column region of their block
+    const char *Columns = NULL;
+    size_t FirstIndex = 0;
+    if (Program->Columnar) {
+        const struct Node *const First = (const struct Node *) Nodes;
+        Columns = getDataPointer(Controller->Allocator, unpackAddr(First->Attributes));
+        FirstIndex = First->Slot % GRAPH_NODES_PER_BLOCK;
+        columnStoreGetLive(Columns, FirstIndex, Count, Live);
+    } else {
+        for (size_t w = 0; w < Words; ++w) {
+            Live[w] = Count - w * 64 >= 64 ? UINT64_MAX : ((uint64_t) 1 << (Count - w * 64)) - 1;
+        }
+        Kernels->IntRange(Nodes + offsetof(struct Node, Deleted), Stride, Count, UINT8_MAX, 0, 0,
+                          Live);
+    }
+    // Ops look at the attribute in their slot, nodes having another attribute
+    // there are checked one by one
+    memcpy(Checked, Live, Words * sizeof(uint64_t));
+    memcpy(Result, Live, Words * sizeof(uint64_t));
+    if (Program->NeverMatches) {
+        memset(Result, 0, Words * sizeof(uint64_t));
+    }
+    bool HasScalarOps = false;
+    for (size_t i = 0; i < Program->OpsCnt && !Program->NeverMatches; ++i) {
+        const struct FilterOp *const Op = &Program->Ops[i];
+        if (!Op->Vectorized) {
+            HasScalarOps = true;
+            continue;
+        }
+        const char *Value;
+        size_t ValueStride;
+        if (Program->Columnar) {
+            // Columns hold the values of one attribute only, nothing to check
+            Value = Columns + Op->Column + FirstIndex * Op->ColumnWidth;
+            ValueStride = Op->ColumnWidth;
+        } else {
+            const char *const Slot =
+                    Nodes + sizeof(struct Node) + Op->Slot * sizeof(struct Attribute);
+            Kernels->IntRange(Slot + offsetof(struct Attribute, Id), Stride, Count, UINT32_MAX,
+                              (int32_t) Op->AttributeId, (int32_t) Op->AttributeId, Checked);
+            Value = Slot + offsetof(struct Attribute, Value);
+            ValueStride = Stride;
+        }
+        if (Op->Code == OP_FLOAT_RANGE) {
+            Kernels->FloatRange(Value, ValueStride, Count, Op->Data.Float.Min,
+                                Op->Data.Float.Max, Result);
+        } else if (Op->Code == OP_INT_RANGE) {
+            Kernels->IntRange(Value, ValueStride, Count, UINT32_MAX, Op->Data.Int.Min,
+                              Op->Data.Int.Max, Result);
+        } else {
+            Kernels->IntRange(Value, ValueStride, Count, UINT8_MAX, Op->Data.Bool, Op->Data.Bool,
+                              Result);
+        }
+    }
+    for (size_t w = 0; w < Words; ++w) {
+        uint64_t Word = Result[w] & Checked[w];
+        for (uint64_t Bits = HasScalarOps ? Word : 0; Bits != 0; Bits &= Bits - 1) {
+            const size_t i = w * 64 + __builtin_ctzll(Bits);
+            if (!runOps(Controller, Program, (const struct Node *) (Nodes + i * Stride), true)) {
+                Word &= ~((uint64_t) 1 << (i % 64));
+            }
+        }
+        for (uint64_t Bits = Live[w] & ~Checked[w]; Bits != 0; Bits &= Bits - 1) {
+            const size_t i = w * 64 + __builtin_ctzll(Bits);
+            if (filterProgramMatches(Controller, Program,
+                                     (const struct Node *) (Nodes + i * Stride))) {
+                Word |= (uint64_t) 1 << (i % 64);
+            }
+        }
+        Result[w] = Word;
+    }
+}
+
+bool filterProgramHasVectorizedOps(const struct FilterProgram *const Program) {
+    for (size_t i = 0; i < Program->OpsCnt; ++i) {
+        if (Program->Ops[i].Vectorized) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,86 @@
+#ifndef LLP_LAB1_FILTER_PROGRAM_H
+#define LLP_LAB1_FILTER_PROGRAM_H
+
+#include "../configs/config.h"
+#include "../structures-data/types.h"
+#include "../structures-request/request-structures.h"
+#include "graph-catalog.h"
+#include "storage-manager.h"
+
+// A filter chain compiled against the attribute types of a graph once per
+// request. Filters on missing attributes or of a type other than the one of
+// their attribute pass every node and are dropped. The rest become ops ordered
+// cheapest and most selective first, every op knowing the slot of its
+// attribute in the node record, or of its column, and how to compare it.
+
+enum FilterOpCode {
+    OP_BOOL_EQUAL,
+    OP_INT_RANGE,
+    OP_FLOAT_RANGE,
+    OP_STRLEN_RANGE,
+    OP_STRING_EQUAL,
+    OP_LINK,
+};
+
+struct FilterOp {
+    enum FilterOpCode Code;
+    size_t AttributeId;
+    size_t Slot;
+    // Columnar graphs only, see column-store.h
+    size_t Column;
+    size_t ColumnWidth;
+    // Checked by the kernels of filterProgramMatchRun
+    bool Vectorized;
+    // Cost of the op divided by the share of nodes it rejects
+    double Rank;
+    union FilterOpData {
+        bool Bool;
+        // Missing bounds are replaced with the widest ones
+        struct {
+            int32_t Min;
+            int32_t Max;
+        } Int;
+        struct {
+            float Min;
+            float Max;
+        } Float;
+        struct {
+            const char *Value;
+            size_t Length;
+        } String;
+        const struct LinkFilter *Link;
+    } Data;
+};
+
+struct FilterProgram {
+    struct FilterOp *Ops;
+    size_t OpsCnt;
+    size_t AttributeCounter;
+    bool NeedsAttributes;
+    bool Columnar;
+    // Attribute filters on a graph without attributes reject every node, so
+    // does any program of a missing graph
+    bool NeverMatches;
+};
+
+// The filter chain has to live as long as the program.
+void filterProgramCompile(const struct GraphCatalogEntry *const GraphEntry,
+                          const struct AttributeFilter *FilterChain,
+                          struct FilterProgram *const Program);
+void filterProgramFree(struct FilterProgram *const Program);
+bool filterProgramMatches(const struct StorageController *const Controller,
+                          const struct FilterProgram *const Program,
+                          const struct Node *const Node);
+
+#define FILTER_RUN_WORDS ((GRAPH_NODES_PER_BLOCK + 63) / 64)
+
+// INT, FLOAT and BOOL ops are checked over a run of nodes with vector kernels.
+bool filterProgramHasVectorizedOps(const struct FilterProgram *const Program);
+// Count nodes, at most GRAPH_NODES_PER_BLOCK, lie Stride bytes apart starting
+// at FirstAddr. Bit i of Result is set if node i is live and matches. Kernels
+// of a columnar graph run over the columns and never touch the node records.
+void filterProgramMatchRun(const struct StorageController *const Controller,
+                           const struct FilterProgram *const Program, struct AddrInfo FirstAddr,
+                           size_t Stride, size_t Count, uint64_t *const Result);
+
+#endif //LLP_LAB1_FILTER_PROGRAM_H
@@ -0,0 +1,211 @@
+#include "graph-catalog.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "column-store.h"
+
+#define GRAPH_CATALOG_MIN_BUCKETS 16
+
+static size_t hashName(const char *Name) {
+    uint64_t Hash = 0xcbf29ce484222325ull;
+    for (; *Name != 0; ++Name) {
+        Hash = (Hash ^ (unsigned char) *Name) * 0x100000001b3ull;
+    }
+    return Hash;
+}
+
+static size_t hashId(const size_t Id) { return Id * 0x9e3779b97f4a7c15ull >> 16; }
+
+static size_t hashAddr(const struct AddrInfo Addr) {
+    return hashId(Addr.BlockOffset * 31 + Addr.DataOffset);
+}
+
+static char *readName(const struct StorageController *const Controller,
+                      const struct MyString Name) {
+    char *Result = malloc(Name.Length + 1);
+    if (Name.Length > SMALL_STRING_LIMIT) {
+        fetchData(Controller->Allocator, unpackAddr(Name.Data.DataPtr), Name.Length,
+                  Result);
+    } else {
+        memcpy(Result, Name.Data.InlinedData, Name.Length);
+    }
+    Result[Name.Length] = 0;
+    return Result;
+}
+
+static void linkEntry(struct GraphCatalog *const Catalog, struct GraphCatalogEntry *const Entry) {
+    const size_t Mask = Catalog->BucketCounter - 1;
+    struct GraphCatalogEntry **NameBucket = &Catalog->ByName[hashName(Entry->Name) & Mask];
+    struct GraphCatalogEntry **IdBucket = &Catalog->ById[hashId(Entry->Header.Id) & Mask];
+    struct GraphCatalogEntry **AddrBucket = &Catalog->ByAddr[hashAddr(Entry->Addr) & Mask];
+    Entry->NextByName = *NameBucket;
+    *NameBucket = Entry;
+    Entry->NextById = *IdBucket;
+    *IdBucket = Entry;
+    Entry->NextByAddr = *AddrBucket;
+    *AddrBucket = Entry;
+}
+
+static void resize(struct GraphCatalog *const Catalog, const size_t NewBucketCounter) {
+    struct GraphCatalogEntry **OldByAddr = Catalog->ByAddr;
+    const size_t OldBucketCounter = Catalog->BucketCounter;
+    free(Catalog->ByName);
+    free(Catalog->ById);
+    Catalog->BucketCounter = NewBucketCounter;
+    Catalog->ByName = calloc(NewBucketCounter, sizeof(struct GraphCatalogEntry *));
+    Catalog->ById = calloc(NewBucketCounter, sizeof(struct GraphCatalogEntry *));
+    Catalog->ByAddr = calloc(NewBucketCounter, sizeof(struct GraphCatalogEntry *));
+    for (size_t i = 0; i < OldBucketCounter; ++i) {
+        struct GraphCatalogEntry *Entry = OldByAddr[i];
+        while (Entry != NULL) {
+            struct GraphCatalogEntry *const Next = Entry->NextByAddr;
+            linkEntry(Catalog, Entry);
+            Entry = Next;
+        }
+    }
+    free(OldByAddr);
+}
+
+void graphCatalogLoad(struct StorageController *const Controller) {
+    struct GraphCatalog *Catalog = malloc(sizeof(struct GraphCatalog));
+    Catalog->EntryCounter = 0;
+    Catalog->BucketCounter = 0;
+    Catalog->ByName = Catalog->ById = Catalog->ByAddr = NULL;
+    resize(Catalog, GRAPH_CATALOG_MIN_BUCKETS);
+    Controller->Catalog = Catalog;
+    struct AddrInfo GraphAddr = Controller->Storage.Graphs;
+    while (GraphAddr.HasValue) {
+        graphCatalogAdd(Controller, GraphAddr);
+        GraphAddr = graphCatalogFindByAddr(Catalog, GraphAddr)->Header.Next;
+    }
+}
+
+void graphCatalogFree(struct GraphCatalog *Catalog) {
+    for (size_t i = 0; i < Catalog->BucketCounter; ++i) {
+        struct GraphCatalogEntry *Entry = Catalog->ByAddr[i];
+        while (Entry != NULL) {
+            struct GraphCatalogEntry *const Next = Entry->NextByAddr;
+            free(Entry->Name);
+            free(Entry->Attributes);
+            free(Entry->ColumnOffsets);
+            free(Entry);
+            Entry = Next;
+        }
+    }
+    free(Catalog->ByName);
+    free(Catalog->ById);
+    free(Catalog->ByAddr);
+    free(Catalog);
+}
+
+void graphCatalogAdd(const struct StorageController *const Controller,
+                     const struct AddrInfo GraphAddr) {
+    struct GraphCatalog *const Catalog = Controller->Catalog;
+    if (Catalog->EntryCounter + 1 > Catalog->BucketCounter) {
+        resize(Catalog, Catalog->BucketCounter * 2);
+    }
+    struct GraphCatalogEntry *Entry = malloc(sizeof(struct GraphCatalogEntry));
+    Entry->Addr = GraphAddr;
+    fetchData(Controller->Allocator, GraphAddr, sizeof(Entry->Header), &Entry->Header);
+    Entry->Name = readName(Controller, Entry->Header.Name);
+    const size_t AttributesSize =
+            sizeof(struct AttributeDescription) * Entry->Header.AttributeCounter;
+    Entry->Attributes = malloc(AttributesSize);
+    if (Entry->Header.AttributeCounter != 0) {
+        fetchData(Controller->Allocator, Entry->Header.AttributesDecription, AttributesSize,
+                  Entry->Attributes);
+    }
+    columnStoreLayout(Entry);
+    linkEntry(Catalog, Entry);
+    Catalog->EntryCounter++;
+}
+
+void graphCatalogRemove(const struct StorageController *const Controller,
+                        const struct AddrInfo GraphAddr) {
+    struct GraphCatalog *const Catalog = Controller->Catalog;
+    struct GraphCatalogEntry *const Entry = graphCatalogFindByAddr(Catalog, GraphAddr);
+    if (Entry == NULL) {
+        return;
+    }
+    const size_t Mask = Catalog->BucketCounter - 1;
+    struct GraphCatalogEntry **Link = &Catalog->ByName[hashName(Entry->Name) & Mask];
+    while (*Link != Entry) {
+        Link = &(*Link)->NextByName;
+    }
+    *Link = Entry->NextByName;
+    Link = &Catalog->ById[hashId(Entry->Header.Id) & Mask];
+    while (*Link != Entry) {
+        Link = &(*Link)->NextById;
+    }
+    *Link = Entry->NextById;
+    Link = &Catalog->ByAddr[hashAddr(Entry->Addr) & Mask];
+    while (*Link != Entry) {
+        Link = &(*Link)->NextByAddr;
+    }
+    *Link = Entry->NextByAddr;
+    Catalog->EntryCounter--;
+    free(Entry->Name);
+    free(Entry->Attributes);
+    free(Entry->ColumnOffsets);
+    free(Entry);
+}
+
+struct GraphCatalogEntry *graphCatalogFindByName(const struct GraphCatalog *const Catalog,
+                                                 const char *const Name) {
+    // Names are not unique, the graph created first wins as it did when the
+    // graph list was searched from its head
+    struct GraphCatalogEntry *Result = NULL;
+    struct GraphCatalogEntry *Entry =
+            Catalog->ByName[hashName(Name) & (Catalog->BucketCounter - 1)];
+    for (; Entry != NULL; Entry = Entry->NextByName) {
+        if (strcmp(Entry->Name, Name) == 0 &&
+            (Result == NULL || Entry->Header.Id < Result->Header.Id)) {
+            Result = Entry;
+        }
+    }
+    return Result;
+}
+
+struct GraphCatalogEntry *graphCatalogFindById(const struct GraphCatalog *const Catalog,
+                                               const size_t Id) {
+    struct GraphCatalogEntry *Entry = Catalog->ById[hashId(Id) & (Catalog->BucketCounter - 1)];
+    while (Entry != NULL && Entry->Header.Id != Id) {
+        Entry = Entry->NextById;
+    }
+    return Entry;
+}
+
+struct GraphCatalogEntry *graphCatalogFindByAddr(const struct GraphCatalog *const Catalog,
+                                                 const struct AddrInfo GraphAddr) {
+    if (!GraphAddr.HasValue) {
+        return NULL;
+    }
+    struct GraphCatalogEntry *Entry =
+            Catalog->ByAddr[hashAddr(GraphAddr) & (Catalog->BucketCounter - 1)];
+    while (Entry != NULL && !isOptionalFullAddrsEq(Entry->Addr, GraphAddr)) {
+        Entry = Entry->NextByAddr;
+    }
+    return Entry;
+}
+
+void fetchGraph(const struct StorageController *const Controller, const struct AddrInfo GraphAddr,
+                struct Graph *const Graph) {
+    const struct GraphCatalogEntry *const Entry =
+            graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    if (Entry != NULL) {
+        *Graph = Entry->Header;
+        return;
+    }
+    fetchData(Controller->Allocator, GraphAddr, sizeof(struct Graph), Graph);
+}
+
+void storeGraph(const struct StorageController *const Controller, const struct AddrInfo GraphAddr,
+                const struct Graph *const Graph) {
+    struct GraphCatalogEntry *const Entry = graphCatalogFindByAddr(Controller->Catalog, GraphAddr);
+    if (Entry != NULL) {
+        Entry->Header = *Graph;
+    }
+    storeData(Controller->Allocator, GraphAddr, sizeof(struct Graph), Graph);
+}
@@ -0,0 +1,53 @@
+#ifndef LLP_LAB1_GRAPH_CATALOG_H
+#define LLP_LAB1_GRAPH_CATALOG_H
+
+#include "../structures-data/types.h"
+#include "storage-manager.h"
+
+// In memory copy of every graph header and attribute description array of the
+// file, found by graph name, id or address. It is filled by beginWork and kept
+// current by createGraph, deleteGraph and storeGraph; the file stays the
+// source of truth and is written on every change.
+struct GraphCatalogEntry {
+    struct AddrInfo Addr;
+    struct Graph Header;
+    char *Name;
+    struct AttributeDescription *Attributes;
+    // Columnar graphs only: offsets of the attribute columns in the column
+    // region of a node block and the size of the region
+    size_t *ColumnOffsets;
+    size_t ColumnRegionSize;
+    struct GraphCatalogEntry *NextByName;
+    struct GraphCatalogEntry *NextById;
+    struct GraphCatalogEntry *NextByAddr;
+};
+
+struct GraphCatalog {
+    size_t EntryCounter;
+    size_t BucketCounter;
+    struct GraphCatalogEntry **ByName;
+    struct GraphCatalogEntry **ById;
+    struct GraphCatalogEntry **ByAddr;
+};
+
+void graphCatalogLoad(struct StorageController *const Controller);
+void graphCatalogFree(struct GraphCatalog *Catalog);
+// Reads the graph header and attribute descriptions stored at GraphAddr.
+void graphCatalogAdd(const struct StorageController *const Controller, struct AddrInfo GraphAddr);
+void graphCatalogRemove(const struct StorageController *const Controller,
+                        struct AddrInfo GraphAddr);
+
+struct GraphCatalogEntry *graphCatalogFindByName(const struct GraphCatalog *const Catalog,
+                                                 const char *const Name);
+struct GraphCatalogEntry *graphCatalogFindById(const struct GraphCatalog *const Catalog,
+                                               size_t Id);
+struct GraphCatalogEntry *graphCatalogFindByAddr(const struct GraphCatalog *const Catalog,
+                                                 struct AddrInfo GraphAddr);
+
+// Replacements for fetchData and storeData of a struct Graph.
+void fetchGraph(const struct StorageController *const Controller, struct AddrInfo GraphAddr,
+                struct Graph *const Graph);
+void storeGraph(const struct StorageController *const Controller, struct AddrInfo GraphAddr,
+                const struct Graph *const Graph);
+
+#endif //LLP_LAB1_GRAPH_CATALOG_H
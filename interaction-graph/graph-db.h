@@ -13,6 +13,13 @@ struct StorageController;
 struct StorageController *beginWork(char *DataFile);
 void endWork(struct StorageController *Controller);
 void dropStorage(struct StorageController *Controller);
+// Node views stay valid while the read epoch is pinned: node records are not
+// moved and strings are not freed until every pin is released. Pins nest.
+void pinReadEpoch(struct StorageController *Controller);
+void unpinReadEpoch(struct StorageController *Controller);
+// Long scans are split between ThreadsNumber threads, one of them is the
+// calling one. The default is the number of online processors.
+void setScanThreads(struct StorageController *Controller, size_t ThreadsNumber);
 void deleteString(const struct StorageController *const Controller, struct MyString String);
 struct MyString createString(struct StorageController *const Controller,
                              const char *const String);
@@ -21,11 +28,27 @@ size_t createGraph(struct StorageController *const Controller,
                    const struct CreateGraphRequest *const Request);
 size_t createNode(struct StorageController *const Controller,
                   const struct CreateNodeRequest *const Request);
+// Returns the id of the first created node, the nodes get consecutive ids.
+size_t createNodesBulk(struct StorageController *const Controller,
+                       const struct CreateNodesBulkRequest *const Request);
 size_t createNodeLink(struct StorageController *const Controller,
                       const struct CreateNodeLinkRequest *const Request);
+// Returns the id of the first created link, the links get consecutive ids. No
+// link is created if an endpoint of any of them is missing.
+size_t createNodeLinksBulk(struct StorageController *const Controller,
+                           const struct CreateNodeLinksBulkRequest *const Request);
+bool createIndex(struct StorageController *const Controller,
+                 const struct CreateIndexRequest *const Request);
 
 struct NodeResultSet *readNode(const struct StorageController *const Controller,
                                const struct ReadNodeRequest *const Request);
+// Number of nodes a read request would return without building the result
+// set, Limit, Offset and After of the request are not taken into account.
+size_t countNodes(const struct StorageController *const Controller,
+                  const struct ReadNodeRequest *const Request);
+// Stops at the first node matching the request.
+bool existsNode(const struct StorageController *const Controller,
+                const struct ReadNodeRequest *const Request);
 struct NodeLinkResultSet *readNodeLink(const struct StorageController *const Controller,
                                        const struct ReadNodeLinkRequest *const Request);
 struct GraphResultSet *readGraph(const struct StorageController *const Controller,
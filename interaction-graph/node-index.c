@@ -0,0 +1,165 @@
+#include "node-index.h"
+
+#include <stdlib.h>
+
+#include "../interaction-file/file-io.h"
+
+// NodeId == 0 marks a never used slot, a slot with NodeId set and no address
+// is a tombstone left by a removal. Node ids are given out starting from 1.
+struct NodeIndexEntry {
+    size_t NodeId;
+    struct AddrInfo NodeAddr;
+};
+
+#define NODE_INDEX_MIN_CAPACITY 2048
+
+static size_t hashNodeId(size_t NodeId) {
+    uint64_t Hash = NodeId;
+    Hash = (Hash ^ (Hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    Hash = (Hash ^ (Hash >> 27)) * 0x94d049bb133111ebull;
+    return Hash ^ (Hash >> 31);
+}
+
+static struct AddrInfo getEntryAddr(const struct Graph *const Graph, const size_t Slot) {
+    return getOptionalFullAddr(Graph->NodeIndex.BlockOffset,
+                               Graph->NodeIndex.DataOffset + Slot * sizeof(struct NodeIndexEntry));
+}
+
+static void fetchEntry(const struct StorageController *const Controller,
+                       const struct Graph *const Graph, const size_t Slot,
+                       struct NodeIndexEntry *const Entry) {
+    fetchData(Controller->Allocator, getEntryAddr(Graph, Slot), sizeof(*Entry), Entry);
+}
+
+static void storeEntry(const struct StorageController *const Controller,
+                       const struct Graph *const Graph, const size_t Slot,
+                       const struct NodeIndexEntry *const Entry) {
+    storeData(Controller->Allocator, getEntryAddr(Graph, Slot), sizeof(*Entry), Entry);
+}
+
+// Returns the slot holding NodeId, or the slot where it should be placed if
+// it is absent: the first tombstone met on the way, or the empty slot ending
+// the probe sequence.
+static size_t findSlot(const struct StorageController *const Controller,
+                       const struct Graph *const Graph, const size_t NodeId, bool *const Found) {
+    const size_t Mask = Graph->NodeIndexCapacity - 1;
+    size_t Slot = hashNodeId(NodeId) & Mask;
+    bool HasTombstone = false;
+    size_t Tombstone = 0;
+    *Found = false;
+    while (true) {
+        struct NodeIndexEntry Entry;
+        fetchEntry(Controller, Graph, Slot, &Entry);
+        if (Entry.NodeId == 0) {
+            return HasTombstone ? Tombstone : Slot;
+        }
+        if (Entry.NodeId == NodeId && Entry.NodeAddr.HasValue) {
+            *Found = true;
+            return Slot;
+        }
+        if (!Entry.NodeAddr.HasValue && !HasTombstone) {
+            HasTombstone = true;
+            Tombstone = Slot;
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+}
+
+static void rebuild(const struct StorageController *const Controller, struct Graph *const Graph,
+                    const size_t NewCapacity) {
+    const size_t TableSize = NewCapacity * sizeof(struct NodeIndexEntry);
+    struct NodeIndexEntry *NewTable = calloc(NewCapacity, sizeof(struct NodeIndexEntry));
+    size_t Used = 0;
+    if (Graph->NodeIndex.HasValue) {
+        const size_t OldTableSize = Graph->NodeIndexCapacity * sizeof(struct NodeIndexEntry);
+        struct NodeIndexEntry *OldTable = malloc(OldTableSize);
+        fetchData(Controller->Allocator, Graph->NodeIndex, OldTableSize, OldTable);
+        for (size_t i = 0; i < Graph->NodeIndexCapacity; ++i) {
+            if (OldTable[i].NodeId == 0 || !OldTable[i].NodeAddr.HasValue) {
+                continue;
+            }
+            size_t Slot = hashNodeId(OldTable[i].NodeId) & (NewCapacity - 1);
+            while (NewTable[Slot].NodeId != 0) {
+                Slot = (Slot + 1) & (NewCapacity - 1);
+            }
+            NewTable[Slot] = OldTable[i];
+            Used++;
+        }
+        free(OldTable);
+        deallocate(Controller->Allocator, Graph->NodeIndex);
+    }
+    Graph->NodeIndex = allocate(Controller->Allocator, TableSize);
+    storeData(Controller->Allocator, Graph->NodeIndex, TableSize, NewTable);
+    Graph->NodeIndexCapacity = NewCapacity;
+    Graph->NodeIndexUsed = Used;
+    free(NewTable);
+}
+
+// Keeps the share of used slots (tombstones included) under 3/4. Tables that
+// are mostly tombstones are rebuilt at the same size.
+static void reserveSlot(const struct StorageController *const Controller,
+                        struct Graph *const Graph) {
+    if (!Graph->NodeIndex.HasValue) {
+        rebuild(Controller, Graph, NODE_INDEX_MIN_CAPACITY);
+        return;
+    }
+    if ((Graph->NodeIndexUsed + 1) * 4 <= Graph->NodeIndexCapacity * 3) {
+        return;
+    }
+    size_t NewCapacity = Graph->NodeIndexCapacity;
+    if ((Graph->NodeCounter + 1) * 2 > Graph->NodeIndexCapacity) {
+        NewCapacity *= 2;
+    }
+    rebuild(Controller, Graph, NewCapacity);
+}
+
+void nodeIndexInsert(const struct StorageController *const Controller, struct Graph *const Graph,
+                     const size_t NodeId, const struct AddrInfo NodeAddr) {
+    reserveSlot(Controller, Graph);
+    bool Found;
+    const size_t Slot = findSlot(Controller, Graph, NodeId, &Found);
+    struct NodeIndexEntry Entry;
+    fetchEntry(Controller, Graph, Slot, &Entry);
+    if (Entry.NodeId == 0) {
+        Graph->NodeIndexUsed++;
+    }
+    Entry.NodeId = NodeId;
+    Entry.NodeAddr = NodeAddr;
+    storeEntry(Controller, Graph, Slot, &Entry);
+}
+
+void nodeIndexRemove(const struct StorageController *const Controller, struct Graph *const Graph,
+                     const size_t NodeId) {
+    if (!Graph->NodeIndex.HasValue) {
+        return;
+    }
+    bool Found;
+    const size_t Slot = findSlot(Controller, Graph, NodeId, &Found);
+    if (!Found) {
+        return;
+    }
+    struct NodeIndexEntry Entry = {.NodeId = NodeId, .NodeAddr = NULL_FULL_ADDR};
+    storeEntry(Controller, Graph, Slot, &Entry);
+}
+
+struct AddrInfo nodeIndexFind(const struct StorageController *const Controller,
+                              const struct Graph *const Graph, const size_t NodeId) {
+    if (!Graph->NodeIndex.HasValue) {
+        return NULL_FULL_ADDR;
+    }
+    bool Found;
+    const size_t Slot = findSlot(Controller, Graph, NodeId, &Found);
+    if (!Found) {
+        return NULL_FULL_ADDR;
+    }
+    struct NodeIndexEntry Entry;
+    fetchEntry(Controller, Graph, Slot, &Entry);
+    return Entry.NodeAddr;
+}
+
+void nodeIndexDrop(const struct StorageController *const Controller, struct Graph *const Graph) {
+    deallocate(Controller->Allocator, Graph->NodeIndex);
+    Graph->NodeIndex = NULL_FULL_ADDR;
+    Graph->NodeIndexCapacity = 0;
+    Graph->NodeIndexUsed = 0;
+}
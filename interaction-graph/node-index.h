@@ -0,0 +1,19 @@
+#ifndef LLP_LAB1_NODE_INDEX_H
+#define LLP_LAB1_NODE_INDEX_H
+
+#include "../structures-data/types.h"
+#include "storage-manager.h"
+
+// Open addressing hash table from node id to node address, kept in the file
+// and described by Graph.NodeIndex* fields. Functions taking a non-const graph
+// may change those fields, the caller is responsible for storing the graph.
+
+void nodeIndexInsert(const struct StorageController *const Controller, struct Graph *const Graph,
+                     size_t NodeId, struct AddrInfo NodeAddr);
+void nodeIndexRemove(const struct StorageController *const Controller, struct Graph *const Graph,
+                     size_t NodeId);
+struct AddrInfo nodeIndexFind(const struct StorageController *const Controller,
+                              const struct Graph *const Graph, size_t NodeId);
+void nodeIndexDrop(const struct StorageController *const Controller, struct Graph *const Graph);
+
+#endif //LLP_LAB1_NODE_INDEX_H
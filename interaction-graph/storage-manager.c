@@ -1,11 +1,16 @@
 #include "storage-manager.h"
 
-#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
+#include "../configs/config.h"
 #include "../structures-data/types.h"
 #include "../interaction-file/file-io.h"
 #include "../structures-request/data-interfaces.h"
 #include "../structures-data/types.h"
+#include "graph-catalog.h"
+#include "graph-db.h"
 
 struct StorageController *beginWork(char *DataFile) {
     struct StorageController *Controller = malloc(sizeof(struct StorageController));
@@ -16,6 +21,8 @@ struct StorageController *beginWork(char *DataFile) {
     struct AddrInfo MayBeStorageAddr = getFirstBlockData(Controller->Allocator);
     if (!MayBeStorageAddr.HasValue) {
         MayBeStorageAddr = allocate(Controller->Allocator, sizeof(struct GraphStorage));
+        Controller->Storage.Magic = STORAGE_MAGIC;
+        Controller->Storage.FormatVersion = STORAGE_FORMAT_VERSION;
         Controller->Storage.GraphCounter = 0;
         Controller->Storage.LastGraph = NULL_FULL_ADDR;
         Controller->Storage.Graphs = NULL_FULL_ADDR;
@@ -27,12 +34,33 @@ struct StorageController *beginWork(char *DataFile) {
     } else {
         fetchData(Controller->Allocator, MayBeStorageAddr, sizeof(struct GraphStorage),
                   &Controller->Storage);
+        if (Controller->Storage.Magic != STORAGE_MAGIC ||
+            Controller->Storage.FormatVersion != STORAGE_FORMAT_VERSION) {
+            fprintf(stderr, "%s: unsupported storage format, files of versions 1 and 2 are "
+                            "converted by LLP_upgrade\n",
+                    DataFile);
+            shutdownFileAllocator(Controller->Allocator);
+            free(Controller);
+            return NULL;
+        }
     }
+    Controller->Scratch = arenaCreate();
+    const long Processors = sysconf(_SC_NPROCESSORS_ONLN);
+    Controller->Workers = NULL;
+    setScanThreads(Controller, Processors > 0 ? (size_t) Processors : 1);
+    graphCatalogLoad(Controller);
+    Controller->Epoch = calloc(1, sizeof(struct ReadEpoch));
     return Controller;
 }
 
 void endWork(struct StorageController *Controller) {
+    Controller->Epoch->Pins = 1;
+    unpinReadEpoch(Controller);
+    free(Controller->Epoch);
+    arenaDestroy(Controller->Scratch);
+    workerPoolDestroy(Controller->Workers);
     shutdownFileAllocator(Controller->Allocator);
+    graphCatalogFree(Controller->Catalog);
     free(Controller);
 }
 
@@ -61,6 +89,16 @@ size_t increaseNodeNumber(struct StorageController *const Controller) {
     return Controller->Storage.NextNodeId;
 }
 
+// Returns the first of Number consecutive node ids.
+size_t reserveNodeIds(struct StorageController *const Controller, const size_t Number) {
+    const size_t FirstId = Controller->Storage.NextNodeId;
+    Controller->Storage.NextNodeId += Number;
+    struct AddrInfo StorageAddr = getFirstBlockData(Controller->Allocator);
+    storeData(Controller->Allocator, StorageAddr, sizeof(struct GraphStorage),
+              &Controller->Storage);
+    return FirstId;
+}
+
 size_t increaseNodeLinkNumber(struct StorageController *const Controller) {
     Controller->Storage.NextNodeLinkId++;
     struct AddrInfo StorageAddr = getFirstBlockData(Controller->Allocator);
@@ -69,15 +107,23 @@ size_t increaseNodeLinkNumber(struct StorageController *const Controller) {
     return Controller->Storage.NextGraphId;
 }
 
+// Returns the first of Number consecutive node link ids.
+size_t reserveNodeLinkIds(struct StorageController *const Controller, const size_t Number) {
+    const size_t FirstId = Controller->Storage.NextNodeLinkId;
+    Controller->Storage.NextNodeLinkId += Number;
+    struct AddrInfo StorageAddr = getFirstBlockData(Controller->Allocator);
+    storeData(Controller->Allocator, StorageAddr, sizeof(struct GraphStorage),
+              &Controller->Storage);
+    return FirstId;
+}
+
 void updateLastGraph(struct StorageController *const Controller,
                      struct AddrInfo LastGraphAddr) {
     if (Controller->Storage.LastGraph.HasValue) {
         struct Graph OldLastGraph;
-        fetchData(Controller->Allocator, Controller->Storage.LastGraph, sizeof(struct Graph),
-                  &OldLastGraph);
+        fetchGraph(Controller, Controller->Storage.LastGraph, &OldLastGraph);
         OldLastGraph.Next = LastGraphAddr;
-        storeData(Controller->Allocator, Controller->Storage.LastGraph, sizeof(struct Graph),
-                  &OldLastGraph);
+        storeGraph(Controller, Controller->Storage.LastGraph, &OldLastGraph);
     }
     Controller->Storage.LastGraph = LastGraphAddr;
     struct AddrInfo StorageAddr = getFirstBlockData(Controller->Allocator);
@@ -93,3 +139,48 @@ void updateFirstGraph(struct StorageController *const Controller,
               &Controller->Storage);
 }
 
+
+void setScanThreads(struct StorageController *const Controller, size_t ThreadsNumber) {
+    if (ThreadsNumber > SCAN_THREADS_MAX) {
+        ThreadsNumber = SCAN_THREADS_MAX;
+    }
+    if (Controller->Workers != NULL) {
+        workerPoolDestroy(Controller->Workers);
+    }
+    Controller->Workers = workerPoolCreate(ThreadsNumber);
+}
+
+void pinReadEpoch(struct StorageController *const Controller) { Controller->Epoch->Pins++; }
+
+void unpinReadEpoch(struct StorageController *const Controller) {
+    struct ReadEpoch *const Epoch = Controller->Epoch;
+    if (Epoch->Pins == 0 || --Epoch->Pins != 0) {
+        return;
+    }
+    for (size_t i = 0; i < Epoch->DeferredCnt; ++i) {
+        deallocate(Controller->Allocator, Epoch->DeferredFrees[i]);
+    }
+    free(Epoch->DeferredFrees);
+    Epoch->DeferredFrees = NULL;
+    Epoch->DeferredCnt = 0;
+    Epoch->DeferredCapacity = 0;
+}
+
+bool isReadEpochPinned(const struct StorageController *const Controller) {
+    return Controller->Epoch->Pins != 0;
+}
+
+void deallocateAfterReaders(const struct StorageController *const Controller,
+                            const struct AddrInfo Addr) {
+    struct ReadEpoch *const Epoch = Controller->Epoch;
+    if (Epoch->Pins == 0) {
+        deallocate(Controller->Allocator, Addr);
+        return;
+    }
+    if (Epoch->DeferredCnt == Epoch->DeferredCapacity) {
+        Epoch->DeferredCapacity = Epoch->DeferredCapacity == 0 ? 64 : Epoch->DeferredCapacity * 2;
+        Epoch->DeferredFrees =
+                realloc(Epoch->DeferredFrees, Epoch->DeferredCapacity * sizeof(struct AddrInfo));
+    }
+    Epoch->DeferredFrees[Epoch->DeferredCnt++] = Addr;
+}
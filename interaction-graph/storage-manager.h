@@ -1,25 +1,56 @@
 #ifndef LLP_LAB1_STORAGE_MANAGER_H
 #define LLP_LAB1_STORAGE_MANAGER_H
 
-#include <malloc.h>
+#include <stdlib.h>
 
 #include "../interaction-file/file-io.h"
 #include "../structures-data/types.h"
+#include "arena.h"
+#include "worker-pool.h"
+
+struct GraphCatalog;
+
+#define STORAGE_MAGIC 0x3147504cu
+// Version 1 files have no magic and keep full addresses in records, graph
+// headers of version 2 files have no Columnar flag. Both are converted by
+// LLP_upgrade.
+#define STORAGE_FORMAT_VERSION 3
+
+// Readers holding node views pin the read epoch. While it is pinned node
+// records are not moved or trimmed, and blocks released through
+// deallocateAfterReaders are only freed by the last unpin.
+struct ReadEpoch {
+    size_t Pins;
+    struct AddrInfo *DeferredFrees;
+    size_t DeferredCnt;
+    size_t DeferredCapacity;
+};
 
 struct StorageController {
     struct FileAllocator *Allocator;
     struct GraphStorage Storage;
     struct AddrInfo StorageAddr;
+    struct GraphCatalog *Catalog;
+    struct ReadEpoch *Epoch;
+    // Temporary buffers of the running request, released before it returns
+    struct Arena *Scratch;
+    // Threads checking the pieces of long node chains during scans
+    struct WorkerPool *Workers;
 };
 
 size_t increaseGraphNumber(struct StorageController *Controller);
 size_t decreaseGraphNumber(struct StorageController *Controller);
 size_t increaseNodeNumber(struct StorageController *Controller);
+size_t reserveNodeIds(struct StorageController *Controller, size_t Number);
 size_t increaseNodeLinkNumber(struct StorageController *Controller);
+size_t reserveNodeLinkIds(struct StorageController *Controller, size_t Number);
 void updateLastGraph(struct StorageController *const Controller,
                      struct AddrInfo LastGraphAddr);
 void updateFirstGraph(struct StorageController *const Controller,
                       struct AddrInfo FirstGraphAddr);
+bool isReadEpochPinned(const struct StorageController *const Controller);
+void deallocateAfterReaders(const struct StorageController *const Controller,
+                            struct AddrInfo Addr);
 
 
 #endif //LLP_LAB1_STORAGE_MANAGER_H
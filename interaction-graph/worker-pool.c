@@ -0,0 +1,117 @@
+#include "worker-pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+struct WorkerPool {
+    pthread_mutex_t Lock;
+    // Signalled when a run starts or the pool is destroyed
+    pthread_cond_t Started;
+    // Signalled when the last worker leaves a run
+    pthread_cond_t Finished;
+    pthread_t *Threads;
+    size_t ThreadsNumber;
+    void (*Task)(void *Context, size_t Index);
+    void *Context;
+    size_t TasksNumber;
+    size_t NextTask;
+    // Number of the current run, workers wait for it to change
+    size_t Run;
+    size_t Busy;
+    bool Stopping;
+};
+
+// Takes tasks of the current run until none is left, called with Lock held.
+static void takeTasks(struct WorkerPool *const Pool) {
+    while (Pool->NextTask < Pool->TasksNumber) {
+        const size_t Index = Pool->NextTask++;
+        pthread_mutex_unlock(&Pool->Lock);
+        Pool->Task(Pool->Context, Index);
+        pthread_mutex_lock(&Pool->Lock);
+    }
+}
+
+static void *runWorker(void *Argument) {
+    struct WorkerPool *const Pool = Argument;
+    size_t SeenRun = 0;
+    pthread_mutex_lock(&Pool->Lock);
+    while (true) {
+        while (!Pool->Stopping && Pool->Run == SeenRun) {
+            pthread_cond_wait(&Pool->Started, &Pool->Lock);
+        }
+        if (Pool->Stopping) {
+            break;
+        }
+        SeenRun = Pool->Run;
+        Pool->Busy++;
+        takeTasks(Pool);
+        if (--Pool->Busy == 0) {
+            pthread_cond_signal(&Pool->Finished);
+        }
+    }
+    pthread_mutex_unlock(&Pool->Lock);
+    return NULL;
+}
+
+struct WorkerPool *workerPoolCreate(const size_t ThreadsNumber) {
+    struct WorkerPool *Pool = malloc(sizeof(struct WorkerPool));
+    pthread_mutex_init(&Pool->Lock, NULL);
+    pthread_cond_init(&Pool->Started, NULL);
+    pthread_cond_init(&Pool->Finished, NULL);
+    Pool->ThreadsNumber = ThreadsNumber != 0 ? ThreadsNumber : 1;
+    Pool->Task = NULL;
+    Pool->Context = NULL;
+    Pool->TasksNumber = 0;
+    Pool->NextTask = 0;
+    Pool->Run = 0;
+    Pool->Busy = 0;
+    Pool->Stopping = false;
+    Pool->Threads = malloc(sizeof(pthread_t) * Pool->ThreadsNumber);
+    for (size_t i = 1; i < Pool->ThreadsNumber; ++i) {
+        pthread_create(Pool->Threads + i, NULL, runWorker, Pool);
+    }
+    return Pool;
+}
+
+void workerPoolDestroy(struct WorkerPool *Pool) {
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Stopping = true;
+    pthread_cond_broadcast(&Pool->Started);
+    pthread_mutex_unlock(&Pool->Lock);
+    for (size_t i = 1; i < Pool->ThreadsNumber; ++i) {
+        pthread_join(Pool->Threads[i], NULL);
+    }
+    pthread_cond_destroy(&Pool->Finished);
+    pthread_cond_destroy(&Pool->Started);
+    pthread_mutex_destroy(&Pool->Lock);
+    free(Pool->Threads);
+    free(Pool);
+}
+
+size_t workerPoolGetSize(const struct WorkerPool *Pool) { return Pool->ThreadsNumber; }
+
+void workerPoolRun(struct WorkerPool *Pool, void (*Task)(void *Context, size_t Index),
+                   void *Context, const size_t TasksNumber) {
+    if (Pool->ThreadsNumber == 1 || TasksNumber < 2) {
+        for (size_t i = 0; i < TasksNumber; ++i) {
+            Task(Context, i);
+        }
+        return;
+    }
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Task = Task;
+    Pool->Context = Context;
+    Pool->TasksNumber = TasksNumber;
+    Pool->NextTask = 0;
+    Pool->Run++;
+    pthread_cond_broadcast(&Pool->Started);
+    Pool->Busy++;
+    takeTasks(Pool);
+    Pool->Busy--;
+    // Workers that have not woken up yet find no tasks left and leave at once
+    while (Pool->Busy != 0) {
+        pthread_cond_wait(&Pool->Finished, &Pool->Lock);
+    }
+    pthread_mutex_unlock(&Pool->Lock);
+}
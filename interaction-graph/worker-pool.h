@@ -0,0 +1,20 @@
+#ifndef LLP_LAB1_WORKER_POOL_H
+#define LLP_LAB1_WORKER_POOL_H
+
+#include <stddef.h>
+
+// Threads kept for the whole session to run the tasks of a request in
+// parallel. The thread calling workerPoolRun works on the tasks too, so a pool
+// of one thread starts none and runs everything in the caller.
+
+struct WorkerPool;
+
+struct WorkerPool *workerPoolCreate(size_t ThreadsNumber);
+void workerPoolDestroy(struct WorkerPool *Pool);
+size_t workerPoolGetSize(const struct WorkerPool *Pool);
+// Calls Task for every index below TasksNumber and returns once all of them
+// are done. Tasks are taken in index order but may finish in any.
+void workerPoolRun(struct WorkerPool *Pool, void (*Task)(void *Context, size_t Index),
+                   void *Context, size_t TasksNumber);
+
+#endif //LLP_LAB1_WORKER_POOL_H
@@ -0,0 +1,218 @@
+#include "zone-map.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../interaction-file/file-io.h"
+#include "arena.h"
+
+// Summary of one attribute of the nodes of a chunk, a chunk holds the entries
+// of all attributes ordered by attribute id. Nodes may list their attributes
+// in any order, so entries are never matched by position in the node record.
+// Bounds are kept for INT and FLOAT values and STRING lengths. Range filters
+// never reject NaN, so the bounds of an entry with a NaN value are not used.
+struct ZoneMapEntry {
+    bool HasValues;
+    bool HasNaN;
+    enum DATA_TYPE Type;
+    union ZoneMapBound {
+        int32_t IntValue;
+        float FloatValue;
+        size_t Length;
+    } Min, Max;
+};
+
+#define ZONE_MAP_MIN_CHUNKS 4
+
+static size_t getChunkSize(const struct Graph *const Graph) {
+    return Graph->AttributeCounter * sizeof(struct ZoneMapEntry);
+}
+
+static struct AddrInfo getChunkAddr(const struct Graph *const Graph, const size_t Chunk) {
+    return getOptionalFullAddr(Graph->ZoneMaps.BlockOffset,
+                               Graph->ZoneMaps.DataOffset + Chunk * getChunkSize(Graph));
+}
+
+static void resize(const struct StorageController *const Controller, struct Graph *const Graph,
+                   const size_t NewChunks) {
+    const size_t NewSize = NewChunks * getChunkSize(Graph);
+    struct ZoneMapEntry *Entries = calloc(NewChunks * Graph->AttributeCounter,
+                                          sizeof(struct ZoneMapEntry));
+    if (Graph->ZoneMaps.HasValue) {
+        fetchData(Controller->Allocator, Graph->ZoneMaps, Graph->ZoneMapChunks * getChunkSize(Graph),
+                  Entries);
+        deallocate(Controller->Allocator, Graph->ZoneMaps);
+    }
+    Graph->ZoneMaps = allocate(Controller->Allocator, NewSize);
+    storeData(Controller->Allocator, Graph->ZoneMaps, NewSize, Entries);
+    Graph->ZoneMapChunks = NewChunks;
+    free(Entries);
+}
+
+void zoneMapPrepareSlot(const struct StorageController *const Controller,
+                        struct Graph *const Graph, const size_t Slot) {
+    if (Graph->AttributeCounter == 0) {
+        return;
+    }
+    const size_t Chunk = Slot / GRAPH_NODES_PER_BLOCK;
+    if (Chunk >= Graph->ZoneMapChunks) {
+        size_t NewChunks = Graph->ZoneMapChunks ? Graph->ZoneMapChunks : ZONE_MAP_MIN_CHUNKS;
+        while (NewChunks <= Chunk) {
+            NewChunks *= 2;
+        }
+        resize(Controller, Graph, NewChunks);
+    }
+    // A new node takes the slot right after the last node of the chain, so a
+    // chunk started by it has no live nodes left from earlier.
+    if (Slot % GRAPH_NODES_PER_BLOCK == 0) {
+        const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+        struct ZoneMapEntry *Entries = arenaAlloc(Controller->Scratch, getChunkSize(Graph));
+        memset(Entries, 0, getChunkSize(Graph));
+        storeData(Controller->Allocator, getChunkAddr(Graph, Chunk), getChunkSize(Graph), Entries);
+        arenaRelease(Controller->Scratch, Mark);
+    }
+}
+
+static void widenEntry(struct ZoneMapEntry *const Entry, const struct Attribute *const Attribute) {
+    union ZoneMapBound Value;
+    switch (Attribute->Type) {
+        case INT:
+            Value.IntValue = Attribute->Value.IntValue;
+            if (!Entry->HasValues || Value.IntValue < Entry->Min.IntValue) {
+                Entry->Min = Value;
+            }
+            if (!Entry->HasValues || Value.IntValue > Entry->Max.IntValue) {
+                Entry->Max = Value;
+            }
+            break;
+        case FLOAT:
+            Value.FloatValue = Attribute->Value.FloatValue;
+            if (isnan(Value.FloatValue)) {
+                Entry->HasNaN = true;
+                break;
+            }
+            if (!Entry->HasValues || Value.FloatValue < Entry->Min.FloatValue) {
+                Entry->Min = Value;
+            }
+            if (!Entry->HasValues || Value.FloatValue > Entry->Max.FloatValue) {
+                Entry->Max = Value;
+            }
+            break;
+        case STRING:
+            Value.Length = Attribute->Value.StringValue.Length;
+            if (!Entry->HasValues || Value.Length < Entry->Min.Length) {
+                Entry->Min = Value;
+            }
+            if (!Entry->HasValues || Value.Length > Entry->Max.Length) {
+                Entry->Max = Value;
+            }
+            break;
+        case BOOL:
+            break;
+    }
+    Entry->HasValues = true;
+    Entry->Type = Attribute->Type;
+}
+
+void zoneMapAddNode(const struct StorageController *const Controller,
+                    const struct Graph *const Graph, const size_t Slot,
+                    const struct Attribute *const Attributes) {
+    zoneMapAddNodes(Controller, Graph, Slot, Attributes, 1);
+}
+
+void zoneMapAddNodes(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, const size_t FirstSlot,
+                     const struct Attribute *const Attributes, const size_t NodesNumber) {
+    if (!Graph->ZoneMaps.HasValue) {
+        return;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct ZoneMapEntry *Entries = arenaAlloc(Controller->Scratch, getChunkSize(Graph));
+    size_t i = 0;
+    while (i < NodesNumber) {
+        const size_t Chunk = (FirstSlot + i) / GRAPH_NODES_PER_BLOCK;
+        if (Chunk >= Graph->ZoneMapChunks) {
+            break;
+        }
+        const struct AddrInfo ChunkAddr = getChunkAddr(Graph, Chunk);
+        fetchData(Controller->Allocator, ChunkAddr, getChunkSize(Graph), Entries);
+        for (; i < NodesNumber && (FirstSlot + i) / GRAPH_NODES_PER_BLOCK == Chunk; ++i) {
+            const struct Attribute *const NodeAttributes =
+                    Attributes + i * Graph->AttributeCounter;
+            for (size_t j = 0; j < Graph->AttributeCounter; ++j) {
+                widenEntry(&Entries[NodeAttributes[j].Id], &NodeAttributes[j]);
+            }
+        }
+        storeData(Controller->Allocator, ChunkAddr, getChunkSize(Graph), Entries);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+}
+
+bool zoneMapCanSkip(const struct AttributeFilter *FilterChain) {
+    for (; FilterChain != NULL; FilterChain = FilterChain->Next) {
+        if (FilterChain->Type == INT_FILTER || FilterChain->Type == FLOAT_FILTER ||
+            (FilterChain->Type == STRING_FILTER &&
+             FilterChain->Data.String.Type == STRLEN_RANGE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The bounds are compared the same way the scan compares single values, so a
+// chunk is only rejected if every value in the range would be rejected.
+static bool rangeMayMatchInt(const struct IntFilter *const Filter, const int32_t Min,
+                             const int32_t Max) {
+    return !(Filter->HasMin && Filter->Min > Max) && !(Filter->HasMax && Filter->Max < Min);
+}
+
+static bool entryMayMatch(const struct ZoneMapEntry *const Entry,
+                          const struct AttributeFilter *const Filter) {
+    if (Filter->Type == INT_FILTER && Entry->Type == INT) {
+        return rangeMayMatchInt(&(Filter->Data.Int), Entry->Min.IntValue, Entry->Max.IntValue);
+    }
+    if (Filter->Type == FLOAT_FILTER && Entry->Type == FLOAT) {
+        if (Entry->HasNaN) {
+            return true;
+        }
+        const struct FloatFilter *const Float = &(Filter->Data.Float);
+        return !(Float->HasMin && Float->Min > Entry->Max.FloatValue) &&
+               !(Float->HasMax && Float->Max < Entry->Min.FloatValue);
+    }
+    if (Filter->Type == STRING_FILTER && Entry->Type == STRING &&
+        Filter->Data.String.Type == STRLEN_RANGE) {
+        return rangeMayMatchInt(&(Filter->Data.String.Data.StrlenRange),
+                                (int32_t) Entry->Min.Length, (int32_t) Entry->Max.Length);
+    }
+    return true;
+}
+
+bool zoneMapMayMatch(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, const size_t Chunk,
+                     const struct AttributeFilter *FilterChain) {
+    if (!Graph->ZoneMaps.HasValue || Chunk >= Graph->ZoneMapChunks) {
+        return true;
+    }
+    const struct ArenaMark Mark = arenaMark(Controller->Scratch);
+    struct ZoneMapEntry *Entries = arenaAlloc(Controller->Scratch, getChunkSize(Graph));
+    fetchData(Controller->Allocator, getChunkAddr(Graph, Chunk), getChunkSize(Graph), Entries);
+    bool Result = true;
+    for (; FilterChain != NULL && Result; FilterChain = FilterChain->Next) {
+        if (FilterChain->AttributeId >= Graph->AttributeCounter) {
+            continue;
+        }
+        const struct ZoneMapEntry *const Entry = &Entries[FilterChain->AttributeId];
+        Result = !Entry->HasValues || entryMayMatch(Entry, FilterChain);
+    }
+    arenaRelease(Controller->Scratch, Mark);
+    return Result;
+}
+
+void zoneMapDrop(const struct StorageController *const Controller, struct Graph *const Graph) {
+    if (Graph->ZoneMaps.HasValue) {
+        deallocate(Controller->Allocator, Graph->ZoneMaps);
+    }
+    Graph->ZoneMaps = NULL_FULL_ADDR;
+    Graph->ZoneMapChunks = 0;
+}
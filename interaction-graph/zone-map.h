@@ -0,0 +1,34 @@
+#ifndef LLP_LAB1_ZONE_MAP_H
+#define LLP_LAB1_ZONE_MAP_H
+
+#include "../structures-data/types.h"
+#include "../structures-request/request-structures.h"
+#include "storage-manager.h"
+
+// Per chunk summaries of node attributes: value ranges of INT and FLOAT
+// attributes and length ranges of STRING attributes. Chunk number k covers the
+// node slots [k * GRAPH_NODES_PER_BLOCK, (k + 1) * GRAPH_NODES_PER_BLOCK),
+// which is the k-th block of the node chain. Ranges only grow while the chunk
+// is in use, so they may be wider than the values actually left in it.
+
+// Called for the slot of every new node before zoneMapAddNode. Grows the
+// summaries array if needed and clears the chunk if the slot starts it, the
+// caller stores the graph.
+void zoneMapPrepareSlot(const struct StorageController *const Controller,
+                        struct Graph *const Graph, size_t Slot);
+void zoneMapAddNode(const struct StorageController *const Controller,
+                    const struct Graph *const Graph, size_t Slot,
+                    const struct Attribute *const Attributes);
+// Attributes holds NodesNumber attribute arrays of the nodes in the slots
+// starting from FirstSlot.
+void zoneMapAddNodes(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, size_t FirstSlot,
+                     const struct Attribute *const Attributes, size_t NodesNumber);
+bool zoneMapCanSkip(const struct AttributeFilter *FilterChain);
+// Returns false if no node of the chunk can match the filter chain.
+bool zoneMapMayMatch(const struct StorageController *const Controller,
+                     const struct Graph *const Graph, size_t Chunk,
+                     const struct AttributeFilter *FilterChain);
+void zoneMapDrop(const struct StorageController *const Controller, struct Graph *const Graph);
+
+#endif //LLP_LAB1_ZONE_MAP_H
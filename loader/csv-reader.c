@@ -0,0 +1,106 @@
+#include "csv-reader.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool mapFile(const char *Path, struct MappedFile *File) {
+    int Descriptor = open(Path, O_RDONLY);
+    if (Descriptor < 0) {
+        return false;
+    }
+    struct stat Stat;
+    if (fstat(Descriptor, &Stat) != 0) {
+        close(Descriptor);
+        return false;
+    }
+    File->Size = Stat.st_size;
+    File->Data = "";
+    if (File->Size != 0) {
+        void *Data = mmap(NULL, File->Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+        if (Data == MAP_FAILED) {
+            close(Descriptor);
+            return false;
+        }
+        madvise(Data, File->Size, MADV_SEQUENTIAL);
+        File->Data = Data;
+    }
+    close(Descriptor);
+    return true;
+}
+
+void unmapFile(struct MappedFile *File) {
+    if (File->Size != 0) {
+        munmap((void *) File->Data, File->Size);
+    }
+    File->Data = NULL;
+    File->Size = 0;
+}
+
+void splitLines(const char *Data, size_t Size, size_t ChunksNumber, size_t *Bounds) {
+    Bounds[0] = 0;
+    for (size_t i = 1; i < ChunksNumber; ++i) {
+        size_t Bound = Size / ChunksNumber * i;
+        if (Bound < Bounds[i - 1]) {
+            Bound = Bounds[i - 1];
+        }
+        const char *LineEnd = Bound > 0 ? memchr(Data + Bound - 1, '\n', Size - Bound + 1) : Data;
+        Bounds[i] = LineEnd == NULL ? Size : (size_t) (LineEnd - Data) + (Bound > 0);
+    }
+    Bounds[ChunksNumber] = Size;
+}
+
+size_t readCsvLine(const char **Position, const char *End, char **Strings, char **Fields,
+                   size_t MaxFields) {
+    const char *Current = *Position;
+    char *Out = *Strings;
+    size_t FieldsNumber = 0;
+    bool LineEnded = false;
+    while (!LineEnded) {
+        if (FieldsNumber < MaxFields) {
+            Fields[FieldsNumber] = Out;
+        }
+        FieldsNumber++;
+        bool Quoted = Current < End && *Current == '"';
+        if (Quoted) {
+            Current++;
+        }
+        while (Current < End) {
+            if (Quoted && *Current == '"') {
+                if (Current + 1 < End && Current[1] == '"') {
+                    *Out++ = '"';
+                    Current += 2;
+                    continue;
+                }
+                Quoted = false;
+                Current++;
+                continue;
+            }
+            if (!Quoted && (*Current == ',' || *Current == '\n')) {
+                break;
+            }
+            if (*Current == '\n') {
+                // An unterminated quote ends with the line
+                break;
+            }
+            *Out++ = *Current++;
+        }
+        if (Out > *Strings && Out[-1] == '\r' && (Current == End || *Current == '\n')) {
+            Out--;
+        }
+        *Out++ = 0;
+        if (Current < End && *Current == ',') {
+            Current++;
+        } else {
+            LineEnded = true;
+        }
+    }
+    if (Current < End) {
+        Current++;
+    }
+    *Position = Current;
+    *Strings = Out;
+    return FieldsNumber;
+}
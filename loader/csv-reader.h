@@ -0,0 +1,30 @@
+#ifndef LLP_LAB1_CSV_READER_H
+#define LLP_LAB1_CSV_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Read only memory mapping of a whole input file.
+struct MappedFile {
+    const char *Data;
+    size_t Size;
+};
+
+bool mapFile(const char *Path, struct MappedFile *File);
+void unmapFile(struct MappedFile *File);
+
+// Splits Data into at most ChunksNumber pieces of about the same size, every
+// piece starts at the beginning of a line. Bounds gets ChunksNumber + 1 offsets,
+// piece i is [Bounds[i], Bounds[i + 1]) and may be empty.
+void splitLines(const char *Data, size_t Size, size_t ChunksNumber, size_t *Bounds);
+
+// Reads the line starting at *Position and moves *Position to the next one.
+// Fields are separated by commas and may be enclosed in double quotes, a quote
+// inside of a quoted field is written twice. Quoted fields can not span lines.
+// The fields are copied NUL terminated to *Strings, which is moved past them
+// and needs the length of the line plus one bytes. Up to MaxFields pointers
+// are stored to Fields, the number of fields of the line is returned.
+size_t readCsvLine(const char **Position, const char *End, char **Strings, char **Fields,
+                   size_t MaxFields);
+
+#endif //LLP_LAB1_CSV_READER_H
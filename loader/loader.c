@@ -0,0 +1,576 @@
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../interaction-graph/graph-db.h"
+#include "csv-reader.h"
+
+// Loads a CSV file of nodes and optionally an edge list into a graph. Worker
+// threads parse chunks of the mapped files, the main thread writes the parsed
+// chunks in file order through createNodesBulk and createNodeLinksBulk, so
+// writing a chunk overlaps with parsing the following ones.
+//
+// The first line of the nodes file names the columns. A column is matched with
+// the graph attribute of the same name, if the graph does not exist it is
+// created with the columns as attributes and every column has to be written as
+// name:type, where type is int, float, bool or string. With -c a created graph
+// keeps its attributes in columns.
+//
+// Every line of the edge list is left,right[,weight[,type]] where left and
+// right are numbers of the nodes file rows counting from zero, weight is 1 by
+// default and type is directional (default) or unidirectional. Lines starting
+// with # are skipped.
+
+#define LOADER_CHUNK_SIZE (4 << 20)
+
+struct Schema {
+    size_t AttributesNumber;
+    enum DATA_TYPE *Types;
+    size_t *Ids;
+    // Attribute position of every column
+    size_t *ColumnAttributes;
+};
+
+struct Chunk {
+    const char *Begin;
+    const char *End;
+    char *Strings;
+    void *Records;
+    size_t Rows;
+    size_t Lines;
+    // Line of the chunk with an error counting from one, zero if there is none
+    size_t ErrorLine;
+    const char *Error;
+};
+
+// Chunks are parsed by any worker and written one after another by the main
+// thread, workers stay at most MaxAhead chunks ahead of the writer.
+struct Pipeline {
+    pthread_mutex_t Lock;
+    pthread_cond_t Changed;
+    struct Chunk *Chunks;
+    bool *Parsed;
+    size_t ChunksNumber;
+    size_t NextChunk;
+    size_t Written;
+    size_t MaxAhead;
+    bool (*ParseLine)(const struct Pipeline *Pipeline, char **Fields, size_t FieldsNumber,
+                      void *Record);
+    size_t RecordSize;
+    size_t MaxFields;
+    bool SkipComments;
+    const struct Schema *Schema;
+    size_t NodesNumber;
+    size_t FirstNodeId;
+};
+
+static double getTime(void) {
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return Now.tv_sec + Now.tv_nsec / 1e9;
+}
+
+static const char *getTypeName(enum DATA_TYPE Type) {
+    switch (Type) {
+        case INT:
+            return "int";
+        case FLOAT:
+            return "float";
+        case BOOL:
+            return "bool";
+        case STRING:
+            return "string";
+    }
+    return "";
+}
+
+static bool parseType(const char *Name, enum DATA_TYPE *Type) {
+    const enum DATA_TYPE Types[] = {INT, FLOAT, BOOL, STRING};
+    for (size_t i = 0; i < sizeof(Types) / sizeof(Types[0]); ++i) {
+        if (strcasecmp(Name, getTypeName(Types[i])) == 0) {
+            *Type = Types[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseSize(const char *Field, size_t *Value) {
+    char *End;
+    errno = 0;
+    unsigned long long Result = strtoull(Field, &End, 10);
+    if (*Field == 0 || *Field == '-' || *End != 0 || errno != 0) {
+        return false;
+    }
+    *Value = Result;
+    return true;
+}
+
+static bool parseAttribute(const char *Field, const enum DATA_TYPE Type,
+                           struct ExternalAttribute *Attribute) {
+    char *End;
+    errno = 0;
+    Attribute->Type = Type;
+    switch (Type) {
+        case INT: {
+            long Value = strtol(Field, &End, 10);
+            if (*Field == 0 || *End != 0 || errno != 0 || Value < INT32_MIN || Value > INT32_MAX) {
+                return false;
+            }
+            Attribute->Value.IntValue = (int32_t) Value;
+            return true;
+        }
+        case FLOAT:
+            Attribute->Value.FloatValue = strtof(Field, &End);
+            return *Field != 0 && *End == 0;
+        case BOOL:
+            if (strcasecmp(Field, "true") == 0 || strcmp(Field, "1") == 0) {
+                Attribute->Value.BoolValue = true;
+                return true;
+            }
+            if (strcasecmp(Field, "false") == 0 || strcmp(Field, "0") == 0) {
+                Attribute->Value.BoolValue = false;
+                return true;
+            }
+            return false;
+        case STRING:
+            Attribute->Value.StringAddr = (char *) Field;
+            return true;
+    }
+    return false;
+}
+
+static bool parseNodeLine(const struct Pipeline *const Pipeline, char **Fields,
+                          const size_t FieldsNumber, void *Record) {
+    const struct Schema *const Schema = Pipeline->Schema;
+    struct ExternalAttribute *const Attributes = Record;
+    if (FieldsNumber != Schema->AttributesNumber) {
+        return false;
+    }
+    for (size_t i = 0; i < FieldsNumber; ++i) {
+        const size_t Position = Schema->ColumnAttributes[i];
+        Attributes[Position].Id = Schema->Ids[Position];
+        if (!parseAttribute(Fields[i], Schema->Types[Position], Attributes + Position)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parseEdgeLine(const struct Pipeline *const Pipeline, char **Fields,
+                          const size_t FieldsNumber, void *Record) {
+    struct ExternalNodeLink *const Link = Record;
+    size_t Left;
+    size_t Right;
+    if (FieldsNumber < 2 || FieldsNumber > 4 || !parseSize(Fields[0], &Left) ||
+        !parseSize(Fields[1], &Right) || Left >= Pipeline->NodesNumber ||
+        Right >= Pipeline->NodesNumber) {
+        return false;
+    }
+    Link->Id = 0;
+    Link->LeftNodeId = Pipeline->FirstNodeId + Left;
+    Link->RightNodeId = Pipeline->FirstNodeId + Right;
+    Link->Weight = 1.0f;
+    Link->Type = DIRECTIONAL;
+    if (FieldsNumber > 2) {
+        char *End;
+        Link->Weight = strtof(Fields[2], &End);
+        if (*Fields[2] == 0 || *End != 0) {
+            return false;
+        }
+    }
+    if (FieldsNumber > 3) {
+        if (strcasecmp(Fields[3], "unidirectional") == 0) {
+            Link->Type = UNIDIRECTIONAL;
+        } else if (strcasecmp(Fields[3], "directional") != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void parseChunk(const struct Pipeline *const Pipeline, struct Chunk *const Chunk) {
+    size_t MaxRows = 1;
+    for (const char *Line = Chunk->Begin; Line < Chunk->End; ++MaxRows) {
+        Line = memchr(Line, '\n', Chunk->End - Line);
+        if (Line == NULL) {
+            break;
+        }
+        Line++;
+    }
+    Chunk->Strings = malloc(Chunk->End - Chunk->Begin + 1);
+    Chunk->Records = malloc(MaxRows * Pipeline->RecordSize);
+    char **Fields = malloc(sizeof(char *) * Pipeline->MaxFields);
+    char *Strings = Chunk->Strings;
+    const char *Position = Chunk->Begin;
+    while (Position < Chunk->End) {
+        Chunk->Lines++;
+        if (*Position == '\n' || *Position == '\r' ||
+            (Pipeline->SkipComments && *Position == '#')) {
+            const char *LineEnd = memchr(Position, '\n', Chunk->End - Position);
+            Position = LineEnd == NULL ? Chunk->End : LineEnd + 1;
+            continue;
+        }
+        const size_t FieldsNumber =
+                readCsvLine(&Position, Chunk->End, &Strings, Fields, Pipeline->MaxFields);
+        void *Record = (char *) Chunk->Records + Chunk->Rows * Pipeline->RecordSize;
+        if (FieldsNumber > Pipeline->MaxFields ||
+            !Pipeline->ParseLine(Pipeline, Fields, FieldsNumber, Record)) {
+            Chunk->ErrorLine = Chunk->Lines;
+            Chunk->Error = "malformed line";
+            break;
+        }
+        Chunk->Rows++;
+    }
+    free(Fields);
+}
+
+static void *runWorker(void *Argument) {
+    struct Pipeline *const Pipeline = Argument;
+    pthread_mutex_lock(&Pipeline->Lock);
+    while (Pipeline->NextChunk < Pipeline->ChunksNumber) {
+        if (Pipeline->NextChunk >= Pipeline->Written + Pipeline->MaxAhead) {
+            pthread_cond_wait(&Pipeline->Changed, &Pipeline->Lock);
+            continue;
+        }
+        const size_t Index = Pipeline->NextChunk++;
+        pthread_mutex_unlock(&Pipeline->Lock);
+        parseChunk(Pipeline, Pipeline->Chunks + Index);
+        pthread_mutex_lock(&Pipeline->Lock);
+        Pipeline->Parsed[Index] = true;
+        pthread_cond_broadcast(&Pipeline->Changed);
+    }
+    pthread_mutex_unlock(&Pipeline->Lock);
+    return NULL;
+}
+
+// Parses Data with ThreadsNumber workers and hands every chunk to Write in
+// file order. Stops at the first malformed line or failed write, FirstLine is
+// the line number of the start of Data and is used for error messages.
+static bool runPipeline(struct Pipeline *const Pipeline, const char *Data, const size_t Size,
+                        const size_t ThreadsNumber, const char *FileName, const size_t FirstLine,
+                        bool (*Write)(void *Context, const struct Chunk *Chunk), void *Context) {
+    size_t ChunksNumber = Size / LOADER_CHUNK_SIZE + 1;
+    if (ChunksNumber < ThreadsNumber) {
+        ChunksNumber = ThreadsNumber;
+    }
+    size_t *Bounds = malloc(sizeof(size_t) * (ChunksNumber + 1));
+    splitLines(Data, Size, ChunksNumber, Bounds);
+    Pipeline->Chunks = calloc(ChunksNumber, sizeof(struct Chunk));
+    Pipeline->Parsed = calloc(ChunksNumber, sizeof(bool));
+    for (size_t i = 0; i < ChunksNumber; ++i) {
+        Pipeline->Chunks[i].Begin = Data + Bounds[i];
+        Pipeline->Chunks[i].End = Data + Bounds[i + 1];
+    }
+    free(Bounds);
+    Pipeline->ChunksNumber = ChunksNumber;
+    Pipeline->NextChunk = 0;
+    Pipeline->Written = 0;
+    Pipeline->MaxAhead = 2 * ThreadsNumber;
+    pthread_mutex_init(&Pipeline->Lock, NULL);
+    pthread_cond_init(&Pipeline->Changed, NULL);
+    pthread_t *Threads = malloc(sizeof(pthread_t) * ThreadsNumber);
+    for (size_t i = 0; i < ThreadsNumber; ++i) {
+        pthread_create(Threads + i, NULL, runWorker, Pipeline);
+    }
+    bool Result = true;
+    size_t Line = FirstLine;
+    for (size_t i = 0; i < ChunksNumber; ++i) {
+        struct Chunk *const Chunk = Pipeline->Chunks + i;
+        pthread_mutex_lock(&Pipeline->Lock);
+        while (!Pipeline->Parsed[i]) {
+            pthread_cond_wait(&Pipeline->Changed, &Pipeline->Lock);
+        }
+        pthread_mutex_unlock(&Pipeline->Lock);
+        if (Result && Chunk->Rows != 0 && !Write(Context, Chunk)) {
+            fprintf(stderr, "%s: can not write the rows near line %zu\n", FileName, Line);
+            Result = false;
+        }
+        if (Result && Chunk->ErrorLine != 0) {
+            fprintf(stderr, "%s:%zu: %s\n", FileName, Line + Chunk->ErrorLine - 1, Chunk->Error);
+            Result = false;
+        }
+        Line += Chunk->Lines;
+        free(Chunk->Records);
+        free(Chunk->Strings);
+        pthread_mutex_lock(&Pipeline->Lock);
+        // After a failure the remaining chunks are only parsed and dropped
+        Pipeline->Written = i + 1;
+        pthread_cond_broadcast(&Pipeline->Changed);
+        pthread_mutex_unlock(&Pipeline->Lock);
+    }
+    for (size_t i = 0; i < ThreadsNumber; ++i) {
+        pthread_join(Threads[i], NULL);
+    }
+    free(Threads);
+    pthread_cond_destroy(&Pipeline->Changed);
+    pthread_mutex_destroy(&Pipeline->Lock);
+    free(Pipeline->Parsed);
+    free(Pipeline->Chunks);
+    return Result;
+}
+
+struct NodesWriter {
+    struct StorageController *Controller;
+    char *GraphName;
+    size_t AttributesNumber;
+    size_t FirstId;
+    size_t Rows;
+};
+
+static bool writeNodes(void *Context, const struct Chunk *const Chunk) {
+    struct NodesWriter *const Writer = Context;
+    struct CreateNodesBulkRequest Request = {.GraphIdType = GRAPH_NAME,
+                                             .GraphId.GraphName = Writer->GraphName,
+                                             .Attributes = Chunk->Records,
+                                             .NodesNumber = Chunk->Rows};
+    const size_t FirstId = createNodesBulk(Writer->Controller, &Request);
+    if (FirstId == 0) {
+        return false;
+    }
+    if (Writer->Rows == 0) {
+        Writer->FirstId = FirstId;
+    }
+    Writer->Rows += Chunk->Rows;
+    return true;
+}
+
+struct LinksWriter {
+    struct StorageController *Controller;
+    char *GraphName;
+    size_t Rows;
+};
+
+static bool writeLinks(void *Context, const struct Chunk *const Chunk) {
+    struct LinksWriter *const Writer = Context;
+    struct CreateNodeLinksBulkRequest Request = {.GraphIdType = GRAPH_NAME,
+                                                 .GraphId.GraphName = Writer->GraphName,
+                                                 .Links = Chunk->Records,
+                                                 .LinksNumber = Chunk->Rows};
+    if (createNodeLinksBulk(Writer->Controller, &Request) == 0) {
+        return false;
+    }
+    Writer->Rows += Chunk->Rows;
+    return true;
+}
+
+static void freeSchema(struct Schema *const Schema) {
+    free(Schema->Types);
+    free(Schema->Ids);
+    free(Schema->ColumnAttributes);
+}
+
+// Maps the header columns to the attributes of the graph, creating the graph
+// if there is none with this name.
+static bool prepareSchema(struct StorageController *const Controller, char *GraphName,
+                          char **Columns, const size_t ColumnsNumber, const bool Columnar,
+                          struct Schema *const Schema) {
+    Schema->AttributesNumber = ColumnsNumber;
+    Schema->Types = malloc(sizeof(enum DATA_TYPE) * ColumnsNumber);
+    Schema->Ids = malloc(sizeof(size_t) * ColumnsNumber);
+    Schema->ColumnAttributes = malloc(sizeof(size_t) * ColumnsNumber);
+    bool *Typed = malloc(sizeof(bool) * ColumnsNumber);
+    bool *Mapped = calloc(ColumnsNumber, sizeof(bool));
+    enum DATA_TYPE *ColumnTypes = malloc(sizeof(enum DATA_TYPE) * ColumnsNumber);
+    bool Result = true;
+    for (size_t i = 0; i < ColumnsNumber && Result; ++i) {
+        char *Separator = strrchr(Columns[i], ':');
+        Typed[i] = Separator != NULL;
+        if (Typed[i]) {
+            *Separator = 0;
+            if (!parseType(Separator + 1, ColumnTypes + i)) {
+                fprintf(stderr, "unknown type of column %s: %s\n", Columns[i], Separator + 1);
+                Result = false;
+            }
+        }
+    }
+    struct ReadGraphRequest ReadRequest = {.Name = GraphName};
+    struct GraphResultSet *Graphs = readGraph(Controller, &ReadRequest);
+    struct ExternalGraph *Graph = NULL;
+    if (Result && !graphResultSetIsEmpty(Graphs)) {
+        readResultGraph(Graphs, &Graph);
+    }
+    deleteGraphResultSet(&Graphs);
+    if (Result && Graph != NULL) {
+        if (Graph->AttributesDescriptionNumber != ColumnsNumber) {
+            fprintf(stderr, "graph %s has %zu attributes, the file has %zu columns\n", GraphName,
+                    Graph->AttributesDescriptionNumber, ColumnsNumber);
+            Result = false;
+        }
+        for (size_t i = 0; i < ColumnsNumber && Result; ++i) {
+            size_t Position = 0;
+            while (Position < ColumnsNumber &&
+                   strcmp(Graph->AttributesDescription[Position].Name, Columns[i]) != 0) {
+                Position++;
+            }
+            if (Position == ColumnsNumber || Mapped[Position]) {
+                fprintf(stderr, "graph %s has no attribute %s or it is repeated\n", GraphName,
+                        Columns[i]);
+                Result = false;
+                break;
+            }
+            Mapped[Position] = true;
+            const struct ExternalAttributeDescription *const Description =
+                    Graph->AttributesDescription + Position;
+            if (Typed[i] && ColumnTypes[i] != Description->Type) {
+                fprintf(stderr, "attribute %s of graph %s has type %s\n", Columns[i], GraphName,
+                        getTypeName(Description->Type));
+                Result = false;
+            }
+            Schema->ColumnAttributes[i] = Position;
+            Schema->Types[Position] = Description->Type;
+            Schema->Ids[Position] = Description->AttributeId;
+        }
+        deleteExternalGraph(&Graph);
+    } else if (Result) {
+        struct ExternalAttributeDescription *Descriptions =
+                malloc(sizeof(struct ExternalAttributeDescription) * ColumnsNumber);
+        for (size_t i = 0; i < ColumnsNumber && Result; ++i) {
+            if (!Typed[i]) {
+                fprintf(stderr, "graph %s does not exist, column %s needs a type\n", GraphName,
+                        Columns[i]);
+                Result = false;
+                break;
+            }
+            Descriptions[i].AttributeId = i;
+            Descriptions[i].Name = Columns[i];
+            Descriptions[i].Type = ColumnTypes[i];
+            Descriptions[i].Next = i + 1 < ColumnsNumber ? Descriptions + i + 1 : NULL;
+            Schema->ColumnAttributes[i] = i;
+            Schema->Types[i] = ColumnTypes[i];
+            Schema->Ids[i] = i;
+        }
+        if (Result) {
+            struct CreateGraphRequest CreateRequest = {
+                    .Name = GraphName,
+                    .AttributesDescription = ColumnsNumber != 0 ? Descriptions : NULL,
+                    .Columnar = Columnar};
+            createGraph(Controller, &CreateRequest);
+        }
+        free(Descriptions);
+    }
+    free(ColumnTypes);
+    free(Mapped);
+    free(Typed);
+    if (!Result) {
+        freeSchema(Schema);
+    }
+    return Result;
+}
+
+static bool loadNodes(struct StorageController *const Controller, char *GraphName,
+                      const char *FileName, const size_t ThreadsNumber, const bool Columnar,
+                      struct NodesWriter *const Writer) {
+    struct MappedFile File;
+    if (!mapFile(FileName, &File)) {
+        fprintf(stderr, "%s: %s\n", FileName, strerror(errno));
+        return false;
+    }
+    const char *Body = memchr(File.Data, '\n', File.Size);
+    Body = Body == NULL ? File.Data + File.Size : Body + 1;
+    char *HeaderStrings = malloc(Body - File.Data + 1);
+    char *Strings = HeaderStrings;
+    const char *Position = File.Data;
+    const size_t ColumnsNumber = readCsvLine(&Position, Body, &Strings, NULL, 0);
+    char **Columns = malloc(sizeof(char *) * ColumnsNumber);
+    Strings = HeaderStrings;
+    Position = File.Data;
+    readCsvLine(&Position, Body, &Strings, Columns, ColumnsNumber);
+    struct Schema Schema;
+    bool Result = File.Size != 0 &&
+                  prepareSchema(Controller, GraphName, Columns, ColumnsNumber, Columnar, &Schema);
+    if (Result) {
+        struct Pipeline Pipeline = {.ParseLine = parseNodeLine,
+                                    .RecordSize = sizeof(struct ExternalAttribute) * ColumnsNumber,
+                                    .MaxFields = ColumnsNumber,
+                                    .Schema = &Schema};
+        *Writer = (struct NodesWriter){.Controller = Controller, .GraphName = GraphName};
+        Result = runPipeline(&Pipeline, Body, File.Data + File.Size - Body, ThreadsNumber,
+                             FileName, 2, writeNodes, Writer);
+        freeSchema(&Schema);
+    } else if (File.Size == 0) {
+        fprintf(stderr, "%s: no header line\n", FileName);
+    }
+    free(Columns);
+    free(HeaderStrings);
+    unmapFile(&File);
+    return Result;
+}
+
+static bool loadLinks(struct StorageController *const Controller, char *GraphName,
+                      const char *FileName, const size_t ThreadsNumber,
+                      const struct NodesWriter *const Nodes, struct LinksWriter *const Writer) {
+    struct MappedFile File;
+    if (!mapFile(FileName, &File)) {
+        fprintf(stderr, "%s: %s\n", FileName, strerror(errno));
+        return false;
+    }
+    struct Pipeline Pipeline = {.ParseLine = parseEdgeLine,
+                                .RecordSize = sizeof(struct ExternalNodeLink),
+                                .MaxFields = 4,
+                                .SkipComments = true,
+                                .NodesNumber = Nodes->Rows,
+                                .FirstNodeId = Nodes->FirstId};
+    *Writer = (struct LinksWriter){.Controller = Controller, .GraphName = GraphName};
+    const bool Result = runPipeline(&Pipeline, File.Data, File.Size, ThreadsNumber, FileName, 1,
+                                    writeLinks, Writer);
+    unmapFile(&File);
+    return Result;
+}
+
+static void reportRate(const char *What, const size_t Rows, const double Seconds) {
+    printf("%s: %zu rows in %.3f s, %.0f rows/s\n", What, Rows, Seconds,
+           Seconds > 0 ? Rows / Seconds : 0.0);
+}
+
+int main(int argc, char **argv) {
+    const char *Usage = "usage: %s [-c] [-j THREADS] [-e EDGES_CSV] DATA_FILE GRAPH_NAME NODES_CSV\n";
+    long ThreadsNumber = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *EdgesFileName = NULL;
+    bool Columnar = false;
+    int Option;
+    while ((Option = getopt(argc, argv, "cj:e:")) != -1) {
+        if (Option == 'c') {
+            Columnar = true;
+        } else if (Option == 'j') {
+            ThreadsNumber = strtol(optarg, NULL, 10);
+        } else if (Option == 'e') {
+            EdgesFileName = optarg;
+        } else {
+            fprintf(stderr, Usage, argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind != 3 || ThreadsNumber < 1) {
+        fprintf(stderr, Usage, argv[0]);
+        return 1;
+    }
+    char *DataFileName = argv[optind];
+    char *GraphName = argv[optind + 1];
+    const char *NodesFileName = argv[optind + 2];
+    struct StorageController *Controller = beginWork(DataFileName);
+    if (Controller == NULL) {
+        return 1;
+    }
+    const double Begin = getTime();
+    struct NodesWriter Nodes = {0};
+    bool Result = loadNodes(Controller, GraphName, NodesFileName, ThreadsNumber, Columnar,
+                            &Nodes);
+    const double NodesEnd = getTime();
+    reportRate("nodes", Nodes.Rows, NodesEnd - Begin);
+    if (Result && EdgesFileName != NULL) {
+        struct LinksWriter Links = {0};
+        Result = loadLinks(Controller, GraphName, EdgesFileName, ThreadsNumber, &Nodes, &Links);
+        const double LinksEnd = getTime();
+        reportRate("links", Links.Rows, LinksEnd - NodesEnd);
+        reportRate("total", Nodes.Rows + Links.Rows, LinksEnd - Begin);
+    }
+    endWork(Controller);
+    return Result ? 0 : 1;
+}
@@ -4,11 +4,32 @@
 
 int main() {
     const char *InsertBenchmarkResultName = "InsertTime.csv";
+    const char *BulkInsertBenchmarkResultName = "BulkInsertTime.csv";
+    const char *LinkBulkInsertBenchmarkResultName = "LinkBulkInsertTime.csv";
     const char *SelectBenchmarkResultName = "SelectByAttrsTime.csv";
     const char *DeleteBenchmarkResultName = "DeleteConstantElementsTime.csv";
     const char *UpdateProgressingBenchmarkResultName = "UpdateProgressingElementsTime.csv";
     const char *FileSizeBenchmarkResultName = "FileSizeByNodes.csv";
     const char *DopBenchmarkResultName = "DopBench.csv";
+    const char *AllocatorBenchmarkResultName = "AllocatorTime.csv";
+    const char *LookupByIdBenchmarkResultName = "LookupByIdTime.csv";
+    const char *LinkLookupBenchmarkResultName = "LinkLookupByNodeTime.csv";
+    const char *IndexedRangeBenchmarkResultName = "IndexedRangeSelectTime.csv";
+    const char *StringEqualBenchmarkResultName = "StringEqualSelectTime.csv";
+    const char *BoolBitmapBenchmarkResultName = "BoolBitmapSelectTime.csv";
+    const char *ZoneMapBenchmarkResultName = "ZoneMapSkipTime.csv";
+    const char *StreamingBenchmarkResultName = "StreamingSelectTime.csv";
+    const char *PaginationBenchmarkResultName = "PaginatedSelectTime.csv";
+    const char *CountBenchmarkResultName = "CountNodesTime.csv";
+    const char *ProjectionBenchmarkResultName = "ProjectedSelectTime.csv";
+    const char *NodeViewsBenchmarkResultName = "NodeViewsTime.csv";
+    const char *ScratchBenchmarkResultName = "ScratchAllocations.csv";
+    const char *FilterProgramBenchmarkResultName = "CompiledFiltersTime.csv";
+    const char *VectorFiltersBenchmarkResultName = "VectorFiltersTime.csv";
+    const char *ParallelScanBenchmarkResultName = "ParallelScanTime.csv";
+    const char *BlockDirectoryBenchmarkResultName = "BlockDirectoryTime.csv";
+    const char *CompactRecordsBenchmarkResultName = "CompactRecordsTime.csv";
+    const char *ColumnarScanBenchmarkResultName = "ColumnarScanTime.csv";
 
     FILE *Result;
 
@@ -16,6 +37,14 @@ int main() {
     benchmarkNodeInsert(Result);
     fclose(Result);
 
+    Result = fopen(BulkInsertBenchmarkResultName, "w");
+    benchmarkNodeBulkInsert(Result);
+    fclose(Result);
+
+    Result = fopen(LinkBulkInsertBenchmarkResultName, "w");
+    benchmarkNodeLinkBulkInsert(Result);
+    fclose(Result);
+
     Result = fopen(SelectBenchmarkResultName, "w");
     benchmarkSelectByAttributes(Result);
     fclose(Result);
@@ -24,10 +53,86 @@ int main() {
     benchmarkUpdateProgressingElements(Result);
     fclose(Result);
 
+    Result = fopen(AllocatorBenchmarkResultName, "w");
+    benchmarkAllocator(Result);
+    fclose(Result);
+
     Result = fopen(FileSizeBenchmarkResultName, "w");
     benchmarkFileSize(Result);
     fclose(Result);
 
+    Result = fopen(LookupByIdBenchmarkResultName, "w");
+    benchmarkNodeLookupById(Result);
+    fclose(Result);
+
+    Result = fopen(LinkLookupBenchmarkResultName, "w");
+    benchmarkLinkLookupByNode(Result);
+    fclose(Result);
+
+    Result = fopen(IndexedRangeBenchmarkResultName, "w");
+    benchmarkIndexedRangeSelect(Result);
+    fclose(Result);
+
+    Result = fopen(StringEqualBenchmarkResultName, "w");
+    benchmarkStringEqualSelect(Result);
+    fclose(Result);
+
+    Result = fopen(BoolBitmapBenchmarkResultName, "w");
+    benchmarkBoolBitmapSelect(Result);
+    fclose(Result);
+
+    Result = fopen(ZoneMapBenchmarkResultName, "w");
+    benchmarkZoneMapSkip(Result);
+    fclose(Result);
+
+    Result = fopen(StreamingBenchmarkResultName, "w");
+    benchmarkStreamingSelect(Result);
+    fclose(Result);
+
+    Result = fopen(PaginationBenchmarkResultName, "w");
+    benchmarkPaginatedSelect(Result);
+    fclose(Result);
+
+    Result = fopen(CountBenchmarkResultName, "w");
+    benchmarkCountNodes(Result);
+    fclose(Result);
+
+    Result = fopen(ProjectionBenchmarkResultName, "w");
+    benchmarkProjectedSelect(Result);
+    fclose(Result);
+
+    Result = fopen(NodeViewsBenchmarkResultName, "w");
+    benchmarkNodeViews(Result);
+    fclose(Result);
+
+    Result = fopen(ScratchBenchmarkResultName, "w");
+    benchmarkScratchAllocations(Result);
+    fclose(Result);
+
+    Result = fopen(FilterProgramBenchmarkResultName, "w");
+    benchmarkCompiledFilters(Result);
+    fclose(Result);
+
+    Result = fopen(VectorFiltersBenchmarkResultName, "w");
+    benchmarkVectorFilters(Result);
+    fclose(Result);
+
+    Result = fopen(ParallelScanBenchmarkResultName, "w");
+    benchmarkParallelScan(Result);
+    fclose(Result);
+
+    Result = fopen(BlockDirectoryBenchmarkResultName, "w");
+    benchmarkBlockDirectory(Result);
+    fclose(Result);
+
+    Result = fopen(CompactRecordsBenchmarkResultName, "w");
+    benchmarkCompactRecords(Result);
+    fclose(Result);
+
+    Result = fopen(ColumnarScanBenchmarkResultName, "w");
+    benchmarkColumnarScan(Result);
+    fclose(Result);
+
     Result = fopen(DeleteBenchmarkResultName, "w");
     benchmarkDeleteElements(Result);
     fclose(Result);
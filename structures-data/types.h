@@ -2,6 +2,7 @@
 #define LLP_LAB1_TYPES_H
 
 
+#include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -17,12 +18,30 @@ struct AddrInfo {
     size_t DataOffset;
 };
 
-#define SMALL_STRING_LIMIT 48
+// Address kept in records: the block offset in the high bits and the offset in
+// the block in the low PACKED_DATA_OFFSET_BITS. No block starts at offset 0 of
+// the file, which holds the superblock, so a zero word means no address and a
+// record field that was never written reads as one. It is only 4-byte aligned
+// so that short strings fit next to their length.
+struct PackedAddr {
+    uint64_t Value;
+} __attribute__((packed, aligned(4)));
+
+#define PACKED_DATA_OFFSET_BITS 28
+// Blocks referenced from records must not be larger
+#define PACKED_DATA_OFFSET_LIMIT ((size_t) 1 << PACKED_DATA_OFFSET_BITS)
+// Nor start further into the file
+#define PACKED_BLOCK_OFFSET_LIMIT ((size_t) 1 << (64 - PACKED_DATA_OFFSET_BITS))
+
+#define NULL_PACKED_ADDR                                                                       \
+    (struct PackedAddr) { 0 }
+
+#define SMALL_STRING_LIMIT 12
 
 struct MyString {
-    size_t Length;
+    uint32_t Length;
     union StringData {
-        struct AddrInfo DataPtr;
+        struct PackedAddr DataPtr;
         char InlinedData[SMALL_STRING_LIMIT];
     } Data;
 };
@@ -30,6 +49,25 @@ struct MyString {
 #define NULL_FULL_ADDR                                                                         \
     (struct AddrInfo) { false, 0, 0 }
 
+static inline struct PackedAddr packAddr(struct AddrInfo Addr) {
+    if (!Addr.HasValue) {
+        return NULL_PACKED_ADDR;
+    }
+    // Anything past the limits would turn into another valid address
+    assert(Addr.BlockOffset > 0 && Addr.BlockOffset < PACKED_BLOCK_OFFSET_LIMIT);
+    assert(Addr.DataOffset < PACKED_DATA_OFFSET_LIMIT);
+    return (struct PackedAddr){(uint64_t) Addr.BlockOffset << PACKED_DATA_OFFSET_BITS |
+                               Addr.DataOffset};
+}
+
+static inline struct AddrInfo unpackAddr(struct PackedAddr Addr) {
+    if (Addr.Value == 0) {
+        return NULL_FULL_ADDR;
+    }
+    return (struct AddrInfo){true, Addr.Value >> PACKED_DATA_OFFSET_BITS,
+                             Addr.Value & (PACKED_DATA_OFFSET_LIMIT - 1)};
+}
+
 static inline struct AddrInfo getOptionalFullAddr(size_t BlockOffset,
                                                   size_t DataOffset) {
     return (struct AddrInfo){true, BlockOffset, DataOffset};
@@ -58,7 +96,7 @@ struct AttributeDescription {
 };
 
 struct Attribute {
-    size_t Id;
+    uint32_t Id;
     enum DATA_TYPE Type;
     union Value {
         int32_t IntValue;
@@ -66,7 +104,6 @@ struct Attribute {
         struct MyString StringValue;
         bool BoolValue;
     } Value;
-    struct AddrInfo Next;
 };
 
 struct String {
@@ -77,9 +114,12 @@ struct String {
 struct Node {
     size_t Id;
     bool Deleted;
-    struct AddrInfo Previous;
-    struct AddrInfo Attributes;
-    struct AddrInfo Next;
+    size_t Slot;
+    struct PackedAddr Previous;
+    struct PackedAddr Attributes;
+    struct PackedAddr Next;
+    struct PackedAddr OutLinks;
+    struct PackedAddr InLinks;
 };
 
 struct NodeLink {
@@ -89,8 +129,20 @@ struct NodeLink {
     size_t RightNodeId;
     enum ConnectionType Type;
     float Weight;
-    struct AddrInfo Next;
-    struct AddrInfo Previous;
+    struct PackedAddr Next;
+    struct PackedAddr Previous;
+    struct PackedAddr NextOutLink;
+    struct PackedAddr PrevOutLink;
+    struct PackedAddr NextInLink;
+    struct PackedAddr PrevInLink;
+};
+
+// Runs of a node or link chain, see block-directory.h
+struct BlockDirectory {
+    struct AddrInfo Entries;
+    size_t Capacity;
+    size_t Used;
+    size_t Records;
 };
 
 struct Graph {
@@ -112,9 +164,21 @@ struct Graph {
     struct AddrInfo LastLink;
     struct AddrInfo Next;
     struct AddrInfo Previous;
+    struct AddrInfo NodeIndex;
+    size_t NodeIndexCapacity;
+    size_t NodeIndexUsed;
+    struct AddrInfo AttributeIndexes;
+    struct AddrInfo ZoneMaps;
+    size_t ZoneMapChunks;
+    struct BlockDirectory NodeBlocks;
+    struct BlockDirectory LinkBlocks;
+    // Attributes are kept in columns, see column-store.h
+    bool Columnar;
 };
 
 struct GraphStorage {
+    uint32_t Magic;
+    uint32_t FormatVersion;
     size_t GraphCounter;
     size_t NextGraphId;
     size_t NextNodeId;
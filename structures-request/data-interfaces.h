@@ -41,6 +41,16 @@ struct ExternalNodeLink {
     float Weight;
 };
 
+// Opaque position in the results of a read. A read given a token continues
+// right after the last result of the page it was taken from.
+struct ResumeToken {
+    bool HasValue;
+    bool ByIndex;
+    struct AddrInfo Addr;
+    size_t Key;
+    size_t Passed;
+};
+
 struct ExternalGraph {
     size_t Id;
     char *Name;
@@ -13,6 +13,9 @@ enum CreateRequestType {
     CREATE_NODE,
     CREATE_NODE_LINK,
     CREATE_GRAPH,
+    CREATE_INDEX,
+    CREATE_NODES_BULK,
+    CREATE_NODE_LINKS_BULK,
 };
 
 enum GraphIdType { GRAPH_ID, GRAPH_NAME };
@@ -28,6 +31,15 @@ struct CreateNodeRequest {
     struct ExternalAttribute *Attributes;
 };
 
+// Attributes holds NodesNumber groups of attributes, one group per node laid
+// out as for CreateNodeRequest.
+struct CreateNodesBulkRequest {
+    enum GraphIdType GraphIdType;
+    union GraphId GraphId;
+    struct ExternalAttribute *Attributes;
+    size_t NodesNumber;
+};
+
 struct CreateNodeLinkRequest {
     enum GraphIdType GraphIdType;
     union GraphId GraphId;
@@ -37,9 +49,26 @@ struct CreateNodeLinkRequest {
     float Weight;
 };
 
+// The Id fields of Links are ignored.
+struct CreateNodeLinksBulkRequest {
+    enum GraphIdType GraphIdType;
+    union GraphId GraphId;
+    struct ExternalNodeLink *Links;
+    size_t LinksNumber;
+};
+
 struct CreateGraphRequest {
     char *Name;
     struct ExternalAttributeDescription *AttributesDescription;
+    // Keeps the attributes of the nodes in per attribute columns, which suits
+    // scans filtering or aggregating a few attributes of many nodes
+    bool Columnar;
+};
+
+struct CreateIndexRequest {
+    enum GraphIdType GraphIdType;
+    union GraphId GraphId;
+    size_t AttributeId;
 };
 
 struct CreateRequest {
@@ -48,6 +77,9 @@ struct CreateRequest {
         struct CreateNodeRequest Node;
         struct CreateNodeLinkRequest NodeLink;
         struct CreateGraphRequest Graph;
+        struct CreateIndexRequest Index;
+        struct CreateNodesBulkRequest NodesBulk;
+        struct CreateNodeLinksBulkRequest NodeLinksBulk;
     } Data;
 };
 
@@ -114,6 +146,19 @@ struct ReadNodeRequest {
     const struct AttributeFilter *AttributesFilterChain;
     bool ById;
     size_t Id;
+    // Matches are searched for while the result set is read instead of all at
+    // once. The filter chain has to live until the result set is deleted and
+    // the graph must not be changed in between.
+    bool Streaming;
+    // At most Limit results (all of them if it is 0) after skipping Offset
+    // matches, which are counted from the resume token if it has a value.
+    size_t Limit;
+    size_t Offset;
+    struct ResumeToken After;
+    // Ids of the attributes to return in this order, all attributes are
+    // returned if it is NULL
+    const size_t *Projection;
+    size_t ProjectionLength;
 };
 
 enum NodeLinkRequestType { BY_ID, BY_LEFT_NODE_ID, BY_RIGHT_NODE_ID, ALL };
@@ -123,6 +168,10 @@ struct ReadNodeLinkRequest {
     union GraphId GraphId;
     enum NodeLinkRequestType Type;
     size_t Id;
+    // Same as in ReadNodeRequest
+    size_t Limit;
+    size_t Offset;
+    struct ResumeToken After;
 };
 
 struct ReadGraphRequest {
@@ -8,22 +8,60 @@
 struct NodeResultSet;
 struct NodeLinkResultSet;
 struct GraphResultSet;
+struct StorageController;
+struct Attribute;
+
+// Node read in place: Attributes points into the mapped file and strings are
+// taken with nodeViewGetString, nothing is allocated or copied. A view stays
+// valid while the read epoch is pinned, the projection of the request is not
+// applied to it. Attributes of a columnar graph are gathered into a buffer of
+// the result set instead, they stay valid until the next readResultNodeView.
+struct NodeView {
+    const struct StorageController *Controller;
+    size_t Id;
+    const struct Attribute *Attributes;
+    size_t AttributesNumber;
+};
 
 bool readResultNode(struct NodeResultSet *ResultSet, struct ExternalNode **Node);
 bool nodeResultSetIsEmpty(struct NodeResultSet *ResultSet);
+// A streaming result set only knows the number of nodes found so far.
 size_t nodeResultSetGetSize(struct NodeResultSet *ResultSet);
 void deleteNodeResultSet(struct NodeResultSet **ResultSet);
+bool hasNextNode(struct NodeResultSet *ResultSet);
+bool moveToNextNode(struct NodeResultSet *ResultSet);
+bool hasPreviousNode(struct NodeResultSet *ResultSet);
+bool moveToPreviousNode(struct NodeResultSet *ResultSet);
+// Token of the page after the nodes read so far, it has no value when no more
+// nodes can follow.
+struct ResumeToken nodeResultSetGetResumeToken(struct NodeResultSet *ResultSet);
+bool readResultNodeView(struct NodeResultSet *ResultSet, struct NodeView *View);
+// Returns NULL if the view has no attribute with the id.
+const struct Attribute *nodeViewGetAttribute(const struct NodeView *View, size_t AttributeId);
+// NUL terminated value of a STRING attribute of the view.
+const char *nodeViewGetString(const struct NodeView *View, const struct Attribute *Attribute);
 
 bool readResultNodeLink(struct NodeLinkResultSet *ResultSet,
                         struct ExternalNodeLink **NodeLink);
 bool nodeLinkResultSetIsEmpty(struct NodeLinkResultSet *ResultSet);
 size_t nodeLinkResultSetGetSize(struct NodeLinkResultSet *ResultSet);
 void deleteNodeLinkResultSet(struct NodeLinkResultSet **ResultSet);
+bool hasNextNodeLink(struct NodeLinkResultSet *ResultSet);
+bool moveToNextNodeLink(struct NodeLinkResultSet *ResultSet);
+bool hasPreviousNodeLink(struct NodeLinkResultSet *ResultSet);
+bool moveToPreviousNodeLink(struct NodeLinkResultSet *ResultSet);
+// Token of the page after the result set, it has no value when no more links
+// follow.
+struct ResumeToken nodeLinkResultSetGetResumeToken(struct NodeLinkResultSet *ResultSet);
 
 bool readResultGraph(struct GraphResultSet *ResultSet, struct ExternalGraph **graph);
 bool graphResultSetIsEmpty(struct GraphResultSet *ResultSet);
 size_t graphResultSetGetSize(struct GraphResultSet *ResultSet);
 void deleteGraphResultSet(struct GraphResultSet **ResultSet);
+bool hasNextGraph(struct GraphResultSet *ResultSet);
+bool moveToNextGraph(struct GraphResultSet *ResultSet);
+bool hasPreviousGraph(struct GraphResultSet *ResultSet);
+bool moveToPreviousGraph(struct GraphResultSet *ResultSet);
 
 
 #endif //LLP_LAB1_RESPONSE_STRUCTURES_H
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../configs/bech-config.h"
+
+#define TEST_FILE "crud-test.bin"
+
+static int Failures = 0;
+
+#define CHECK(Condition)                                                                          \
+    do {                                                                                          \
+        if (!(Condition)) {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);         \
+            Failures++;                                                                           \
+        }                                                                                         \
+    } while (0)
+
+static struct StorageController *openEmptyStorage(void) {
+    remove(TEST_FILE);
+    return beginWork(TEST_FILE);
+}
+
+static size_t readNodesNumber(const struct StorageController *const Controller,
+                              const char *const GraphName,
+                              const struct AttributeFilter *const FilterChain) {
+    struct ReadNodeRequest RNR = {.GraphIdType = GRAPH_NAME,
+                                  .GraphId.GraphName = (char *) GraphName,
+                                  .AttributesFilterChain = FilterChain};
+    struct NodeResultSet *NRS = readNode(Controller, &RNR);
+    const size_t Result = nodeResultSetGetSize(NRS);
+    deleteNodeResultSet(&NRS);
+    // countNodes takes its own paths through the indexes and zone maps
+    CHECK(countNodes(Controller, &RNR) == Result);
+    CHECK(existsNode(Controller, &RNR) == (Result != 0));
+    return Result;
+}
+
+// Nodes may list their attributes in any order. The zone map of the chunk
+// must still keep the ranges of the two attributes apart.
+static void testZoneMapOutOfOrderAttributes(void) {
+    struct StorageController *Controller = openEmptyStorage();
+    struct ExternalAttributeDescription GraphAttributes[2] = {
+            {.AttributeId = 0, .Name = "Key", .Type = INT, .Next = GraphAttributes + 1},
+            {.AttributeId = 1, .Name = "Payload", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute First[2] = {{.Id = 0, .Type = INT, .Value.IntValue = 5},
+                                         {.Id = 1, .Type = INT, .Value.IntValue = 1000}};
+    struct ExternalAttribute Second[2] = {{.Id = 1, .Type = INT, .Value.IntValue = 2000},
+                                          {.Id = 0, .Type = INT, .Value.IntValue = 7}};
+    struct CreateNodeRequest CNR = {.GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    CNR.Attributes = First;
+    CHECK(createNode(Controller, &CNR) != 0);
+    CNR.Attributes = Second;
+    CHECK(createNode(Controller, &CNR) != 0);
+    struct AttributeFilter KeyFilter = {
+            .AttributeId = 0,
+            .Type = INT_FILTER,
+            .Data.Int = {.HasMin = true, .Min = 5, .HasMax = true, .Max = 5}};
+    CHECK(readNodesNumber(Controller, "G", &KeyFilter) == 1);
+    KeyFilter.Data.Int.Min = KeyFilter.Data.Int.Max = 7;
+    CHECK(readNodesNumber(Controller, "G", &KeyFilter) == 1);
+    struct AttributeFilter PayloadFilter = {
+            .AttributeId = 1,
+            .Type = INT_FILTER,
+            .Data.Int = {.HasMin = true, .Min = 1500, .HasMax = false}};
+    CHECK(readNodesNumber(Controller, "G", &PayloadFilter) == 1);
+
+    // The same nodes inserted as one batch
+    struct ExternalAttribute Batch[4] = {First[0], First[1], Second[0], Second[1]};
+    CGR.Name = "Bulk";
+    createGraph(Controller, &CGR);
+    struct CreateNodesBulkRequest CNBR = {.GraphIdType = GRAPH_NAME,
+                                          .GraphId.GraphName = "Bulk",
+                                          .Attributes = Batch,
+                                          .NodesNumber = 2};
+    CHECK(createNodesBulk(Controller, &CNBR) != 0);
+    KeyFilter.Data.Int.Min = KeyFilter.Data.Int.Max = 5;
+    CHECK(readNodesNumber(Controller, "Bulk", &KeyFilter) == 1);
+    CHECK(readNodesNumber(Controller, "Bulk", &PayloadFilter) == 1);
+
+    // Columnar graphs store the attributes in declaration order
+    CGR.Name = "Columns";
+    CGR.Columnar = true;
+    createGraph(Controller, &CGR);
+    CNR.GraphId.GraphName = "Columns";
+    CNR.Attributes = First;
+    CHECK(createNode(Controller, &CNR) != 0);
+    CNR.Attributes = Second;
+    CHECK(createNode(Controller, &CNR) != 0);
+    CHECK(readNodesNumber(Controller, "Columns", &KeyFilter) == 1);
+    KeyFilter.Data.Int.Min = KeyFilter.Data.Int.Max = 7;
+    CHECK(readNodesNumber(Controller, "Columns", &KeyFilter) == 1);
+    CHECK(readNodesNumber(Controller, "Columns", &PayloadFilter) == 1);
+    endWork(Controller);
+    remove(TEST_FILE);
+}
+
+// Attribute ids the graph does not declare are refused before any node is
+// written.
+static void testUndeclaredAttributeId(void) {
+    struct StorageController *Controller = openEmptyStorage();
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Key", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute Undeclared[1] = {{.Id = 1, .Type = INT, .Value.IntValue = 1}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = Undeclared, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    CHECK(createNode(Controller, &CNR) == 0);
+    CHECK(readNodesNumber(Controller, "G", NULL) == 0);
+    struct ExternalAttribute Declared[1] = {{.Id = 0, .Type = INT, .Value.IntValue = 1}};
+    CNR.Attributes = Declared;
+    CHECK(createNode(Controller, &CNR) != 0);
+    struct UpdateNodeRequest UNR = {.GraphIdType = GRAPH_NAME,
+                                    .GraphId.GraphName = "G",
+                                    .UpdatedAttributesNumber = 1,
+                                    .Attributes = Undeclared,
+                                    .ById = false};
+    CHECK(updateNode(Controller, &UNR) == 0);
+    endWork(Controller);
+    remove(TEST_FILE);
+}
+
+static size_t readLinksNumber(const struct StorageController *const Controller,
+                              const enum NodeLinkRequestType Type, const size_t Id) {
+    struct ReadNodeLinkRequest RNLR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G", .Type = Type, .Id = Id};
+    struct NodeLinkResultSet *NLRS = readNodeLink(Controller, &RNLR);
+    const size_t Result = nodeLinkResultSetGetSize(NLRS);
+    deleteNodeLinkResultSet(&NLRS);
+    return Result;
+}
+
+// Single and batched link inserts share the link chain, both have to keep it
+// whole across link blocks.
+static void testLinkChainAcrossBlocks(void) {
+    struct StorageController *Controller = openEmptyStorage();
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Key", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    const size_t Left = createNode(Controller, &CNR);
+    const size_t Right = createNode(Controller, &CNR);
+    struct CreateNodeLinkRequest CNLR = {.GraphIdType = GRAPH_NAME,
+                                         .GraphId.GraphName = "G",
+                                         .LeftNodeId = Left,
+                                         .RightNodeId = Right};
+    const size_t BatchSize = GRAPH_LINKS_PER_BLOCK + GRAPH_LINKS_PER_BLOCK / 2;
+    struct ExternalNodeLink *Batch = calloc(BatchSize, sizeof(struct ExternalNodeLink));
+    for (size_t i = 0; i < BatchSize; ++i) {
+        Batch[i].LeftNodeId = Right;
+        Batch[i].RightNodeId = Left;
+    }
+    struct CreateNodeLinksBulkRequest CNLBR = {.GraphIdType = GRAPH_NAME,
+                                               .GraphId.GraphName = "G",
+                                               .Links = Batch,
+                                               .LinksNumber = BatchSize};
+    size_t Created = 0;
+    for (size_t i = 0; i < GRAPH_LINKS_PER_BLOCK + 10; ++i) {
+        Created += createNodeLink(Controller, &CNLR) != 0;
+    }
+    Created += createNodeLinksBulk(Controller, &CNLBR) != 0 ? BatchSize : 0;
+    for (size_t i = 0; i < 10; ++i) {
+        Created += createNodeLink(Controller, &CNLR) != 0;
+    }
+    CHECK(Created == GRAPH_LINKS_PER_BLOCK + 20 + BatchSize);
+    CHECK(readLinksNumber(Controller, ALL, 0) == Created);
+    CHECK(readLinksNumber(Controller, BY_LEFT_NODE_ID, Left) == GRAPH_LINKS_PER_BLOCK + 20);
+    CHECK(readLinksNumber(Controller, BY_RIGHT_NODE_ID, Left) == BatchSize);
+    free(Batch);
+    endWork(Controller);
+    remove(TEST_FILE);
+}
+
+// The Next of the last link points to the free slot after it, whose zeroed
+// words must not lead a lookup past the end of the chain.
+static void testLinkChainEnd(void) {
+    struct StorageController *Controller = openEmptyStorage();
+    struct ExternalAttributeDescription GraphAttributes[1] = {
+            {.AttributeId = 0, .Name = "Key", .Type = INT, .Next = NULL}};
+    struct CreateGraphRequest CGR = {.AttributesDescription = GraphAttributes, .Name = "G"};
+    createGraph(Controller, &CGR);
+    struct ExternalAttribute NodeAttributes[1] = {{.Id = 0, .Type = INT}};
+    struct CreateNodeRequest CNR = {
+            .Attributes = NodeAttributes, .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G"};
+    const size_t Left = createNode(Controller, &CNR);
+    const size_t Right = createNode(Controller, &CNR);
+    struct CreateNodeLinkRequest CNLR = {.GraphIdType = GRAPH_NAME,
+                                         .GraphId.GraphName = "G",
+                                         .LeftNodeId = Left,
+                                         .RightNodeId = Right};
+    createNodeLink(Controller, &CNLR);
+    const size_t LinkId = createNodeLink(Controller, &CNLR);
+    struct DeleteNodeLinkRequest DNLR = {
+            .GraphIdType = GRAPH_NAME, .GraphId.GraphName = "G", .Type = BY_ID, .Id = LinkId};
+    CHECK(deleteNodeLink(Controller, &DNLR) == 1);
+    CHECK(deleteNodeLink(Controller, &DNLR) == 0);
+    DNLR.Id = LinkId + 100;
+    CHECK(deleteNodeLink(Controller, &DNLR) == 0);
+    // Ids start at 1, the zeroed slot after the last link reads as id 0
+    DNLR.Id = 0;
+    CHECK(deleteNodeLink(Controller, &DNLR) == 0);
+    struct UpdateNodeLinkRequest UNLR = {.GraphIdType = GRAPH_NAME,
+                                         .GraphId.GraphName = "G",
+                                         .Id = LinkId + 100,
+                                         .UpdateWeight = true,
+                                         .Weight = 1};
+    CHECK(updateNodeLink(Controller, &UNLR) == 0);
+    CHECK(readLinksNumber(Controller, BY_ID, LinkId) == 0);
+    CHECK(readLinksNumber(Controller, ALL, 0) == 1);
+    endWork(Controller);
+    remove(TEST_FILE);
+}
+
+int main(void) {
+    testZoneMapOutOfOrderAttributes();
+    testUndeclaredAttributeId();
+    testLinkChainAcrossBlocks();
+    testLinkChainEnd();
+    if (Failures != 0) {
+        fprintf(stderr, "%d checks failed\n", Failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,596 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../interaction-file/file-io.h"
+#include "../interaction-graph/graph-db.h"
+#include "../interaction-graph/storage-manager.h"
+
+// Converts a storage of an older format into a new file of the current one.
+// Records of format version 1 keep 24-byte AddrInfo addresses, graph headers
+// of version 2 have no Columnar flag and are otherwise read as current ones.
+// Graphs, nodes, links and indexes are created again through the usual
+// requests with their old ids, so the converted file is also vacuumed: lazily
+// deleted records are left out.
+
+#define UPGRADE_BATCH_SIZE 4096
+
+// Records of format version 1
+#define V1_SMALL_STRING_LIMIT 48
+
+struct V1String {
+    size_t Length;
+    union V1StringData {
+        struct AddrInfo DataPtr;
+        char InlinedData[V1_SMALL_STRING_LIMIT];
+    } Data;
+};
+
+struct V1AttributeDescription {
+    enum DATA_TYPE Type;
+    struct V1String Name;
+    struct AddrInfo Next;
+    size_t AttributeId;
+};
+
+struct V1Attribute {
+    size_t Id;
+    enum DATA_TYPE Type;
+    union V1Value {
+        int32_t IntValue;
+        float FloatValue;
+        struct V1String StringValue;
+        bool BoolValue;
+    } Value;
+    struct AddrInfo Next;
+};
+
+struct V1Node {
+    size_t Id;
+    bool Deleted;
+    size_t Slot;
+    struct AddrInfo Previous;
+    struct AddrInfo Attributes;
+    struct AddrInfo Next;
+    struct AddrInfo OutLinks;
+    struct AddrInfo InLinks;
+};
+
+struct V1NodeLink {
+    size_t Id;
+    bool Deleted;
+    size_t LeftNodeId;
+    size_t RightNodeId;
+    enum ConnectionType Type;
+    float Weight;
+    struct AddrInfo Next;
+    struct AddrInfo Previous;
+    struct AddrInfo NextOutLink;
+    struct AddrInfo PrevOutLink;
+    struct AddrInfo NextInLink;
+    struct AddrInfo PrevInLink;
+};
+
+struct V1Graph {
+    size_t Id;
+    size_t NodeCounter;
+    size_t LinkCounter;
+    size_t AttributeCounter;
+    size_t LazyDeletedNodeCounter;
+    size_t LazyDeletedLinkCounter;
+    size_t NodesPlaceable;
+    size_t LinksPlaceable;
+    size_t PlacedNodes;
+    size_t PlacedLinks;
+    struct V1String Name;
+    struct AddrInfo Nodes;
+    struct AddrInfo AttributesDecription;
+    struct AddrInfo LastNode;
+    struct AddrInfo Links;
+    struct AddrInfo LastLink;
+    struct AddrInfo Next;
+    struct AddrInfo Previous;
+    struct AddrInfo NodeIndex;
+    size_t NodeIndexCapacity;
+    size_t NodeIndexUsed;
+    struct AddrInfo AttributeIndexes;
+    struct AddrInfo ZoneMaps;
+    size_t ZoneMapChunks;
+    struct BlockDirectory NodeBlocks;
+    struct BlockDirectory LinkBlocks;
+};
+
+struct V1GraphStorage {
+    size_t GraphCounter;
+    size_t NextGraphId;
+    size_t NextNodeId;
+    size_t NextNodeLinkId;
+    struct AddrInfo Graphs;
+    struct AddrInfo LastGraph;
+};
+
+struct V1AttributeIndex {
+    size_t AttributeId;
+    enum DATA_TYPE AttributeType;
+    int Type;
+    struct AddrInfo Root;
+    struct AddrInfo Next;
+};
+
+// Records of format version 2, only the graph header differs from the current
+// format
+struct V2Graph {
+    size_t Id;
+    size_t NodeCounter;
+    size_t LinkCounter;
+    size_t AttributeCounter;
+    size_t LazyDeletedNodeCounter;
+    size_t LazyDeletedLinkCounter;
+    size_t NodesPlaceable;
+    size_t LinksPlaceable;
+    size_t PlacedNodes;
+    size_t PlacedLinks;
+    struct MyString Name;
+    struct AddrInfo Nodes;
+    struct AddrInfo AttributesDecription;
+    struct AddrInfo LastNode;
+    struct AddrInfo Links;
+    struct AddrInfo LastLink;
+    struct AddrInfo Next;
+    struct AddrInfo Previous;
+    struct AddrInfo NodeIndex;
+    size_t NodeIndexCapacity;
+    size_t NodeIndexUsed;
+    struct AddrInfo AttributeIndexes;
+    struct AddrInfo ZoneMaps;
+    size_t ZoneMapChunks;
+    struct BlockDirectory NodeBlocks;
+    struct BlockDirectory LinkBlocks;
+};
+
+static char *readV1String(const struct FileAllocator *const Allocator,
+                          const struct V1String String) {
+    char *Result = malloc(String.Length + 1);
+    if (String.Length > V1_SMALL_STRING_LIMIT) {
+        fetchData(Allocator, String.Data.DataPtr, String.Length, Result);
+    } else {
+        memcpy(Result, String.Data.InlinedData, String.Length);
+    }
+    Result[String.Length] = 0;
+    return Result;
+}
+
+// Length of a current string counts its terminating zero
+static char *readV2String(const struct FileAllocator *const Allocator,
+                          const struct MyString String) {
+    char *Result = malloc(String.Length);
+    if (String.Length > SMALL_STRING_LIMIT) {
+        fetchData(Allocator, unpackAddr(String.Data.DataPtr), String.Length, Result);
+    } else {
+        memcpy(Result, String.Data.InlinedData, String.Length);
+    }
+    return Result;
+}
+
+// Fields of the old records the copy needs, decoded from either format
+struct OldStorage {
+    size_t GraphCounter;
+    size_t NextGraphId;
+    size_t NextNodeId;
+    size_t NextNodeLinkId;
+    struct AddrInfo Graphs;
+};
+
+struct OldGraph {
+    size_t Id;
+    size_t AttributeCounter;
+    char *Name;
+    struct ExternalAttributeDescription *Descriptions;
+    struct AddrInfo Nodes;
+    struct AddrInfo LastNode;
+    struct AddrInfo Links;
+    struct AddrInfo LastLink;
+    struct AddrInfo AttributeIndexes;
+    struct AddrInfo Next;
+};
+
+struct OldNode {
+    size_t Id;
+    bool Deleted;
+    struct AddrInfo Attributes;
+    struct AddrInfo Next;
+};
+
+struct OldNodeLink {
+    size_t Id;
+    bool Deleted;
+    struct ExternalNodeLink Link;
+    struct AddrInfo Next;
+};
+
+// Record decoding of one format version. The graph name and descriptions are
+// allocated by readGraph, string attribute values by readAttributes.
+struct FormatDecoder {
+    void (*readStorage)(const struct FileAllocator *Old, struct AddrInfo Addr,
+                        struct OldStorage *Storage);
+    void (*readGraph)(const struct FileAllocator *Old, struct AddrInfo Addr,
+                      struct OldGraph *Graph);
+    void (*readNode)(const struct FileAllocator *Old, struct AddrInfo Addr, struct OldNode *Node);
+    void (*readAttributes)(const struct FileAllocator *Old, struct AddrInfo Addr,
+                           size_t AttributeCounter, struct ExternalAttribute *Attributes);
+    void (*readNodeLink)(const struct FileAllocator *Old, struct AddrInfo Addr,
+                         struct OldNodeLink *Link);
+};
+
+static struct ExternalAttributeDescription *
+allocateDescriptions(const size_t AttributeCounter) {
+    struct ExternalAttributeDescription *Descriptions =
+            malloc(sizeof(struct ExternalAttributeDescription) * AttributeCounter);
+    for (size_t i = 0; i < AttributeCounter; ++i) {
+        Descriptions[i].Next = i + 1 < AttributeCounter ? Descriptions + i + 1 : NULL;
+    }
+    return Descriptions;
+}
+
+static void readV1Storage(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                          struct OldStorage *const Storage) {
+    struct V1GraphStorage Header;
+    fetchData(Old, Addr, sizeof(Header), &Header);
+    *Storage = (struct OldStorage){.GraphCounter = Header.GraphCounter,
+                                   .NextGraphId = Header.NextGraphId,
+                                   .NextNodeId = Header.NextNodeId,
+                                   .NextNodeLinkId = Header.NextNodeLinkId,
+                                   .Graphs = Header.Graphs};
+}
+
+static void readV1Graph(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                        struct OldGraph *const Graph) {
+    struct V1Graph Header;
+    fetchData(Old, Addr, sizeof(Header), &Header);
+    const struct V1AttributeDescription *Descriptions =
+            getDataPointer(Old, Header.AttributesDecription);
+    *Graph = (struct OldGraph){.Id = Header.Id,
+                               .AttributeCounter = Header.AttributeCounter,
+                               .Name = readV1String(Old, Header.Name),
+                               .Descriptions = allocateDescriptions(Header.AttributeCounter),
+                               .Nodes = Header.Nodes,
+                               .LastNode = Header.LastNode,
+                               .Links = Header.Links,
+                               .LastLink = Header.LastLink,
+                               .AttributeIndexes = Header.AttributeIndexes,
+                               .Next = Header.Next};
+    for (size_t i = 0; i < Header.AttributeCounter; ++i) {
+        Graph->Descriptions[i].Type = Descriptions[i].Type;
+        Graph->Descriptions[i].Name = readV1String(Old, Descriptions[i].Name);
+        Graph->Descriptions[i].AttributeId = Descriptions[i].AttributeId;
+    }
+}
+
+static void readV1Node(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                       struct OldNode *const Node) {
+    const struct V1Node *Record = getDataPointer(Old, Addr);
+    *Node = (struct OldNode){.Id = Record->Id,
+                             .Deleted = Record->Deleted,
+                             .Attributes = Record->Attributes,
+                             .Next = Record->Next};
+}
+
+static void readV1Attributes(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                             const size_t AttributeCounter,
+                             struct ExternalAttribute *const External) {
+    const struct V1Attribute *Attributes = getDataPointer(Old, Addr);
+    for (size_t i = 0; i < AttributeCounter; ++i) {
+        External[i].Id = Attributes[i].Id;
+        External[i].Type = Attributes[i].Type;
+        if (Attributes[i].Type == INT) {
+            External[i].Value.IntValue = Attributes[i].Value.IntValue;
+        } else if (Attributes[i].Type == FLOAT) {
+            External[i].Value.FloatValue = Attributes[i].Value.FloatValue;
+        } else if (Attributes[i].Type == BOOL) {
+            External[i].Value.BoolValue = Attributes[i].Value.BoolValue;
+        } else {
+            External[i].Value.StringAddr = readV1String(Old, Attributes[i].Value.StringValue);
+        }
+    }
+}
+
+static void readV1NodeLink(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                           struct OldNodeLink *const Link) {
+    const struct V1NodeLink *Record = getDataPointer(Old, Addr);
+    *Link = (struct OldNodeLink){.Id = Record->Id,
+                                 .Deleted = Record->Deleted,
+                                 .Link = {.LeftNodeId = Record->LeftNodeId,
+                                          .RightNodeId = Record->RightNodeId,
+                                          .Type = Record->Type,
+                                          .Weight = Record->Weight},
+                                 .Next = Record->Next};
+}
+
+static void readV2Storage(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                          struct OldStorage *const Storage) {
+    struct GraphStorage Header;
+    fetchData(Old, Addr, sizeof(Header), &Header);
+    *Storage = (struct OldStorage){.GraphCounter = Header.GraphCounter,
+                                   .NextGraphId = Header.NextGraphId,
+                                   .NextNodeId = Header.NextNodeId,
+                                   .NextNodeLinkId = Header.NextNodeLinkId,
+                                   .Graphs = Header.Graphs};
+}
+
+static void readV2Graph(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                        struct OldGraph *const Graph) {
+    struct V2Graph Header;
+    fetchData(Old, Addr, sizeof(Header), &Header);
+    const struct AttributeDescription *Descriptions =
+            getDataPointer(Old, Header.AttributesDecription);
+    *Graph = (struct OldGraph){.Id = Header.Id,
+                               .AttributeCounter = Header.AttributeCounter,
+                               .Name = readV2String(Old, Header.Name),
+                               .Descriptions = allocateDescriptions(Header.AttributeCounter),
+                               .Nodes = Header.Nodes,
+                               .LastNode = Header.LastNode,
+                               .Links = Header.Links,
+                               .LastLink = Header.LastLink,
+                               .AttributeIndexes = Header.AttributeIndexes,
+                               .Next = Header.Next};
+    for (size_t i = 0; i < Header.AttributeCounter; ++i) {
+        Graph->Descriptions[i].Type = Descriptions[i].Type;
+        Graph->Descriptions[i].Name = readV2String(Old, Descriptions[i].Name);
+        Graph->Descriptions[i].AttributeId = Descriptions[i].AttributeId;
+    }
+}
+
+static void readV2Node(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                       struct OldNode *const Node) {
+    const struct Node *Record = getDataPointer(Old, Addr);
+    *Node = (struct OldNode){.Id = Record->Id,
+                             .Deleted = Record->Deleted,
+                             .Attributes = unpackAddr(Record->Attributes),
+                             .Next = unpackAddr(Record->Next)};
+}
+
+static void readV2Attributes(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                             const size_t AttributeCounter,
+                             struct ExternalAttribute *const External) {
+    const struct Attribute *Attributes = getDataPointer(Old, Addr);
+    for (size_t i = 0; i < AttributeCounter; ++i) {
+        External[i].Id = Attributes[i].Id;
+        External[i].Type = Attributes[i].Type;
+        if (Attributes[i].Type == INT) {
+            External[i].Value.IntValue = Attributes[i].Value.IntValue;
+        } else if (Attributes[i].Type == FLOAT) {
+            External[i].Value.FloatValue = Attributes[i].Value.FloatValue;
+        } else if (Attributes[i].Type == BOOL) {
+            External[i].Value.BoolValue = Attributes[i].Value.BoolValue;
+        } else {
+            External[i].Value.StringAddr = readV2String(Old, Attributes[i].Value.StringValue);
+        }
+    }
+}
+
+static void readV2NodeLink(const struct FileAllocator *const Old, const struct AddrInfo Addr,
+                           struct OldNodeLink *const Link) {
+    const struct NodeLink *Record = getDataPointer(Old, Addr);
+    *Link = (struct OldNodeLink){.Id = Record->Id,
+                                 .Deleted = Record->Deleted,
+                                 .Link = {.LeftNodeId = Record->LeftNodeId,
+                                          .RightNodeId = Record->RightNodeId,
+                                          .Type = Record->Type,
+                                          .Weight = Record->Weight},
+                                 .Next = unpackAddr(Record->Next)};
+}
+
+static const struct FormatDecoder Decoders[] = {
+        [1] = {readV1Storage, readV1Graph, readV1Node, readV1Attributes, readV1NodeLink},
+        [2] = {readV2Storage, readV2Graph, readV2Node, readV2Attributes, readV2NodeLink}};
+
+static size_t copyGraph(struct StorageController *const Controller,
+                        const struct OldGraph *const Graph) {
+    Controller->Storage.NextGraphId = Graph->Id;
+    const struct CreateGraphRequest Request = {
+            .Name = Graph->Name,
+            .AttributesDescription = Graph->AttributeCounter != 0 ? Graph->Descriptions : NULL};
+    return createGraph(Controller, &Request);
+}
+
+static void freeOldGraph(struct OldGraph *const Graph) {
+    for (size_t i = 0; i < Graph->AttributeCounter; ++i) {
+        free(Graph->Descriptions[i].Name);
+    }
+    free(Graph->Descriptions);
+    free(Graph->Name);
+}
+
+struct NodesBatch {
+    size_t FirstId;
+    size_t NodesNumber;
+    struct ExternalAttribute *Attributes;
+    size_t AttributeCounter;
+};
+
+static void writeNodes(struct StorageController *const Controller, const size_t GraphId,
+                       struct NodesBatch *const Batch) {
+    if (Batch->NodesNumber == 0) {
+        return;
+    }
+    Controller->Storage.NextNodeId = Batch->FirstId;
+    const struct CreateNodesBulkRequest Request = {.GraphIdType = GRAPH_ID,
+                                                   .GraphId.GraphId = GraphId,
+                                                   .Attributes = Batch->Attributes,
+                                                   .NodesNumber = Batch->NodesNumber};
+    createNodesBulk(Controller, &Request);
+    const size_t AttributesNumber = Batch->NodesNumber * Batch->AttributeCounter;
+    for (size_t i = 0; i < AttributesNumber; ++i) {
+        if (Batch->Attributes[i].Type == STRING) {
+            free(Batch->Attributes[i].Value.StringAddr);
+        }
+    }
+    Batch->NodesNumber = 0;
+}
+
+// Nodes are written in chain order, runs of consecutive ids go in one bulk
+// request.
+static size_t copyNodes(struct StorageController *const Controller,
+                        const struct FileAllocator *const Old,
+                        const struct FormatDecoder *const Decoder,
+                        const struct OldGraph *const Graph, const size_t GraphId) {
+    struct NodesBatch Batch = {.AttributeCounter = Graph->AttributeCounter};
+    Batch.Attributes = malloc(sizeof(struct ExternalAttribute) * UPGRADE_BATCH_SIZE *
+                              Graph->AttributeCounter);
+    size_t Copied = 0;
+    struct AddrInfo NodeAddr = Graph->Nodes;
+    while (NodeAddr.HasValue) {
+        struct OldNode Node;
+        Decoder->readNode(Old, NodeAddr, &Node);
+        if (!Node.Deleted) {
+            if (Batch.NodesNumber == UPGRADE_BATCH_SIZE ||
+                (Batch.NodesNumber != 0 && Batch.FirstId + Batch.NodesNumber != Node.Id)) {
+                writeNodes(Controller, GraphId, &Batch);
+            }
+            if (Batch.NodesNumber == 0) {
+                Batch.FirstId = Node.Id;
+            }
+            Decoder->readAttributes(Old, Node.Attributes, Graph->AttributeCounter,
+                                    Batch.Attributes +
+                                            Batch.NodesNumber * Graph->AttributeCounter);
+            Batch.NodesNumber++;
+            Copied++;
+        }
+        if (isOptionalFullAddrsEq(NodeAddr, Graph->LastNode)) {
+            break;
+        }
+        NodeAddr = Node.Next;
+    }
+    writeNodes(Controller, GraphId, &Batch);
+    free(Batch.Attributes);
+    return Copied;
+}
+
+static void writeLinks(struct StorageController *const Controller, const size_t GraphId,
+                       const size_t FirstId, struct ExternalNodeLink *const Links,
+                       size_t *const LinksNumber) {
+    if (*LinksNumber == 0) {
+        return;
+    }
+    Controller->Storage.NextNodeLinkId = FirstId;
+    const struct CreateNodeLinksBulkRequest Request = {.GraphIdType = GRAPH_ID,
+                                                       .GraphId.GraphId = GraphId,
+                                                       .Links = Links,
+                                                       .LinksNumber = *LinksNumber};
+    createNodeLinksBulk(Controller, &Request);
+    *LinksNumber = 0;
+}
+
+static size_t copyLinks(struct StorageController *const Controller,
+                        const struct FileAllocator *const Old,
+                        const struct FormatDecoder *const Decoder,
+                        const struct OldGraph *const Graph, const size_t GraphId) {
+    struct ExternalNodeLink *Links = malloc(sizeof(struct ExternalNodeLink) * UPGRADE_BATCH_SIZE);
+    size_t LinksNumber = 0;
+    size_t FirstId = 0;
+    size_t Copied = 0;
+    struct AddrInfo LinkAddr = Graph->Links;
+    while (LinkAddr.HasValue) {
+        struct OldNodeLink Link;
+        Decoder->readNodeLink(Old, LinkAddr, &Link);
+        if (!Link.Deleted) {
+            if (LinksNumber == UPGRADE_BATCH_SIZE ||
+                (LinksNumber != 0 && FirstId + LinksNumber != Link.Id)) {
+                writeLinks(Controller, GraphId, FirstId, Links, &LinksNumber);
+            }
+            if (LinksNumber == 0) {
+                FirstId = Link.Id;
+            }
+            Links[LinksNumber++] = Link.Link;
+            Copied++;
+        }
+        if (isOptionalFullAddrsEq(LinkAddr, Graph->LastLink)) {
+            break;
+        }
+        LinkAddr = Link.Next;
+    }
+    writeLinks(Controller, GraphId, FirstId, Links, &LinksNumber);
+    free(Links);
+    return Copied;
+}
+
+// Index records did not change between the formats
+static void copyIndexes(struct StorageController *const Controller,
+                        const struct FileAllocator *const Old, struct AddrInfo IndexAddr,
+                        const size_t GraphId) {
+    while (IndexAddr.HasValue) {
+        struct V1AttributeIndex Index;
+        fetchData(Old, IndexAddr, sizeof(Index), &Index);
+        const struct CreateIndexRequest Request = {.GraphIdType = GRAPH_ID,
+                                                   .GraphId.GraphId = GraphId,
+                                                   .AttributeId = Index.AttributeId};
+        createIndex(Controller, &Request);
+        IndexAddr = Index.Next;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s OLD_DATA_FILE NEW_DATA_FILE\n", argv[0]);
+        return 1;
+    }
+    if (access(argv[2], F_OK) == 0) {
+        fprintf(stderr, "%s already exists\n", argv[2]);
+        return 1;
+    }
+    // The old file is only read, it keeps its clean shutdown flag
+    struct FileAllocator *Old = openFileAllocatorReadOnly(argv[1]);
+    if (Old == NULL) {
+        fprintf(stderr, "%s: can not open the data file\n", argv[1]);
+        return 1;
+    }
+    const struct AddrInfo StorageAddr = getFirstBlockData(Old);
+    if (!StorageAddr.HasValue) {
+        fprintf(stderr, "%s: the data file is empty\n", argv[1]);
+        shutdownFileAllocator(Old);
+        return 1;
+    }
+    // Version 1 storage headers have no magic
+    struct GraphStorage Header;
+    fetchData(Old, StorageAddr, sizeof(Header), &Header);
+    const uint32_t Version = Header.Magic == STORAGE_MAGIC ? Header.FormatVersion : 1;
+    if (Version == STORAGE_FORMAT_VERSION) {
+        fprintf(stderr, "%s: the data file is already converted\n", argv[1]);
+        shutdownFileAllocator(Old);
+        return 1;
+    }
+    if (Version != 1 && Version != 2) {
+        fprintf(stderr, "%s: unknown storage format version %u\n", argv[1], Version);
+        shutdownFileAllocator(Old);
+        return 1;
+    }
+    const struct FormatDecoder *const Decoder = Decoders + Version;
+    struct StorageController *Controller = beginWork(argv[2]);
+    if (Controller == NULL) {
+        shutdownFileAllocator(Old);
+        return 1;
+    }
+    struct OldStorage Storage;
+    Decoder->readStorage(Old, StorageAddr, &Storage);
+    struct AddrInfo GraphAddr = Storage.Graphs;
+    for (size_t i = 0; i < Storage.GraphCounter && GraphAddr.HasValue; ++i) {
+        struct OldGraph Graph;
+        Decoder->readGraph(Old, GraphAddr, &Graph);
+        const size_t GraphId = copyGraph(Controller, &Graph);
+        const size_t Nodes = copyNodes(Controller, Old, Decoder, &Graph, GraphId);
+        const size_t Links = copyLinks(Controller, Old, Decoder, &Graph, GraphId);
+        copyIndexes(Controller, Old, Graph.AttributeIndexes, GraphId);
+        printf("graph %zu: %zu nodes, %zu links\n", GraphId, Nodes, Links);
+        GraphAddr = Graph.Next;
+        freeOldGraph(&Graph);
+    }
+    // Ids of deleted records are not given out again
+    Controller->Storage.NextGraphId = Storage.NextGraphId;
+    Controller->Storage.NextNodeId = Storage.NextNodeId;
+    Controller->Storage.NextNodeLinkId = Storage.NextNodeLinkId;
+    reserveNodeIds(Controller, 0);
+    endWork(Controller);
+    shutdownFileAllocator(Old);
+    return 0;
+}